@@ -0,0 +1,347 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cmath>
+#include <csd/batch.hpp>
+#include <csd/csd.hpp>
+#include <csd/fir.hpp>
+#include <csd/generator.hpp>
+#include <csd/msd.hpp>
+#include <csd/packed.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace csd;
+
+/** Inputs per benchmark iteration, so that one value never stays hot in the predictor */
+static constexpr std::size_t batch = 1024U;
+
+/**
+ * Distributions of the values fed to the encoders.
+ */
+enum Distribution : int {
+    Uniform = 0,      ///< uniform in [-1000, 1000)
+    LogUniform = 1,   ///< random sign, magnitude 2^u with u uniform in [-30, 30)
+    Coefficient = 2,  ///< uniform in [-1, 1), like normalized filter taps
+};
+
+/**
+ * Generates `batch` reproducible pseudo-random doubles with the given distribution.
+ */
+static std::vector<double> random_values(int distribution) {
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+    std::vector<double> values(batch);
+    for (auto &value : values) {
+        switch (distribution) {
+            case Uniform:
+                value = 1000.0 * uniform(gen);
+                break;
+            case LogUniform:
+                value = std::copysign(std::exp2(30.0 * uniform(gen)), uniform(gen));
+                break;
+            default:
+                value = uniform(gen);
+        }
+    }
+    return values;
+}
+
+/**
+ * Generates `batch` reproducible pseudo-random CSD strings with `length`
+ * digits, a quarter of them fractional, of which `density` percent are
+ * non-zero.
+ */
+static std::vector<std::string> random_csds(std::size_t length, int density) {
+    std::mt19937 gen(42);
+    std::vector<std::string> csds(batch);
+    auto const frac = length / 4U;
+    for (auto &csd : csds) {
+        csd.reserve(length + 1U);
+        for (std::size_t i = 0; i != length; ++i) {
+            if (i == length - frac && frac != 0U) {
+                csd += '.';
+            }
+            csd += int(gen() % 100U) < density ? "+-"[gen() % 2U] : '0';
+        }
+    }
+    return csds;
+}
+
+/**
+ * Records the items, and the characters produced or consumed, of a benchmark.
+ */
+static void report(benchmark::State &state, std::size_t chars_per_batch) {
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(batch));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(chars_per_batch));
+}
+
+// ---- Encoders ----
+
+/**
+ * `to_csd`; arguments: places, distribution.
+ */
+static void encode_to_csd(benchmark::State &state) {
+    auto const places = int(state.range(0));
+    auto const values = random_values(int(state.range(1)));
+    std::size_t chars = 0U;
+    for (auto _ : state) {
+        chars = 0U;
+        for (auto value : values) {
+            auto csd = to_csd(value, places);
+            chars += csd.size();
+            benchmark::DoNotOptimize(csd);
+        }
+    }
+    report(state, chars);
+}
+BENCHMARK(encode_to_csd)->ArgsProduct({{4, 16, 40}, {Uniform, LogUniform, Coefficient}});
+
+/**
+ * `to_csd_into` into a reused string; arguments: places, distribution.
+ */
+static void encode_to_csd_into(benchmark::State &state) {
+    auto const places = int(state.range(0));
+    auto const values = random_values(int(state.range(1)));
+    std::string csd;
+    std::size_t chars = 0U;
+    for (auto _ : state) {
+        chars = 0U;
+        for (auto value : values) {
+            chars += to_csd_into(value, places, csd);
+            benchmark::DoNotOptimize(csd.data());
+        }
+    }
+    report(state, chars);
+}
+BENCHMARK(encode_to_csd_into)->ArgsProduct({{4, 16, 40}, {Uniform, LogUniform, Coefficient}});
+
+/**
+ * Reference digit loop of `to_csd`, to watch the fast path against; arguments: places,
+ * distribution.
+ */
+static void encode_to_csd_reference(benchmark::State &state) {
+    auto const places = int(state.range(0));
+    auto const values = random_values(int(state.range(1)));
+    std::size_t chars = 0U;
+    for (auto _ : state) {
+        chars = 0U;
+        for (auto value : values) {
+            auto csd = to_csd_reference(value, places);
+            chars += csd.size();
+            benchmark::DoNotOptimize(csd);
+        }
+    }
+    report(state, chars);
+}
+BENCHMARK(encode_to_csd_reference)->ArgsProduct({{4, 40}, {Uniform}});
+
+/**
+ * `to_csdfixed`; arguments: nnz, distribution.
+ */
+static void encode_to_csdfixed(benchmark::State &state) {
+    auto const nnz = unsigned(state.range(0));
+    auto const values = random_values(int(state.range(1)));
+    std::size_t chars = 0U;
+    for (auto _ : state) {
+        chars = 0U;
+        for (auto value : values) {
+            auto csd = to_csdfixed(value, nnz);
+            chars += csd.size();
+            benchmark::DoNotOptimize(csd);
+        }
+    }
+    report(state, chars);
+}
+BENCHMARK(encode_to_csdfixed)->ArgsProduct({{2, 4, 8, 16}, {Uniform, LogUniform, Coefficient}});
+
+/**
+ * `CsdGenerator` stopped after the leading non-zero digits, as in a cost
+ * check; arguments: the number of non-zero digits, distribution.
+ */
+static void encode_generator_leading(benchmark::State &state) {
+    auto const wanted = unsigned(state.range(0));
+    auto const values = random_values(int(state.range(1)));
+    for (auto _ : state) {
+        for (auto value : values) {
+            CsdGenerator gen(value);
+            CsdDigit digit{0, 0};
+            while (gen.nonzeros() != wanted && gen.next_nonzero(-40, digit)) {
+            }
+            benchmark::DoNotOptimize(digit);
+        }
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(batch));
+}
+BENCHMARK(encode_generator_leading)->ArgsProduct({{1, 3, 8}, {Uniform, Coefficient}});
+
+/**
+ * Every MSD form of integer coefficients with `MsdEnumerator`; argument:
+ * the magnitude bound of the integers, as a power of two.
+ */
+static void encode_msd_all(benchmark::State &state) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int64_t> dist(-(int64_t{1} << state.range(0)),
+                                                int64_t{1} << state.range(0));
+    std::vector<int64_t> values(batch);
+    for (auto &value : values) {
+        value = dist(gen);
+    }
+    std::size_t forms = 0U;
+    for (auto _ : state) {
+        forms = 0U;
+        for (auto value : values) {
+            MsdEnumerator msds(value);
+            PackedCsd msd;
+            while (msds.next(msd)) {
+                ++forms;
+                benchmark::DoNotOptimize(msd);
+            }
+        }
+    }
+    state.counters["forms"] = double(forms) / double(batch);
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(batch));
+}
+BENCHMARK(encode_msd_all)->Arg(12)->Arg(16)->Arg(24);
+
+/**
+ * `CsdFir::filter` over a stream of 16-bit samples, with `to_csdfixed`
+ * coefficients of 4 non-zero digits; argument: the number of taps.
+ */
+static void filter_csd_fir(benchmark::State &state) {
+    auto const taps = random_values(Coefficient);
+    std::vector<std::string> csds;
+    for (auto i = 0; i != state.range(0); ++i) {
+        csds.push_back(to_csdfixed(taps[std::size_t(i)], 4U));
+    }
+    CsdFir fir(csds);
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<std::int32_t> dist(-32768, 32767);
+    std::vector<std::int32_t> in(1U << 16U);
+    for (auto &sample : in) {
+        sample = dist(gen);
+    }
+    std::vector<std::int32_t> out(in.size());
+    for (auto _ : state) {
+        fir.filter(in.data(), out.data(), in.size());
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()) * int64_t(in.size()));
+}
+BENCHMARK(filter_csd_fir)->Arg(16)->Arg(64)->Arg(256);
+
+/**
+ * `to_csd_i`; argument: the magnitude bound of the integers, as a power of two.
+ */
+static void encode_to_csd_i(benchmark::State &state) {
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> dist(-(1 << state.range(0)), 1 << state.range(0));
+    std::vector<int> values(batch);
+    for (auto &value : values) {
+        value = dist(gen);
+    }
+    std::size_t chars = 0U;
+    for (auto _ : state) {
+        chars = 0U;
+        for (auto value : values) {
+            auto csd = to_csd_i(value);
+            chars += csd.size();
+            benchmark::DoNotOptimize(csd);
+        }
+    }
+    report(state, chars);
+}
+BENCHMARK(encode_to_csd_i)->Arg(8)->Arg(16)->Arg(28);
+
+// ---- Decoders ----
+
+/**
+ * Runs a `const char *` decoder over random strings; arguments: digits, density in percent.
+ */
+template <typename Decode> static void run_decoder(benchmark::State &state, Decode decode) {
+    auto const csds = random_csds(std::size_t(state.range(0)), int(state.range(1)));
+    std::size_t chars = 0U;
+    for (auto const &csd : csds) {
+        chars += csd.size();
+    }
+    for (auto _ : state) {
+        for (auto const &csd : csds) {
+            auto result = decode(csd.c_str());
+            benchmark::DoNotOptimize(result);
+        }
+    }
+    report(state, chars);
+}
+
+/** Strings within the `int` range of the integral decoders, at three digit densities */
+#define CSD_DECODER_ARGS ArgsProduct({{8, 24, 40}, {10, 33, 66}})
+
+static void decode_to_decimal(benchmark::State &state) {
+    run_decoder(state, [](const char *csd) { return to_decimal(csd); });
+}
+BENCHMARK(decode_to_decimal)->CSD_DECODER_ARGS;
+
+static void decode_to_decimal_using_switch(benchmark::State &state) {
+    run_decoder(state, [](const char *csd) { return to_decimal_using_switch(csd); });
+}
+BENCHMARK(decode_to_decimal_using_switch)->CSD_DECODER_ARGS;
+
+static void decode_to_decimal_using_lut(benchmark::State &state) {
+    run_decoder(state, [](const char *csd) { return to_decimal_using_lut(csd); });
+}
+BENCHMARK(decode_to_decimal_using_lut)->CSD_DECODER_ARGS;
+
+/**
+ * Non-throwing `to_decimal` over character ranges; arguments: digits, density in percent.
+ */
+static void decode_to_decimal_range(benchmark::State &state) {
+    auto const csds = random_csds(std::size_t(state.range(0)), int(state.range(1)));
+    std::size_t chars = 0U;
+    for (auto const &csd : csds) {
+        chars += csd.size();
+    }
+    for (auto _ : state) {
+        for (auto const &csd : csds) {
+            auto value = 0.0;
+            auto result = to_decimal(csd.data(), csd.data() + csd.size(), value);
+            benchmark::DoNotOptimize(result);
+            benchmark::DoNotOptimize(value);
+        }
+    }
+    report(state, chars);
+}
+BENCHMARK(decode_to_decimal_range)->CSD_DECODER_ARGS;
+
+static void decode_to_decimal_i(benchmark::State &state) {
+    run_decoder(state, [](const char *csd) { return to_decimal_i(csd); });
+}
+BENCHMARK(decode_to_decimal_i)->CSD_DECODER_ARGS;
+
+static void decode_to_packed(benchmark::State &state) {
+    run_decoder(state, [](const char *csd) { return to_decimal(to_packed(csd)); });
+}
+BENCHMARK(decode_to_packed)->CSD_DECODER_ARGS;
+
+/**
+ * `to_decimal_batch` over the whole batch at once; arguments: digits, density in percent.
+ */
+static void decode_to_decimal_batch(benchmark::State &state) {
+    auto const csds = random_csds(std::size_t(state.range(0)), int(state.range(1)));
+    std::vector<const char *> pointers;
+    std::size_t chars = 0U;
+    for (auto const &csd : csds) {
+        pointers.push_back(csd.c_str());
+        chars += csd.size();
+    }
+    std::vector<double> out(csds.size());
+    for (auto _ : state) {
+        to_decimal_batch(pointers.data(), pointers.size(), out.data());
+        benchmark::DoNotOptimize(out.data());
+        benchmark::ClobberMemory();
+    }
+    report(state, chars);
+}
+BENCHMARK(decode_to_decimal_batch)->CSD_DECODER_ARGS;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <csd/lcsre.hpp>
+#include <random>
+#include <string>
+
+using namespace csd;
+
+/**
+ * Generates a reproducible pseudo-random CSD digit string of length `n`.
+ */
+static std::string random_csd(std::size_t n) {
+    std::mt19937 gen(42);
+    std::string csd;
+    csd.reserve(n);
+    for (std::size_t i = 0; i != n; ++i) {
+        csd += "00+-"[gen() % 4U];
+    }
+    return csd;
+}
+
+/**
+ * Measures `longest_repeated_substring` with the given engine on a random
+ * CSD string whose length is the benchmark argument.
+ */
+static void run_lcsre(benchmark::State &state, LcsreEngine engine) {
+    auto const csd = random_csd(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        auto result = longest_repeated_substring(csd.c_str(), csd.size(), engine);
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetComplexityN(state.range(0));
+    state.SetBytesProcessed(int64_t(state.iterations()) * state.range(0));
+}
+
+static void lcsre_table(benchmark::State &state) {
+    run_lcsre(state, LcsreEngine::DynamicProgramming);
+}
+// The full table needs 4 (n + 1)^2 bytes, i.e. 10 GB at n = 50k, so it stops at 8k
+BENCHMARK(lcsre_table)
+    ->RangeMultiplier(4)
+    ->Range(256, 8192)
+    ->Complexity(benchmark::oNSquared)
+    ->Unit(benchmark::kMillisecond);
+
+static void lcsre_rolling_row(benchmark::State &state) {
+    run_lcsre(state, LcsreEngine::RollingRow);
+}
+BENCHMARK(lcsre_rolling_row)
+    ->RangeMultiplier(4)
+    ->Range(256, 65536)
+    ->Complexity(benchmark::oNSquared)
+    ->Unit(benchmark::kMillisecond);
+
+static void lcsre_suffix_array(benchmark::State &state) {
+    run_lcsre(state, LcsreEngine::SuffixArray);
+}
+BENCHMARK(lcsre_suffix_array)
+    ->RangeMultiplier(4)
+    ->Range(256, 65536)
+    ->Complexity(benchmark::oNLogN)
+    ->Unit(benchmark::kMillisecond);
+
+static void lcsre_auto(benchmark::State &state) { run_lcsre(state, LcsreEngine::Auto); }
+BENCHMARK(lcsre_auto)->RangeMultiplier(4)->Range(256, 65536)->Complexity()->Unit(
+    benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
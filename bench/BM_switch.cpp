@@ -17,14 +17,15 @@ using namespace csd;
  * access the benchmark results.
  */
 static void using_if_else(benchmark::State &state) {
+    std::string test("+00-00+00+00-00+00+0-0+0+.+00+00-0++");
     // Code inside this loop is measured repeatedly
     for (auto _ : state) {
-        std::string test("+00-00+00+00-00+00+0-0+0+.+00+00-0++");
-
         auto result = to_decimal(test.c_str());
         // Make sure the variable is not optimized away by compiler
         benchmark::DoNotOptimize(result);
     }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(test.size()));
 }
 // Register the function as a benchmark
 BENCHMARK(using_if_else);
@@ -39,15 +40,39 @@ BENCHMARK(using_if_else);
  * access the benchmark results.
  */
 static void using_switch(benchmark::State &state) {
+    std::string test("+00-00+00+00-00+00+0-0+0+.+00+00-0++");
     // Code inside this loop is measured repeatedly
     for (auto _ : state) {
-        std::string test("+00-00+00+00-00+00+0-0+0+.+00+00-0++");
-
         auto result = to_decimal_using_switch(test.c_str());
         // Make sure the variable is not optimized away by compiler
         benchmark::DoNotOptimize(result);
     }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(test.size()));
 }
 BENCHMARK(using_switch);
 
+/**
+ * The function `using_lut` repeatedly measures the time it takes to convert a given string to a
+ * decimal number using the `to_decimal_using_lut` function, which decodes four-digit chunks with a
+ * lookup table.
+ *
+ * @param[in] state The `state` parameter in the `using_lut` function is of type
+ * `benchmark::State`. It is used by the Google Benchmark library to control the benchmarking
+ * process. It provides various methods and properties to control the benchmark execution and to
+ * access the benchmark results.
+ */
+static void using_lut(benchmark::State &state) {
+    std::string test("+00-00+00+00-00+00+0-0+0+.+00+00-0++");
+    // Code inside this loop is measured repeatedly
+    for (auto _ : state) {
+        auto result = to_decimal_using_lut(test.c_str());
+        // Make sure the variable is not optimized away by compiler
+        benchmark::DoNotOptimize(result);
+    }
+    state.SetItemsProcessed(int64_t(state.iterations()));
+    state.SetBytesProcessed(int64_t(state.iterations()) * int64_t(test.size()));
+}
+BENCHMARK(using_lut);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,63 @@
+#include <cmath>    // for fabs, ldexp
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t, int32_t
+#include <cstdio>   // for fprintf, stderr
+#include <cstdlib>  // for abort
+#include <cstring>  // for memcpy
+#include <string>   // for basic_string
+
+#include "differential.hpp"  // for check_to_csd, check_to_decimal, ...
+
+/**
+ * The first byte picks the path, and the next ones make its input: a
+ * double and a count for the encoders, an int for `to_csd_i`, and the
+ * characters for the decoders and the repeated substrings.
+ */
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t *data, std::size_t size) {
+    if (size == 0U) {
+        return 0;
+    }
+    auto const path = data[0] % 5U;
+    ++data;
+    --size;
+    std::string error;
+    if (path <= 1U) {
+        double value = 0.0;
+        std::uint8_t count[2] = {0U, 0U};
+        if (size < sizeof value + sizeof count) {
+            return 0;
+        }
+        std::memcpy(&value, data, sizeof value);
+        std::memcpy(count, data + sizeof value, sizeof count);
+        if (path == 0U) {
+            if (!(std::fabs(value) < std::ldexp(1.0, 1023))) {
+                return 0;
+            }
+            auto const places = (count[0] | (count[1] << 8U)) % 1300 - 100;
+            error = differential::check_to_csd(value, places);
+        } else {
+            if (!(std::fabs(value) < std::ldexp(1.0, 1022))) {
+                return 0;
+            }
+            error = differential::check_to_csdfixed(value, count[0]);
+        }
+    } else if (path == 2U) {
+        std::int32_t value = 0;
+        if (size < sizeof value) {
+            return 0;
+        }
+        std::memcpy(&value, data, sizeof value);
+        error = differential::check_to_csd_i(value);
+    } else if (path == 3U) {
+        error = differential::check_to_decimal(differential::csd_from_bytes(data, size));
+    } else {
+        // The O(n^2) table of the reference is the limit on the length
+        auto const csd = differential::csd_from_bytes(data, size < 512U ? size : 512U);
+        error = differential::check_lcsre(csd);
+    }
+    if (!error.empty()) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        std::abort();
+    }
+    return 0;
+}
@@ -0,0 +1,90 @@
+/// @file batch.hpp
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <stdexcept>  // for length_error
+#include <string>     // for basic_string
+
+#include "csd.hpp"  // for CSD_HAS_SPAN, CSD_THROW
+
+namespace csd {
+
+    /**
+     * @brief Convert an array of CSD strings to decimals
+     *
+     * Each string of up to 64 characters is classified where it lies, 16 or
+     * 32 characters at a time up to its '\0', with SSE2/AVX2/NEON compares
+     * (the instruction set is picked once per call). Its '+' and '-' bit
+     * masks are then read as integers, of which the fractional one is scaled
+     * by an exact power of two. The compares may read past the end of a
+     * string, up to 64 bytes from its start but never into another page.
+     * Longer strings, or strings with more than 53 fractional digits,
+     * take the scalar `to_decimal` path. The results, and the
+     * `std::invalid_argument` thrown on an invalid character with its
+     * message, are exactly the same as calling `to_decimal` on every string.
+     *
+     * If an exception is thrown, the outputs before the offending string have
+     * already been written.
+     *
+     * @param[in] csd - Array of `n` null-terminated CSD strings
+     * @param[in] n - Number of strings
+     * @param[out] out - Array receiving the `n` decimal values
+     */
+    extern auto to_decimal_batch(const char *const *csd, std::size_t n, double *out) -> void;
+
+    /**
+     * @brief Convert an array of CSD strings to decimals
+     *
+     * @param[in] csd - Array of `n` CSD strings
+     * @param[in] n - Number of strings
+     * @param[out] out - Array receiving the `n` decimal values
+     * @see to_decimal_batch(const char *const *, std::size_t, double *)
+     */
+    extern auto to_decimal_batch(const std::string *csd, std::size_t n, double *out) -> void;
+
+    /**
+     * @brief Convert an array of CSD character ranges to decimals
+     *
+     * The ranges do not have to be null-terminated, so slices of a larger
+     * buffer can be decoded in place. A '\0' inside a range ends it, as it
+     * would for `to_decimal`.
+     *
+     * @param[in] csd - Array of `n` pointers to the first character of each range
+     * @param[in] sizes - Array of the `n` range lengths
+     * @param[in] n - Number of ranges
+     * @param[out] out - Array receiving the `n` decimal values
+     * @see to_decimal_batch(const char *const *, std::size_t, double *)
+     */
+    extern auto to_decimal_batch(const char *const *csd, const std::size_t *sizes, std::size_t n,
+                                 double *out) -> void;
+
+#ifdef CSD_HAS_SPAN
+    /**
+     * @brief Convert a span of CSD strings to decimals
+     *
+     * @throw std::length_error if `out` is shorter than `csd`
+     * @see to_decimal_batch(const char *const *, std::size_t, double *)
+     */
+    inline auto to_decimal_batch(std::span<const char *const> csd, std::span<double> out) -> void {
+        if (out.size() < csd.size()) {
+            CSD_THROW(std::length_error("Output span shorter than the input"));
+        }
+        to_decimal_batch(csd.data(), csd.size(), out.data());
+    }
+
+    /**
+     * @brief Convert a span of CSD strings to decimals
+     *
+     * @throw std::length_error if `out` is shorter than `csd`
+     * @see to_decimal_batch(const char *const *, std::size_t, double *)
+     */
+    inline auto to_decimal_batch(std::span<const std::string> csd, std::span<double> out)
+        -> void {
+        if (out.size() < csd.size()) {
+            CSD_THROW(std::length_error("Output span shorter than the input"));
+        }
+        to_decimal_batch(csd.data(), csd.size(), out.data());
+    }
+#endif
+
+}  // namespace csd
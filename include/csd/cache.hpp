@@ -0,0 +1,91 @@
+/// @file cache.hpp
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <memory>   // for unique_ptr
+#include <string>   // for basic_string
+
+namespace csd {
+
+    /**
+     * @brief Memoizing, thread-safe front end for `to_csd` and `to_csdfixed`
+     *
+     * Results are keyed on the bit pattern of the double together with
+     * `places` (or `nnz`), so 0.0 and -0.0 are distinct keys and a hit
+     * returns exactly what the direct conversion would.
+     *
+     * The table is split into 16 shards with a mutex each, selected by the
+     * hash of the key, so threads converting different values rarely
+     * contend. Each shard is a fixed open-addressing table of 4-way sets
+     * (a probe looks at 4 adjacent slots only); a miss on a full set
+     * replaces its entries round-robin. The slots and the heap storage of
+     * the cached strings are both counted against `max_bytes`; a result that
+     * would exceed the budget after evicting from its set is returned but
+     * not stored.
+     */
+    class CsdCache {
+      public:
+        /** Default memory budget: 1 MiB */
+        static constexpr std::size_t default_max_bytes = std::size_t{1} << 20U;
+
+        /**
+         * @brief Construct an empty cache
+         *
+         * @param[in] max_bytes - Memory budget for the slots and the cached strings
+         */
+        explicit CsdCache(std::size_t max_bytes = default_max_bytes);
+        ~CsdCache();
+
+        CsdCache(const CsdCache &) = delete;
+        auto operator=(const CsdCache &) -> CsdCache & = delete;
+
+        /**
+         * @brief Cached `to_csd(decimal_value, places)`
+         */
+        auto to_csd(double decimal_value, int places) -> std::string;
+
+        /**
+         * @brief Cached `to_csd_into(decimal_value, places, out)`
+         *
+         * A hit copies the cached characters into `out`, which allocates
+         * nothing once its capacity is large enough.
+         *
+         * @return The length of the CSD string
+         */
+        auto to_csd_into(double decimal_value, int places, std::string &out) -> std::size_t;
+
+        /**
+         * @brief Cached `to_csdfixed(decimal_value, nnz)`
+         */
+        auto to_csdfixed(double decimal_value, unsigned int nnz) -> std::string;
+
+        /**
+         * @brief Cached `to_csdfixed_into(decimal_value, nnz, out)`
+         *
+         * @return The length of the CSD string
+         */
+        auto to_csdfixed_into(double decimal_value, unsigned int nnz, std::string &out)
+            -> std::size_t;
+
+        /** Number of lookups answered from the cache */
+        auto hits() const -> std::uint64_t;
+
+        /** Number of lookups that had to convert */
+        auto misses() const -> std::uint64_t;
+
+        /** Number of cached results */
+        auto size() const -> std::size_t;
+
+        /** Maximum number of cached results */
+        auto capacity() const -> std::size_t;
+
+        /** Drop all cached results and reset the counters */
+        auto clear() -> void;
+
+      private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+}  // namespace csd
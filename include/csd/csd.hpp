@@ -1,9 +1,22 @@
 /// @file csd.hpp
 #pragma once
 
-#include <iosfwd>     // for string
-#include <stdexcept>  // for invalid_argument
-#include <string>     // for basic_string, operator==, operator<<
+#include <cstddef>       // for size_t
+#include <cstdlib>       // for abort
+#include <iosfwd>        // for string
+#include <stdexcept>     // for invalid_argument
+#include <string>        // for basic_string, operator==, operator<<
+#include <system_error>  // for errc
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#    include <string_view>  // for string_view
+#    define CSD_HAS_STRING_VIEW 1
+#endif
+
+#if __cplusplus >= 202002L || (defined(_MSVC_LANG) && _MSVC_LANG >= 202002L)
+#    include <span>  // for span
+#    define CSD_HAS_SPAN 1
+#endif
 
 #if __cpp_constexpr >= 201304
 #    define CONSTEXPR14 constexpr
@@ -11,8 +24,39 @@
 #    define CONSTEXPR14 inline
 #endif
 
+// Without exception support (e.g. -fno-exceptions) the throwing functions abort instead
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#    define CSD_HAS_EXCEPTIONS 1
+#    define CSD_THROW(exception) throw exception
+#else
+#    define CSD_THROW(exception) std::abort()
+#endif
+
+// With CSD_HEADER_ONLY the encoders are defined in the headers (see csd_impl.hpp), so that they
+// can be inlined into the caller's loops without LTO. They also move into an inline namespace,
+// so that header-only translation units and the compiled library never define the same function
+// differently when they end up in one program.
+#ifdef CSD_HEADER_ONLY
+#    define CSD_INLINE inline
+#    define CSD_BEGIN_INLINE_NAMESPACE inline namespace header_only {
+#    define CSD_END_INLINE_NAMESPACE }
+#else
+#    define CSD_INLINE extern
+#    define CSD_BEGIN_INLINE_NAMESPACE
+#    define CSD_END_INLINE_NAMESPACE
+#endif
+
 namespace csd {
 
+#if defined(__SIZEOF_INT128__)
+    /** Signed 128-bit integer, where the compiler provides one */
+    __extension__ typedef __int128 int128_t;
+    /** Unsigned 128-bit integer, where the compiler provides one */
+    __extension__ typedef unsigned __int128 uint128_t;
+#endif
+
+    CSD_BEGIN_INLINE_NAMESPACE
+
     /**
      * Converts a double precision floating point number to a string
      * representation in Canonical Signed Digit (CSD) format with a
@@ -26,7 +70,7 @@ namespace csd {
      * @param[in] places - The number of decimal places to include in the CSD representation.
      * @return String representation of the input number in CSD format.
      */
-    extern auto to_csd(double decimal_value, int places) -> std::string;
+    CSD_INLINE auto to_csd(double decimal_value, int places) -> std::string;
 
     /**
      * Converts an integer to a string representation in Canonical Signed Digit (CSD) format.
@@ -38,7 +82,18 @@ namespace csd {
      * @param[in] decimal_value - The integer to convert to CSD format.
      * @return String representation of the input integer in CSD format.
      */
-    extern auto to_csd_i(int decimal_value) -> std::string;
+    CSD_INLINE auto to_csd_i(int decimal_value) -> std::string;
+
+    /**
+     * Converts an integer to CSD format one digit at a time.
+     *
+     * This is the original digit-by-digit implementation of `to_csd_i`, kept as
+     * a reference for testing. It is not part of the public API.
+     *
+     * @param[in] decimal_value - The integer to convert to CSD format.
+     * @return String representation of the input integer in CSD format.
+     */
+    CSD_INLINE auto to_csd_i_reference(int decimal_value) -> std::string;
 
     /**
      * Converts a double precision floating point number to a CSD (Canonical Signed Digit)
@@ -50,7 +105,164 @@ namespace csd {
      * @param[in] nnz - The maximum number of non-zero digits allowed in the CSD representation.
      * @return String representation of the input number in CSD format with nnz non-zero digits.
      */
-    extern auto to_csdfixed(double decimal_value, unsigned int nnz) -> std::string;
+    CSD_INLINE auto to_csdfixed(double decimal_value, unsigned int nnz) -> std::string;
+
+    /**
+     * Converts a double to CSD format one floating-point step per digit.
+     *
+     * This is the original digit-by-digit implementation of `to_csd`, kept as
+     * a reference for testing. It is not part of the public API.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] places - The number of decimal places to include in the CSD representation.
+     * @return String representation of the input number in CSD format.
+     */
+    CSD_INLINE auto to_csd_reference(double decimal_value, int places) -> std::string;
+
+    /**
+     * Converts a double to CSD format with a fixed number of non-zero digits
+     * one floating-point step per digit.
+     *
+     * This is the original digit-by-digit implementation of `to_csdfixed`,
+     * kept as a reference for testing. It is not part of the public API.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] nnz - The maximum number of non-zero digits allowed in the CSD representation.
+     * @return String representation of the input number in CSD format with nnz non-zero digits.
+     */
+    CSD_INLINE auto to_csdfixed_reference(double decimal_value, unsigned int nnz) -> std::string;
+
+    /**
+     * Exact number of characters of `to_csd(decimal_value, places)`.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] places - The number of decimal places to include in the CSD representation.
+     * @return The length of the CSD string, not counting a terminating '\0'.
+     */
+    CSD_INLINE auto to_csd_length(double decimal_value, int places) -> std::size_t;
+
+    /**
+     * Converts a double to CSD format into a caller-provided buffer.
+     *
+     * Produces the same characters as `to_csd` without allocating. Like
+     * `snprintf`, at most `cap - 1` characters are written followed by a '\0'
+     * (nothing is written if `cap` is 0), and the full length of the result
+     * is returned, so the output is complete exactly when the return value is
+     * less than `cap`.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] places - The number of decimal places to include in the CSD representation.
+     * @param[out] out - The buffer receiving the CSD string.
+     * @param[in] cap - The size of the buffer `out`.
+     * @return The length of the complete CSD string, not counting the '\0'.
+     */
+    CSD_INLINE auto to_csd_into(double decimal_value, int places, char *out, std::size_t cap)
+        -> std::size_t;
+
+    /**
+     * Converts a double to CSD format, reusing the storage of a string.
+     *
+     * The string is resized up front, with room for the digits' '\0', so no
+     * allocation happens once its capacity exceeds the length.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] places - The number of decimal places to include in the CSD representation.
+     * @param[out] out - The string receiving the CSD representation.
+     * @return The length of the CSD string.
+     */
+    CSD_INLINE auto to_csd_into(double decimal_value, int places, std::string &out) -> std::size_t;
+
+    /**
+     * Converts a double to CSD format with a fixed number of non-zero digits
+     * into a caller-provided buffer.
+     *
+     * Produces the same characters as `to_csdfixed` without allocating, with
+     * the same `snprintf`-like contract as `to_csd_into`.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] nnz - The maximum number of non-zero digits allowed in the CSD representation.
+     * @param[out] out - The buffer receiving the CSD string.
+     * @param[in] cap - The size of the buffer `out`.
+     * @return The length of the complete CSD string, not counting the '\0'.
+     */
+    CSD_INLINE auto to_csdfixed_into(double decimal_value, unsigned int nnz, char *out,
+                                     std::size_t cap) -> std::size_t;
+
+    /**
+     * Converts a double to CSD format with a fixed number of non-zero digits,
+     * reusing the storage of a string.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] nnz - The maximum number of non-zero digits allowed in the CSD representation.
+     * @param[out] out - The string receiving the CSD representation.
+     * @return The length of the CSD string.
+     */
+    CSD_INLINE auto to_csdfixed_into(double decimal_value, unsigned int nnz, std::string &out)
+        -> std::size_t;
+
+#ifdef CSD_HAS_SPAN
+    /**
+     * @brief `to_csd_into(decimal_value, places, out.data(), out.size())`
+     */
+    inline auto to_csd_into(double decimal_value, int places, std::span<char> out)
+        -> std::size_t {
+        return to_csd_into(decimal_value, places, out.data(), out.size());
+    }
+
+    /**
+     * @brief `to_csdfixed_into(decimal_value, nnz, out.data(), out.size())`
+     */
+    inline auto to_csdfixed_into(double decimal_value, unsigned int nnz, std::span<char> out)
+        -> std::size_t {
+        return to_csdfixed_into(decimal_value, nnz, out.data(), out.size());
+    }
+#endif
+
+    /**
+     * Converts a double to CSD format into a string using the given allocator.
+     *
+     * E.g. with a `std::pmr::polymorphic_allocator<char>` the characters
+     * come from a memory resource instead of the global heap.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] places - The number of decimal places to include in the CSD representation.
+     * @param[in] alloc - The allocator of the result.
+     * @return String representation of the input number in CSD format.
+     */
+    template <typename Alloc>
+    auto to_csd(double decimal_value, int places, const Alloc &alloc)
+        -> std::basic_string<char, std::char_traits<char>, Alloc> {
+        auto const length = to_csd_length(decimal_value, places);
+        // Writing the string's own terminator is undefined before C++20, so make room for the '\0'
+        std::basic_string<char, std::char_traits<char>, Alloc> res(length + 1U, '\0', alloc);
+        to_csd_into(decimal_value, places, &res[0], length + 1U);
+        res.resize(length);
+        return res;
+    }
+
+    /**
+     * Converts a double to CSD format with a fixed number of non-zero digits
+     * into a string using the given allocator.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] nnz - The maximum number of non-zero digits allowed in the CSD representation.
+     * @param[in] alloc - The allocator of the result.
+     * @return String representation of the input number in CSD format with nnz non-zero digits.
+     */
+    template <typename Alloc>
+    auto to_csdfixed(double decimal_value, unsigned int nnz, const Alloc &alloc)
+        -> std::basic_string<char, std::char_traits<char>, Alloc> {
+        char buffer[64];
+        auto const length = to_csdfixed_into(decimal_value, nnz, buffer, sizeof buffer);
+        if (length < sizeof buffer) {
+            return std::basic_string<char, std::char_traits<char>, Alloc>(buffer, length, alloc);
+        }
+        std::basic_string<char, std::char_traits<char>, Alloc> res(length + 1U, '\0', alloc);
+        to_csdfixed_into(decimal_value, nnz, &res[0], length + 1U);
+        res.resize(length);
+        return res;
+    }
+    CSD_END_INLINE_NAMESPACE
 
     /**
      * Converts a CSD string to a double precision decimal number
@@ -82,7 +294,7 @@ namespace csd {
                 // case '\0':
                 //     break;
                 default:
-                    throw std::invalid_argument("Work with 0, +, -, and . only");
+                    CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
             }
         }
         if (*csd == '\0') {
@@ -103,13 +315,29 @@ namespace csd {
                 // case '\0':
                 //     break;
                 default:
-                    throw std::invalid_argument("Fractional part work with 0, +, and - only");
+                    CSD_THROW(std::invalid_argument("Fractional part work with 0, +, and - only"));
             }
             scale /= 2;
         }
         return decimal_value;
     }
 
+    /**
+     * Converts a CSD string to a double precision decimal number
+     * using a lookup table of four-digit chunks.
+     *
+     * Every character is mapped to a two-bit digit code, and the codes of
+     * four digits index a 256-entry table of chunk values, so there is no
+     * branch per digit. The result is the same as that of `to_decimal`.
+     *
+     * This is an internal implementation detail, not part of the public API.
+     *
+     * @param[in] csd - Pointer to the null-terminated CSD string
+     * @return double decimal value of the CSD format
+     * @throw std::invalid_argument if an invalid character is encountered
+     */
+    extern auto to_decimal_using_lut(const char *csd) -> double;
+
     /**
      * @brief Convert the integral part of a CSD string to a decimal
      *
@@ -125,30 +353,32 @@ namespace csd {
      * It stops when it reaches either a '.' or '\0' character, as those mark the end of
      * the integral part.
      *
-     * It throws an exception if any invalid character is encountered.
+     * It throws an exception if any invalid character is encountered. Past 31
+     * digits, the value wraps around modulo 2^32.
      *
      * @param[in] csd - Pointer to the null-terminated CSD string
      * @return The decimal value of the integral part
      */
     CONSTEXPR14 auto to_decimal_integral(const char *&csd) -> int {
-        auto decimal_value = 0;
+        // Unsigned, so that negative values and the wrap-around stay defined
+        auto decimal_value = 0U;
 
         for (;; ++csd) {
             auto digit = *csd;
             if (digit == '0') {
-                decimal_value <<= 1;
+                decimal_value *= 2U;
             } else if (digit == '+') {
-                decimal_value = (decimal_value << 1) + 1;
+                decimal_value = decimal_value * 2U + 1U;
             } else if (digit == '-') {
-                decimal_value = (decimal_value << 1) - 1;
+                decimal_value = decimal_value * 2U - 1U;
             } else if (digit == '.' || digit == '\0') {
                 break;
             } else {
-                throw std::invalid_argument("Work with 0, +, -, and . only");
+                CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
             }
         }
 
-        return decimal_value;
+        return static_cast<int>(decimal_value);
     }
 
     /**
@@ -174,7 +404,7 @@ namespace csd {
             } else if (digit == '\0') {
                 break;
             } else {
-                throw std::invalid_argument("Fractional part work with 0, +, and - only");
+                CSD_THROW(std::invalid_argument("Fractional part work with 0, +, and - only"));
             }
             scale /= 2.0;
         }
@@ -222,6 +452,137 @@ namespace csd {
      * represents the input string. It is assumed that the string is
      * null-terminated.
      * @return int decimal value of the CSD format
+     * @see to_decimal_wide in wide.hpp for values that do not fit an `int`
      */
     CONSTEXPR14 auto to_decimal_i(const char *csd) -> int { return to_decimal_integral(csd); }
+
+    /**
+     * @brief Outcome of the non-throwing decoders, like `std::from_chars_result`
+     */
+    struct DecodeResult {
+        const char *ptr;  ///< one past the last character parsed
+        std::errc ec;     ///< `std::errc()` on success
+    };
+
+    /**
+     * @brief Convert the CSD characters in [first, last) to a decimal without throwing
+     *
+     * Works like `std::from_chars`: the longest prefix of the form
+     * `[0+-]*(.[0+-]*)?` holding at least one digit is parsed and the result
+     * points past it. The range needs no null terminator, so fields can be
+     * parsed in place, e.g. inside a memory-mapped file; a caller that wants
+     * the whole range to be a CSD number checks `ptr == last`.
+     *
+     * The value is that of `to_decimal` on the same characters. The
+     * integral part is accumulated in a double, so it also stays exact
+     * beyond the 31 digits of an `int`, up to 53 significant digits.
+     *
+     * @param[in] first - Start of the characters
+     * @param[in] last - End of the characters
+     * @param[out] value - Receives the decimal value; left unchanged on error
+     * @return `{end of the number, std::errc()}`, or `{first,
+     *         std::errc::invalid_argument}` if the range does not start with a
+     *         CSD number
+     */
+    CONSTEXPR14 auto to_decimal(const char *first, const char *last, double &value) noexcept
+        -> DecodeResult {
+        auto csd = first;
+        auto integral = 0.0;
+        for (; csd != last; ++csd) {
+            auto const digit = *csd;
+            if (digit == '0') {
+                integral *= 2.0;
+            } else if (digit == '+') {
+                integral = 2.0 * integral + 1.0;
+            } else if (digit == '-') {
+                integral = 2.0 * integral - 1.0;
+            } else {
+                break;
+            }
+        }
+        auto digits = csd != first;
+        auto fractional = 0.0;
+        if (csd != last && *csd == '.') {
+            auto scale = 0.5;
+            for (++csd; csd != last; ++csd) {
+                auto const digit = *csd;
+                if (digit == '+') {
+                    fractional += scale;
+                } else if (digit == '-') {
+                    fractional -= scale;
+                } else if (digit != '0') {
+                    break;
+                }
+                scale /= 2.0;
+                digits = true;
+            }
+        }
+        if (!digits) {
+            return DecodeResult{first, std::errc::invalid_argument};
+        }
+        value = integral + fractional;
+        return DecodeResult{csd, std::errc()};
+    }
+
+    /**
+     * @brief Convert the CSD digits in [first, last) to an integer without throwing
+     *
+     * Works like `std::from_chars` for integers: the longest prefix of
+     * `[0+-]` digits is parsed, and parsing stops at anything else,
+     * including a '.'.
+     *
+     * @param[in] first - Start of the characters
+     * @param[in] last - End of the characters
+     * @param[out] value - Receives the integer; left unchanged on error
+     * @return `{end of the digits, std::errc()}`; `{first,
+     *         std::errc::invalid_argument}` if there is no digit; `{end of
+     *         the digits, std::errc::result_out_of_range}` if the value does
+     *         not fit an `int`
+     */
+    CONSTEXPR14 auto to_decimal_i(const char *first, const char *last, int &value) noexcept
+        -> DecodeResult {
+        // A prefix out of the range of `int` only moves further away: with m
+        // more digits the value is prefix * 2^m plus at most 2^m - 1
+        auto csd = first;
+        auto decimal_value = 0LL;
+        auto overflow = false;
+        for (; csd != last; ++csd) {
+            auto const digit = *csd;
+            if (digit != '0' && digit != '+' && digit != '-') {
+                break;
+            }
+            if (!overflow) {
+                decimal_value = 2 * decimal_value + (digit == '+') - (digit == '-');
+                overflow = decimal_value > 2147483647LL || decimal_value < -2147483647LL - 1;
+            }
+        }
+        if (csd == first) {
+            return DecodeResult{first, std::errc::invalid_argument};
+        }
+        if (overflow) {
+            return DecodeResult{csd, std::errc::result_out_of_range};
+        }
+        value = int(decimal_value);
+        return DecodeResult{csd, std::errc()};
+    }
+
+#ifdef CSD_HAS_STRING_VIEW
+    /**
+     * @brief `to_decimal(first, last, value)` over a string view
+     */
+    constexpr auto to_decimal(std::string_view csd, double &value) noexcept -> DecodeResult {
+        return to_decimal(csd.data(), csd.data() + csd.size(), value);
+    }
+
+    /**
+     * @brief `to_decimal_i(first, last, value)` over a string view
+     */
+    constexpr auto to_decimal_i(std::string_view csd, int &value) noexcept -> DecodeResult {
+        return to_decimal_i(csd.data(), csd.data() + csd.size(), value);
+    }
+#endif
 }  // namespace csd
+
+#ifdef CSD_HEADER_ONLY
+#    include "csd_impl.hpp"
+#endif
@@ -0,0 +1,254 @@
+/// @file csd_const.hpp
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for int64_t, uint64_t
+#include <stdexcept>  // for invalid_argument, length_error
+#include <string>     // for basic_string
+
+#include "csd.hpp"     // for CONSTEXPR14
+#include "packed.hpp"  // for PackedCsd, to_csd_i_packed, packed_max_digits
+
+namespace csd {
+
+    /**
+     * @brief CSD string stored in a fixed-capacity character array
+     *
+     * The compile-time counterpart of the `std::string` returned by `to_csd`
+     * and `to_csd_i`: it never allocates, so it can be built in a constant
+     * expression. `data` is always null-terminated.
+     *
+     * @tparam N The maximum number of characters
+     */
+    template <std::size_t N> struct FixedCsd {
+        char data[N + 1];    ///< the characters, followed by a '\0'
+        std::size_t length;  ///< number of characters
+
+        constexpr auto c_str() const -> const char * { return data; }
+        constexpr auto size() const -> std::size_t { return length; }
+        constexpr auto operator[](std::size_t i) const -> char { return data[i]; }
+
+        /**
+         * @brief Append a character
+         *
+         * @param[in] digit - The character to append
+         * @throw std::length_error if the capacity `N` is exceeded
+         */
+        CONSTEXPR14 auto push_back(char digit) -> void {
+            if (length == N) {
+                CSD_THROW(std::length_error("CSD number exceeds the FixedCsd capacity"));
+            }
+            data[length] = digit;
+            data[++length] = '\0';
+        }
+
+        /**
+         * @brief Copy into a std::string
+         */
+        auto str() const -> std::string { return std::string(data, length); }
+    };
+
+    /**
+     * @brief Compare a FixedCsd with a null-terminated string
+     */
+    template <std::size_t N>
+    CONSTEXPR14 auto operator==(const FixedCsd<N> &lhs, const char *rhs) -> bool {
+        for (std::size_t i = 0U; i != lhs.length; ++i) {
+            if (rhs[i] != lhs.data[i]) {
+                return false;
+            }
+        }
+        return rhs[lhs.length] == '\0';
+    }
+
+    template <std::size_t N>
+    CONSTEXPR14 auto operator!=(const FixedCsd<N> &lhs, const char *rhs) -> bool {
+        return !(lhs == rhs);
+    }
+
+    /**
+     * @brief Convert a packed CSD number to a FixedCsd
+     *
+     * The compile-time counterpart of `to_string(const PackedCsd &)`.
+     *
+     * @param[in] csd - The packed CSD number
+     * @return The CSD string (at most 64 digits and a binary point)
+     */
+    CONSTEXPR14 auto to_fixed_csd(const PackedCsd &csd) -> FixedCsd<packed_max_digits + 1U> {
+        FixedCsd<packed_max_digits + 1U> res{};
+        for (auto i = csd.length; i != 0U; --i) {
+            if (csd.has_point && i == csd.frac) {
+                res.push_back('.');
+            }
+            auto const bit = std::uint64_t{1U} << (i - 1U);
+            res.push_back((csd.pos & bit) != 0U ? '+' : (csd.neg & bit) != 0U ? '-' : '0');
+        }
+        if (csd.has_point && csd.frac == 0U) {
+            res.push_back('.');
+        }
+        return res;
+    }
+
+    /**
+     * @brief Convert an integer to CSD format at compile time
+     *
+     * Produces the same string as `to_csd_i`.
+     *
+     * @param[in] decimal_value - The integer to convert to CSD format.
+     * @return The CSD string in a fixed-capacity array
+     */
+    CONSTEXPR14 auto to_fixed_csd_i(std::int64_t decimal_value)
+        -> FixedCsd<packed_max_digits + 1U> {
+        return to_fixed_csd(to_csd_i_packed(decimal_value));
+    }
+
+    /**
+     * @brief Convert a double to CSD format at compile time
+     *
+     * The digit loop is the one of `to_csd` and uses the same floating-point
+     * operations, so the digits are the same. The starting power of two is
+     * `ceil(log2(1.5 |x|))`, derived exactly from 1.5 |x| = 2^m (1 + k 2^-52)
+     * with integers m and k: `log2` returns m + k 2^-52 / ln 2 rounded, which
+     * is m itself, rather than just above it, when k 2^-52 / ln 2 is within
+     * half an ulp of m, i.e. k <= floor(2^(j-1) ln 2) with j = floor(log2 m).
+     *
+     * @tparam N The capacity of the result
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] places - The number of decimal places to include in the CSD representation.
+     * @return The CSD string in a fixed-capacity array
+     * @throw std::length_error if the result has more than `N` characters
+     */
+    template <std::size_t N = 128U>
+    CONSTEXPR14 auto to_fixed_csd(double decimal_value, int places) -> FixedCsd<N> {
+        FixedCsd<N> res{};
+        auto const absnum = decimal_value < 0.0 ? -decimal_value : decimal_value;
+        auto rem = 0;
+        auto p2n = 1.0;
+        if (absnum >= 1.0) {
+            auto const scaled = absnum * 1.5;
+            auto low = p2n;  // 2^(rem - 1), finite where 2^rem overflows to inf as `pow` does
+            while (p2n < scaled) {
+                low = p2n;
+                p2n *= 2.0;
+                ++rem;
+            }
+            if (rem > 1) {
+                // Both the division by 2^m and the subtraction are exact
+                auto const k = (scaled / low - 1.0) * 4503599627370496.0;
+                auto j = 0;
+                for (auto m = rem - 1; m > 1; m >>= 1) {
+                    ++j;
+                }
+                // ln 2 as a 64-bit binary fraction
+                auto const round_down
+                    = j > 1 ? std::uint64_t{0xB17217F7D1CF79ABU} >> (65 - j) : std::uint64_t{0U};
+                if (k <= double(round_down)) {
+                    p2n = low;
+                    --rem;
+                }
+            }
+        } else {
+            res.push_back('0');
+        }
+
+        // The integral digits down to 2^0, then the fractional ones
+        for (auto pass = 0; pass != 2; ++pass) {
+            auto const value = pass == 0 ? 0 : -places;
+            while (rem > value) {
+                p2n /= 2.0;
+                rem -= 1;
+                auto const det = 1.5 * decimal_value;
+                if (det > p2n) {
+                    res.push_back('+');
+                    decimal_value -= p2n;
+                } else if (det < -p2n) {
+                    res.push_back('-');
+                    decimal_value += p2n;
+                } else {
+                    res.push_back('0');
+                }
+            }
+            if (pass == 0) {
+                res.push_back('.');
+            }
+        }
+        return res;
+    }
+
+    namespace detail {
+        /** Number of set bits, as a C++11 constant expression */
+        constexpr auto popcount(std::uint64_t x) -> unsigned int {
+            return x == 0U ? 0U : 1U + popcount(x & (x - 1U));
+        }
+
+        /**
+         * @brief Parse a CSD string into a PackedCsd in a constant expression
+         *
+         * Validates the same way as `to_packed`.
+         */
+        CONSTEXPR14 auto parse_packed(const char *csd, std::size_t size) -> PackedCsd {
+            PackedCsd result{};
+            for (std::size_t i = 0U; i != size; ++i) {
+                auto const digit = csd[i];
+                if (digit == '.' && !result.has_point) {
+                    result.has_point = true;
+                    continue;
+                }
+                if (digit != '0' && digit != '+' && digit != '-') {
+                    if (result.has_point) {
+                        CSD_THROW(
+                            std::invalid_argument("Fractional part work with 0, +, and - only"));
+                    }
+                    CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
+                }
+                if (result.length == packed_max_digits) {
+                    CSD_THROW(std::length_error("CSD number exceeds 64 digits"));
+                }
+                result.pos = (result.pos << 1) | std::uint64_t(digit == '+');
+                result.neg = (result.neg << 1) | std::uint64_t(digit == '-');
+                ++result.length;
+                if (result.has_point) {
+                    ++result.frac;
+                }
+            }
+            return result;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Digit masks of the CSD of an integer constant
+     *
+     * Everything is a constant expression (even in C++11), so e.g.
+     * `csd_const<28>::pos` can drive a shift-and-add decomposition that the
+     * compiler folds completely.
+     *
+     * @tparam V The integer constant
+     */
+    template <std::int64_t V> struct csd_const {
+        static constexpr PackedCsd value = to_csd_i_packed(V);  ///< the packed CSD
+        static constexpr std::uint64_t pos = value.pos;         ///< mask of the '+' digits
+        static constexpr std::uint64_t neg = value.neg;         ///< mask of the '-' digits
+        static constexpr unsigned int length = value.length;    ///< number of digits
+        static constexpr unsigned int nnz = detail::popcount(pos | neg);  ///< non-zero digits
+    };
+
+    template <std::int64_t V> constexpr PackedCsd csd_const<V>::value;
+    template <std::int64_t V> constexpr std::uint64_t csd_const<V>::pos;
+    template <std::int64_t V> constexpr std::uint64_t csd_const<V>::neg;
+    template <std::int64_t V> constexpr unsigned int csd_const<V>::length;
+    template <std::int64_t V> constexpr unsigned int csd_const<V>::nnz;
+
+    inline namespace literals {
+        /**
+         * @brief CSD literal, e.g. `"+00-00.+"_csd`
+         *
+         * @return The packed representation of the literal
+         * @throw std::invalid_argument if an invalid character is encountered
+         * (a compile error in a constant expression)
+         */
+        CONSTEXPR14 auto operator""_csd(const char *csd, std::size_t size) -> PackedCsd {
+            return detail::parse_packed(csd, size);
+        }
+    }  // namespace literals
+
+}  // namespace csd
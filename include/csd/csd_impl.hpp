@@ -0,0 +1,740 @@
+/// @file csd_impl.hpp
+/**
+ Canonical Signed Digit Functions
+
+ Handles:
+  * Decimals
+  *
+  *
+
+ eg, +00-00+000.0 or 0.+0000-00+
+ Where: '+' is +1
+        '-' is -1
+
+ Harnesser
+ License: GPL2
+*/
+#pragma once
+
+#include <algorithm>  // for max, min
+#include <cmath>      // for fabs, pow, ceil, log2, ldexp, frexp, ilogb, floor
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint32_t, uint64_t
+#include <cstring>    // for memcpy
+#include <stdexcept>  // for length_error
+#include <string>     // for basic_string
+
+#include "csd.hpp"      // for CSD_BEGIN_INLINE_NAMESPACE, CSD_THROW, uint128_t
+#include "metrics.hpp"  // for ScopedMetric, MetricFunction
+#include "packed.hpp"   // for PackedCsd, packed_max_digits, to_string
+
+// The encoders, compiled once by source/csd.cpp, or included by csd.hpp
+// into every translation unit of a CSD_HEADER_ONLY build.
+
+namespace csd {
+    namespace detail {
+        /**
+         * @brief the highest power of two
+         *
+         * https://thecodingbot.com/find-the-greatest-power-of-2-less-than-or-equal-to-a-given-number/
+         *
+         * The function calculates the highest power of two that is less than or equal
+         * to a given number.
+         *
+         * @param[in] x The parameter `x` is an unsigned 32-bit integer.
+         *
+         * @return the highest power of two that is less than or equal to the input
+         * number.
+         */
+        inline auto highest_power_of_two_in(std::uint32_t x) -> std::uint32_t {
+            x |= x >> 1;
+            x |= x >> 2;
+            x |= x >> 4;
+            x |= x >> 8;
+            x |= x >> 16;
+            return x ^ (x >> 1);
+        }
+
+        /**
+         * @brief Digit sink appending to a std::string
+         */
+        struct StringSink {
+            std::string &csd;
+
+            void plus() { csd += '+'; }
+            void minus() { csd += '-'; }
+            void zero() { csd += '0'; }
+            void point() { csd += '.'; }
+            void digit(char digit) { csd += digit; }
+            void digits(const char *text, std::size_t count) { csd.append(text, count); }
+        };
+
+        /**
+         * @brief Digit sink writing into a fixed-size character buffer
+         *
+         * Characters beyond `cap - 1` are counted but dropped, so that `size`
+         * ends up as the full length, as with `snprintf`.
+         */
+        struct BufferSink {
+            char *out;
+            std::size_t cap;
+            std::size_t size;
+
+            void put(char digit) {
+                if (size + 1U < cap) {
+                    out[size] = digit;
+                }
+                ++size;
+            }
+
+            void plus() { put('+'); }
+            void minus() { put('-'); }
+            void zero() { put('0'); }
+            void point() { put('.'); }
+            void digit(char digit) { put(digit); }
+
+            void digits(const char *text, std::size_t count) {
+                if (size + count < cap) {
+                    std::memcpy(out + size, text, count);
+                    size += count;
+                    return;
+                }
+                for (std::size_t i = 0U; i != count; ++i) {
+                    put(text[i]);
+                }
+            }
+
+            auto finish() -> std::size_t {
+                if (cap != 0U) {
+                    out[size < cap ? size : cap - 1U] = '\0';
+                }
+                return size;
+            }
+        };
+
+        /**
+         * @brief Digit sink shifting digits into a PackedCsd
+         *
+         * Each new digit becomes the least significant one, so the masks end up in
+         * the same order as the string form without knowing the length up front.
+         */
+        struct PackedSink {
+            PackedCsd csd;
+
+            void push(std::uint64_t is_plus, std::uint64_t is_minus) {
+                if (csd.length == csd::packed_max_digits) {
+                    CSD_THROW(std::length_error("CSD number exceeds 64 digits"));
+                }
+                csd.pos = (csd.pos << 1) | is_plus;
+                csd.neg = (csd.neg << 1) | is_minus;
+                ++csd.length;
+                if (csd.has_point) {
+                    ++csd.frac;
+                }
+            }
+
+            void plus() { push(1U, 0U); }
+            void minus() { push(0U, 1U); }
+            void zero() { push(0U, 0U); }
+            void point() { csd.has_point = true; }
+            void digit(char digit) { push(digit == '+' ? 1U : 0U, digit == '-' ? 1U : 0U); }
+
+            void digits(const char *text, std::size_t count) {
+                for (std::size_t i = 0U; i != count; ++i) {
+                    digit(text[i]);
+                }
+            }
+        };
+
+        /**
+         * @brief Generate the digits of `to_csd` into a sink
+         *
+         * @param[in] decimal_value The value to be converted
+         * @param[in] places The number of decimal places
+         * @param[in,out] sink Receives the digits from the most significant one
+         */
+        template <typename Sink> void csd_digits(double decimal_value, int places, Sink &sink) {
+            auto absnum = std::fabs(decimal_value);
+            int rem{0};
+            if (absnum >= 1.0) {
+                rem = int(std::ceil(std::log2(absnum * 1.5)));
+            } else {
+                sink.zero();
+            }
+
+            auto p2n = std::pow(2.0, rem);
+            auto loop_fn = [&](int value) {
+                while (rem > value) {
+                    p2n /= 2.0;
+                    rem -= 1;
+                    auto const det = 1.5 * decimal_value;
+                    if (det > p2n) {
+                        sink.plus();
+                        decimal_value -= p2n;
+                    } else {
+                        if (det < -p2n) {
+                            sink.minus();
+                            decimal_value += p2n;
+                        } else {
+                            sink.zero();
+                        }
+                    }
+                }
+            };
+
+            loop_fn(0);
+            sink.point();
+            loop_fn(-places);
+        }
+
+        /**
+         * @brief Generate the digits of `to_csd_i` into a sink
+         *
+         * @param[in] decimal_value The integer to be converted
+         * @param[in,out] sink Receives the digits from the most significant one
+         */
+        template <typename Sink> void csd_i_digits(int decimal_value, Sink &sink) {
+            if (decimal_value == 0) {
+                sink.zero();
+                return;
+            }
+            // auto p2n = int(pow(2.0, ceil(log2(abs(decimal_value) * 1.5))));
+            auto temp = std::uint32_t(std::abs(decimal_value) * 3 / 2);
+            auto p2n = highest_power_of_two_in(temp) * 2;
+
+            while (p2n > 1) {
+                auto const p2n_half = p2n >> 1;
+                auto const det = 3 * decimal_value;
+                if (det > int(p2n)) {
+                    sink.plus();
+                    decimal_value -= p2n_half;
+                } else if (det < -int(p2n)) {
+                    sink.minus();
+                    decimal_value += p2n_half;
+                } else {
+                    sink.zero();
+                }
+                p2n = p2n_half;
+            }
+        }
+
+        /**
+         * @brief Generate the digits of `to_csdfixed` into a sink
+         *
+         * @param[in] decimal_value The value to be converted
+         * @param[in] nnz The maximum number of non-zero digits
+         * @param[in,out] sink Receives the digits from the most significant one
+         */
+        template <typename Sink> void csdfixed_digits(double decimal_value, unsigned int nnz,
+                                                      Sink &sink) {
+            // if (decimal_value == 0.0) {
+            //     return "0";
+            // }
+            auto const absnum = std::fabs(decimal_value);
+            int rem{0};
+            if (absnum >= 1.0) {
+                rem = int(std::ceil(std::log2(absnum * 1.5)));
+            } else {
+                sink.zero();
+            }
+            auto p2n = std::pow(2.0, rem);
+
+            while (rem > 0 || (nnz > 0 && std::fabs(decimal_value) > 1e-100)) {
+                if (rem == 0) {
+                    sink.point();
+                }
+                p2n /= 2.0;
+                rem -= 1;
+                auto const det = 1.5 * decimal_value;
+                if (det > p2n) {
+                    sink.plus();
+                    decimal_value -= p2n;
+                    nnz -= 1;
+                } else {
+                    if (det < -p2n) {
+                        sink.minus();
+                        decimal_value += p2n;
+                        nnz -= 1;
+                    } else {
+                        sink.zero();
+                    }
+                }
+                if (nnz == 0) {
+                    decimal_value = 0.0;
+                }
+            }
+        }
+
+        /** Largest magnitude handled by the fast path (so that 2^rem never overflows) */
+        constexpr double fast_max_magnitude = 1e300;
+
+        /**
+         * @brief `ceil(log2(1.5 |x|))` for |x| >= 1, exactly as the reference loop computes it
+         *
+         * With 1.5 |x| = m 2^e and 0.5 <= m < 1, the result is e unless m is
+         * within rounding distance of 0.5, where it depends on how `log2`
+         * rounds; only then is `log2` actually called.
+         */
+        inline auto integral_digits(double absnum) -> int {
+            if (!(absnum >= 1.0)) {
+                return 0;
+            }
+            auto const scaled = absnum * 1.5;
+            if (!(scaled <= fast_max_magnitude)) {
+                return int(std::ceil(std::log2(scaled)));
+            }
+            int exponent = 0;
+            auto const mantissa = std::frexp(scaled, &exponent);
+            if (mantissa - 0.5 < 1e-12) {
+                return int(std::ceil(std::log2(scaled)));
+            }
+            return exponent;
+        }
+
+        /**
+         * @brief Pass the digits of exponents `lowest + count - 1` down to `lowest`,
+         * given as masks, to `emit` one at a time
+         */
+        template <typename Emit, typename UInt>
+        void emit_masks(Emit &emit, int lowest, unsigned count, UInt plus, UInt minus) {
+            for (auto j = count; j != 0U; --j) {
+                // Random digits would defeat a branch per digit
+                auto const digit = int(unsigned(plus >> (j - 1U)) & 1U)
+                                   - int(unsigned(minus >> (j - 1U)) & 1U);
+                if (!emit(lowest + int(j) - 1, digit)) {
+                    break;
+                }
+            }
+        }
+
+        /**
+         * @brief Writes the digits of `to_csdfixed` into a sink as `naf_digits` produces them
+         *
+         * Fractional zeros are held back until a non-zero digit follows, and
+         * the digits stop after the `nnz`-th non-zero one. `finish` then writes
+         * the integral zeros the reference loop adds after that.
+         */
+        template <typename Sink> struct FixedDigits {
+            Sink &sink;
+            unsigned int left;  ///< Non-zero digits still allowed
+            unsigned int pending_zeros;
+            bool point;
+            int last;  ///< Exponent of the last digit received
+
+            auto operator()(int k, int digit) -> bool {
+                last = k;
+                if (digit == 0) {
+                    if (k >= 0) {
+                        sink.zero();
+                    } else {
+                        ++pending_zeros;
+                    }
+                    return true;
+                }
+                if (k < 0 && !point) {
+                    sink.point();
+                    point = true;
+                }
+                for (; pending_zeros != 0U; --pending_zeros) {
+                    sink.zero();
+                }
+                sink.digit("-0+"[digit + 1]);
+                return --left != 0U;
+            }
+
+            /**
+             * @brief All the remaining digits at once
+             *
+             * The masks are cut after the `left`-th non-zero digit, and the
+             * digits are rendered without a branch per digit and written in
+             * at most two runs.
+             */
+            void masks(int lowest, unsigned count, std::uint64_t plus, std::uint64_t minus) {
+                auto const nonzero = plus | minus;
+                auto rest = nonzero;
+                auto cut = 0U;  // lowest bit kept
+                for (; rest != 0U && left != 0U; --left) {
+                    cut = bit_length(rest) - 1U;
+                    rest ^= std::uint64_t{1U} << cut;
+                }
+                if (left != 0U) {
+                    cut = 0U;
+                }
+                auto const keep = ~((std::uint64_t{1U} << cut) - 1U);
+                plus &= keep;
+                minus &= keep;
+
+                char text[64];
+                auto render = [&](unsigned high, unsigned low) {
+                    std::size_t size = 0U;
+                    for (auto j = high; j != low; --j) {
+                        text[size++] = "-0+"[1 + int(unsigned(plus >> (j - 1U)) & 1U)
+                                             - int(unsigned(minus >> (j - 1U)) & 1U)];
+                    }
+                    sink.digits(text, size);
+                };
+                // Bits at or above `units` are the integral digits, all of them written
+                auto const units = std::min(unsigned(-lowest), count);
+                render(count, units);
+                last = lowest;
+
+                auto const fraction = (plus | minus) & ((std::uint64_t{1U} << units) - 1U);
+                if (fraction == 0U) {
+                    return;
+                }
+                if (!point) {
+                    sink.point();
+                    point = true;
+                }
+                for (; pending_zeros != 0U; --pending_zeros) {
+                    sink.zero();
+                }
+                render(units, bit_length(fraction & (~fraction + 1U)) - 1U);
+            }
+
+            /** The integral zeros after the last non-zero digit */
+            void finish() {
+                for (auto k = last; k > 0; --k) {
+                    sink.zero();
+                }
+            }
+        };
+
+        template <typename Sink>
+        void emit_masks(FixedDigits<Sink> &emit, int lowest, unsigned count, std::uint64_t plus,
+                        std::uint64_t minus) {
+            emit.masks(lowest, count, plus, minus);
+        }
+
+        /**
+         * @brief The remaining digits of the reference loop from integer arithmetic
+         *
+         * The reference loop keeps the residual `v` exactly (every `v -= p2n` is
+         * an exact Sterbenz subtraction) and picks '+' if 1.5 v > 2^k. Scaled
+         * by 2^-lowest, v = I + f with an integer I and 0 <= f < 1, and the
+         * digits from that rule are the non-adjacent form given by the x ^ 3x
+         * trick, taking `(3I + floor(3f)) >> 1` for the x3 term. `floor(3f)`
+         * is decided by comparing f with the doubles 1/3 and 2/3, which is exact
+         * because no double lies strictly between them and 1/3 or 2/3.
+         *
+         * @tparam UInt The unsigned integer type wide enough for 3I
+         * @param[in] v The residual, exactly representable on the digit grid
+         * @param[in] high The exponent of the first digit to produce
+         * @param[in] lowest The exponent of the last digit to produce
+         * @param[in,out] emit Receives `(k, digit)` and returns whether to go on
+         * @return false (without emitting) if the integer type is too narrow
+         */
+        template <typename UInt, typename Emit>
+        auto naf_integer_digits(double v, int high, int lowest, Emit &emit) -> bool {
+            auto const count = unsigned(high - lowest + 1);
+            auto const scaled = std::ldexp(std::fabs(v), -lowest);
+            if (!(scaled < std::ldexp(1.0, int(count) + 1))) {
+                return false;
+            }
+            auto const whole = std::floor(scaled);
+            auto const frac = scaled - whole;
+            auto const integer = UInt(whole);
+            auto const thirds = UInt(unsigned(frac > 1.0 / 3.0) + unsigned(frac > 2.0 / 3.0));
+            auto const xh = UInt(integer >> 1U);
+            auto const x3 = UInt((UInt(3U) * integer + thirds) >> 1U);
+            auto const nonzero = UInt(xh ^ x3);
+            if ((nonzero >> count) != 0U) {
+                return false;
+            }
+            auto const plus = UInt((v < 0.0 ? xh : x3) & nonzero);
+            auto const minus = UInt((v < 0.0 ? x3 : xh) & nonzero);
+            emit_masks(emit, lowest, count, plus, minus);
+            return true;
+        }
+
+        /**
+         * @brief The digits of the reference loop from 2^(rem-1) down to 2^lowest
+         *
+         * The digits down to the leading bit of x use the reference floating-point
+         * step: only there can the rounding of `1.5 * v` change a decision. The
+         * rest comes from `naf_integer_digits` in 64-bit (or 128-bit) integers,
+         * and from the floating-point step again when even that is too narrow.
+         *
+         * @param[in] v The value to convert
+         * @param[in] rem The number of integral digits, as computed by the reference
+         * @param[in] lowest The exponent of the last digit
+         * @param[in,out] emit Receives `(k, digit)` and returns whether to go on
+         */
+        template <typename Emit> void naf_digits(double v, int rem, int lowest, Emit &emit) {
+            auto const absnum = std::fabs(v);
+            auto const top = absnum == 0.0 ? lowest : std::max(std::ilogb(absnum), lowest);
+            auto p2n = std::ldexp(1.0, rem);
+            auto step = [&]() -> int {
+                p2n /= 2.0;
+                auto const det = 1.5 * v;
+                if (det > p2n) {
+                    v -= p2n;
+                    return 1;
+                }
+                if (det < -p2n) {
+                    v += p2n;
+                    return -1;
+                }
+                return 0;
+            };
+
+            auto k = rem - 1;
+            for (; k >= top; --k) {
+                if (!emit(k, step())) {
+                    return;
+                }
+            }
+            if (k < lowest) {
+                return;
+            }
+            auto const count = k - lowest + 1;
+            if (count <= 60 && naf_integer_digits<std::uint64_t>(v, k, lowest, emit)) {
+                return;
+            }
+    #if defined(__SIZEOF_INT128__)
+            if (count <= 124 && naf_integer_digits<uint128_t>(v, k, lowest, emit)) {
+                return;
+            }
+    #endif
+            p2n = std::ldexp(1.0, k + 1);
+            for (; k >= lowest; --k) {
+                if (!emit(k, step())) {
+                    return;
+                }
+            }
+        }
+
+        /**
+         * @brief Generate the digits of `to_csd` into a sink without the digit loop
+         *
+         * Produces exactly the digits of `csd_digits`, which it falls back
+         * to for huge magnitudes and for digits down to the subnormals.
+         */
+        template <typename Sink>
+        void csd_digits_fast(double decimal_value, int places, Sink &sink) {
+            auto const absnum = std::fabs(decimal_value);
+            // Near the subnormals, the reference loop's 1.5 * residual is rounded
+            if (!(absnum <= fast_max_magnitude) || places > 1021
+                || (absnum != 0.0 && std::ilogb(absnum) < -1021)) {
+                csd_digits(decimal_value, places, sink);
+                return;
+            }
+            auto const rem = integral_digits(absnum);
+            if (rem == 0) {
+                sink.zero();
+                sink.point();
+            }
+            auto emit = [&sink](int k, int digit) {
+                sink.digit("-0+"[digit + 1]);
+                if (k == 0) {
+                    sink.point();
+                }
+                return true;
+            };
+            naf_digits(decimal_value, rem, places > 0 ? -places : 0, emit);
+        }
+
+        /**
+         * @brief Generate the digits of `to_csdfixed` into a sink without the digit loop
+         *
+         * The digits are those of `to_csd` with enough places to make the value
+         * exact, cut after the `nnz`-th non-zero digit; the integral digits are
+         * always complete, and trailing fractional zeros never appear since the
+         * reference loop stops as soon as the residual is zero. Produces exactly
+         * the digits of `csdfixed_digits`.
+         */
+        template <typename Sink> void csdfixed_digits_fast(double decimal_value, unsigned int nnz,
+                                                           Sink &sink) {
+            auto const absnum = std::fabs(decimal_value);
+            // Tiny digits would meet the reference loop's 1e-100 cut-off
+            if (nnz == 0U || !(absnum <= fast_max_magnitude)
+                || (absnum != 0.0 && std::ilogb(absnum) < -200)) {
+                csdfixed_digits(decimal_value, nnz, sink);
+                return;
+            }
+            auto const rem = integral_digits(absnum);
+            if (rem == 0) {
+                sink.zero();
+            }
+            if (absnum == 0.0) {
+                return;
+            }
+
+            FixedDigits<Sink> emit{sink, nnz, 0U, false, 0};
+            naf_digits(decimal_value, rem, std::min(std::ilogb(absnum) - 52, 0), emit);
+            emit.finish();
+        }
+    }  // namespace detail
+
+    CSD_BEGIN_INLINE_NAMESPACE
+    /**
+     * @brief Convert to CSD (Canonical Signed Digit) string representation
+     *
+     * Original author: Harnesser
+     * https://sourceforge.net/projects/pycsd/
+     * License: GPL2
+     *
+     * The function `to_csd` converts a given number to its Canonical Signed Digit
+     * (CSD) representation with a specified number of decimal places.
+     *
+     * @param[in] decimal_value The `decimal_value` parameter is a double precision floating-point
+     * number that represents the value to be converted to CSD (Canonic Signed Digit)
+     * representation.
+     * @param[in] places The `places` parameter in the `to_csd` function represents the
+     * number of decimal places to include in the CSD (Canonical Signed Digit)
+     * representation of the given `decimal_value`.
+     *
+     * @return The function `to_csd` returns a string representation of the given
+     * `decimal_value` in Canonical Signed Digit (CSD) format.
+     */
+    auto to_csd(double decimal_value, int places) -> std::string {
+        detail::ScopedMetric metric(MetricFunction::ToCsd);
+        std::string csd;
+        to_csd_into(decimal_value, places, csd);
+        metric.set_size(csd.size());
+        return csd;
+    }
+
+    /**
+     * @brief Exact length of the `to_csd` string
+     *
+     * `to_csd` emits `rem = ceil(log2(1.5 |x|))` integral digits (or a single
+     * '0' when |x| < 1), the binary point, and `places` fractional digits.
+     *
+     * @param[in] decimal_value The value to be converted
+     * @param[in] places The number of decimal places
+     * @return The number of characters of the CSD string
+     */
+    auto to_csd_length(double decimal_value, int places) -> std::size_t {
+        auto const absnum = std::fabs(decimal_value);
+        auto const integral
+            = absnum >= 1.0 ? std::size_t(detail::integral_digits(absnum)) : std::size_t{1U};
+        return integral + 1U + (places > 0 ? std::size_t(places) : std::size_t{0U});
+    }
+
+    auto to_csd_reference(double decimal_value, int places) -> std::string {
+        std::string csd;
+        detail::StringSink sink{csd};
+        detail::csd_digits(decimal_value, places, sink);
+        return csd;
+    }
+
+    auto to_csd_into(double decimal_value, int places, char *out, std::size_t cap)
+        -> std::size_t {
+        detail::BufferSink sink{out, cap, 0U};
+        detail::csd_digits_fast(decimal_value, places, sink);
+        return sink.finish();
+    }
+
+    auto to_csd_into(double decimal_value, int places, std::string &out) -> std::size_t {
+        auto const length = to_csd_length(decimal_value, places);
+        // Writing the string's own terminator is undefined before C++20, so make room for the '\0'
+        out.resize(length + 1U);
+        detail::BufferSink sink{&out[0], length + 1U, 0U};
+        detail::csd_digits_fast(decimal_value, places, sink);
+        out.resize(length);
+        return sink.size;
+    }
+
+    /**
+     * @brief Convert to CSD (Canonical Signed Digit) string representation
+     *
+     * Original author: Harnesser
+     * https://sourceforge.net/projects/pycsd/
+     * License: GPL2
+     *
+     * The function converts a given integer into a Canonical Signed Digit (CSD)
+     * representation. The digits are computed in constant time by
+     * `to_csd_i_packed` and only then rendered as a string.
+     *
+     * @param[in] decimal_value The parameter `decimal_value` is an integer that represents the
+     * number for which we want to generate the CSD (Canonical Signed Digit) representation.
+     *
+     * @return The function `to_csd_i` returns a string.
+     */
+    auto to_csd_i(int decimal_value) -> std::string {
+        return to_string(to_csd_i_packed(decimal_value));
+    }
+
+    /**
+     * @brief Convert to CSD (Canonical Signed Digit) string representation
+     *
+     * The original digit-by-digit version of `to_csd_i`, which compares
+     * `3 * decimal_value` against a running power of two for every digit.
+     *
+     * @param[in] decimal_value The integer to be converted
+     *
+     * @return The function `to_csd_i_reference` returns a string.
+     */
+    auto to_csd_i_reference(int decimal_value) -> std::string {
+        std::string csd;
+        detail::StringSink sink{csd};
+        detail::csd_i_digits(decimal_value, sink);
+        return csd;
+    }
+
+    /**
+     * @brief Convert to CSD (Canonical Signed Digit) string representation
+     *
+     * The function `to_csdfixed` converts a given number into a CSD (Canonic Signed
+     * Digit) representation with a specified number of non-zero digits.
+     *
+     * @param[in] decimal_value The parameter `decimal_value` is a double precision floating-point
+     * number that represents the input value for conversion to CSD (Canonic Signed Digit)
+     * fixed-point representation.
+     * @param[in] nnz The parameter `nnz` stands for "number of non-zero bits". It
+     * represents the maximum number of non-zero bits allowed in the output CSD
+     * (Canonical Signed Digit) representation of the given `decimal_value`.
+     *
+     * @return The function `to_csdfixed` returns a string representation of the
+     * given `decimal_value` in Canonical Signed Digit (CSD) format.
+     */
+    auto to_csdfixed(double decimal_value, unsigned int nnz) -> std::string {
+        detail::ScopedMetric metric(MetricFunction::ToCsdFixed);
+        std::string csd;
+        to_csdfixed_into(decimal_value, nnz, csd);
+        metric.set_size(csd.size());
+        return csd;
+    }
+
+    auto to_csdfixed_reference(double decimal_value, unsigned int nnz) -> std::string {
+        std::string csd;
+        detail::StringSink sink{csd};
+        detail::csdfixed_digits(decimal_value, nnz, sink);
+        return csd;
+    }
+
+    auto to_csdfixed_into(double decimal_value, unsigned int nnz, char *out, std::size_t cap)
+        -> std::size_t {
+        detail::BufferSink sink{out, cap, 0U};
+        detail::csdfixed_digits_fast(decimal_value, nnz, sink);
+        return sink.finish();
+    }
+
+    /**
+     * @brief Convert to CSD with a fixed number of non-zero digits into a string
+     *
+     * The length depends on when the residual runs out, so the digits are
+     * appended to the cleared string, which keeps its capacity.
+     */
+    auto to_csdfixed_into(double decimal_value, unsigned int nnz, std::string &out)
+        -> std::size_t {
+        out.clear();
+        detail::StringSink sink{out};
+        detail::csdfixed_digits_fast(decimal_value, nnz, sink);
+        return out.size();
+    }
+
+    auto to_csd_packed(double decimal_value, int places) -> PackedCsd {
+        detail::PackedSink sink{};
+        detail::csd_digits_fast(decimal_value, places, sink);
+        return sink.csd;
+    }
+
+    auto to_csdfixed_packed(double decimal_value, unsigned int nnz) -> PackedCsd {
+        detail::PackedSink sink{};
+        detail::csdfixed_digits_fast(decimal_value, nnz, sink);
+        return sink.csd;
+    }
+    CSD_END_INLINE_NAMESPACE
+}  // namespace csd
@@ -0,0 +1,135 @@
+/// @file fir.hpp
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int32_t, int64_t
+#include <string>   // for basic_string
+#include <vector>   // for vector
+
+#include "shift_add.hpp"  // for ShiftAddProgram
+
+namespace csd {
+
+    /**
+     * @brief What happens to a filter output that does not fit its width
+     */
+    enum class FirOverflow {
+        Wrap,      ///< keep the low bits, as two's complement hardware does
+        Saturate,  ///< clamp to the most positive or most negative value
+    };
+
+    /**
+     * @brief Fixed-point format of a `CsdFir`
+     *
+     * The sum of the products is exact; it is then shifted right by the
+     * common `frac` of the coefficients plus `output_shift`, truncating
+     * (like `apply_shift_add`) or rounding half up, and brought into
+     * `output_bits` by `overflow`.
+     */
+    struct FirFormat {
+        unsigned int input_bits = 16U;   ///< width of the input samples, 1 to 32
+        unsigned int output_bits = 16U;  ///< width of the output samples, 1 to 32
+        unsigned int output_shift = 0U;  ///< right shift on top of the coefficients' fraction
+        bool round = false;              ///< round half up instead of truncating
+        FirOverflow overflow = FirOverflow::Saturate;
+    };
+
+    namespace detail {
+        /**
+         * The digits of weight 2^shift of all the coefficients: the samples
+         * at the offsets [first, negative) are added, and those at
+         * [negative, last) subtracted
+         */
+        struct FirColumn {
+            unsigned int shift;
+            std::size_t first;
+            std::size_t negative;
+            std::size_t last;
+        };
+    }  // namespace detail
+
+    /**
+     * @brief Bit-exact simulation of a FIR filter with CSD coefficients
+     *
+     * Output n is `sum(c[k] * x[n - k])`, each product computed by the
+     * shift-and-add program of c[k], so it matches a hardware filter built
+     * from the same digits. Samples before the first one are zero, and the
+     * delay line carries over from one `filter` call to the next, so a
+     * long stream can be fed in pieces.
+     *
+     * As the sum is exact, the digits of all the coefficients are grouped
+     * by weight: the delayed samples of the digits of weight 2^s are added
+     * or subtracted, and the result shifted once by s. The stream is
+     * processed in blocks of `block_size` outputs, whose samples stay in L1
+     * cache, with AVX2 (when the CPU has it) or NEON across 16 to 32
+     * outputs at a time. The accumulators are 32 bits wide when
+     * `input_bits`, the largest shift and the number of digits allow it,
+     * and 64 bits wide otherwise.
+     */
+    class CsdFir {
+      public:
+        /** Outputs computed together */
+        static constexpr std::size_t block_size = 1024U;
+
+        /**
+         * @brief Filter with the given coefficients
+         *
+         * @param[in] taps - The programs of c[0], c[1], ...
+         * @param[in] format - The fixed-point format
+         * @throw std::invalid_argument if there are no taps, a width is not
+         *        1 to 32, or the total right shift is over 62
+         * @throw std::length_error if the sum may not fit in 62 bits
+         */
+        explicit CsdFir(const std::vector<ShiftAddProgram> &taps,
+                        const FirFormat &format = FirFormat());
+
+        /**
+         * @brief Filter with coefficients given as CSD strings, e.g. from `to_csdfixed`
+         *
+         * @param[in] csds - The CSD strings of c[0], c[1], ...
+         * @param[in] format - The fixed-point format
+         * @throw std::invalid_argument if an invalid character is encountered
+         * @see CsdFir(const std::vector<ShiftAddProgram> &, const FirFormat &)
+         */
+        explicit CsdFir(const std::vector<std::string> &csds,
+                        const FirFormat &format = FirFormat());
+
+        /**
+         * @brief Filter the next `n` samples of the stream
+         *
+         * The samples must fit in `input_bits`. `in` and `out` may be the
+         * same array.
+         *
+         * @param[in] in - The `n` input samples
+         * @param[out] out - Receives the `n` output samples
+         * @param[in] n - Number of samples
+         */
+        auto filter(const std::int32_t *in, std::int32_t *out, std::size_t n) -> void;
+
+        /** Clear the delay line, as before the first sample */
+        auto reset() -> void;
+
+        /** Number of taps */
+        auto num_taps() const -> std::size_t { return history_ + 1U; }
+
+        /** Common fraction of the coefficients, i.e. the right shift before `output_shift` */
+        auto frac() const -> unsigned int { return frac_; }
+
+        /** Width of the accumulators, 32 or 64 */
+        auto accumulator_bits() const -> unsigned int { return wide_ ? 64U : 32U; }
+
+      private:
+        auto quantize(std::int64_t sum) const -> std::int32_t;
+
+        FirFormat format_;
+        std::vector<detail::FirColumn> columns_;
+        std::vector<std::size_t> offsets_;
+        std::size_t history_;
+        unsigned int frac_;
+        bool wide_;
+        std::vector<std::int32_t> window_;
+        std::vector<std::int32_t> acc32_;
+        std::vector<std::int64_t> acc64_;
+    };
+
+}  // namespace csd
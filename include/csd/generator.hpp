@@ -0,0 +1,80 @@
+/// @file generator.hpp
+#pragma once
+
+namespace csd {
+
+    /**
+     * @brief A non-zero CSD digit: `sign * 2^position`
+     */
+    struct CsdDigit {
+        int position;  ///< exponent of the digit; the first fractional digit is -1
+        int sign;      ///< +1 for '+', -1 for '-'
+    };
+
+    /**
+     * @brief Lazy, resumable generator of the CSD digits of a double
+     *
+     * Yields the digits of `to_csd` from the most significant one down, with
+     * the same `det = 1.5 * decimal_value` rule, but only as far as they are
+     * asked for: the state between two calls is the residual and the current
+     * power of two, so a caller can look at the first few non-zero digits,
+     * stop, and later refine the precision without recomputing anything.
+     * `to_csd(decimal_value, places)` is exactly the digits of the positions
+     * down to `-places` (with a leading "0" when |decimal_value| < 1).
+     *
+     * Runs of zero digits are skipped in one step by `next_nonzero`: with
+     * the residual unchanged, the next non-zero digit is at the largest
+     * power of two below `det`.
+     */
+    class CsdGenerator {
+      public:
+        /**
+         * @brief Start generating the digits of `decimal_value`
+         *
+         * @param[in] decimal_value - The number to convert
+         */
+        explicit CsdGenerator(double decimal_value);
+
+        /** Exponent of the next digit to generate */
+        auto position() const -> int { return rem_ - 1; }
+
+        /** What the digits generated so far leave of the value */
+        auto residual() const -> double { return residual_; }
+
+        /** Sum of the digits generated so far (exact) */
+        auto approximation() const -> double { return value_ - residual_; }
+
+        /** Number of non-zero digits generated so far */
+        auto nonzeros() const -> unsigned int { return nnz_; }
+
+        /**
+         * @brief Generate the digit at `position()`
+         *
+         * @return +1 for '+', -1 for '-', 0 for '0'
+         */
+        auto step() -> int;
+
+        /**
+         * @brief Generate digits up to the next non-zero one at or above `lowest`
+         *
+         * If there is none, all the digits down to `lowest` have been
+         * generated (all zero) and `position()` is `lowest - 1`. The digits
+         * above `position()` are already generated, so for a `lowest` above
+         * it there is nothing to look at: it returns false and leaves
+         * `position()` unchanged.
+         *
+         * @param[in] lowest - Lowest position to look at
+         * @param[out] digit - The non-zero digit, when there is one
+         * @return Whether a non-zero digit was found
+         */
+        auto next_nonzero(int lowest, CsdDigit &digit) -> bool;
+
+      private:
+        double value_;
+        double residual_;
+        double p2n_;  ///< 2^rem_
+        int rem_;
+        unsigned int nnz_;
+    };
+
+}  // namespace csd
@@ -1,11 +1,24 @@
 /// @file lcsre.hpp
 #pragma once
 
-#include <iosfwd>  // for string
-#include <string>  // for basic_string, operator==, operator<<
+#include <cstddef>  // for size_t
+#include <iosfwd>   // for string
+#include <string>   // for basic_string, operator==, operator<<
+#include <vector>   // for vector
 
 namespace csd {
 
+    /** Algorithms available for `longest_repeated_substring` */
+    enum class LcsreEngine {
+        Auto,                ///< pick one based on the input length
+        DynamicProgramming,  ///< O(n^2) time and memory table
+        RollingRow,          ///< the same DP keeping two rows, O(n) memory
+        SuffixArray          ///< suffix array + LCP, O(n log n) time and O(n) memory
+    };
+
+    /** Input length from which `LcsreEngine::Auto` switches to the suffix array */
+    constexpr std::size_t lcsre_suffix_array_threshold = 1024U;
+
     /**
      * @brief Longest repeated non-overlapping substring
      *
@@ -22,4 +35,81 @@ namespace csd {
      */
     extern auto longest_repeated_substring(const char *sv, size_t n) -> std::string;
 
+    /**
+     * @brief Longest repeated non-overlapping substring using a given engine
+     *
+     * All engines return the same substring: among the longest repeats, the
+     * one whose first occurrence starts earliest.
+     *
+     * @param[in] sv Pointer to the input string
+     * @param[in] n The length of the input string `sv`
+     * @param[in] engine The algorithm to use
+     *
+     * @return The longest repeated non-overlapping substring of `sv`
+     */
+    extern auto longest_repeated_substring(const char *sv, size_t n, LcsreEngine engine)
+        -> std::string;
+
+    /** Where a shared pattern occurs */
+    struct PatternOccurrence {
+        std::size_t string;    ///< index of the string in the input
+        std::size_t position;  ///< index of the first character in that string
+        bool negated;          ///< whether the string holds the sign-flipped pattern there
+    };
+
+    /** A digit pattern occurring several times in a set of CSD strings */
+    struct SharedPattern {
+        std::string pattern;                         ///< the digits; its first non-zero is '+'
+        std::vector<PatternOccurrence> occurrences;  ///< sorted by string, then position
+    };
+
+    /** Ranking of the results of `shared_patterns` */
+    enum class PatternOrder {
+        Frequency,  ///< most occurrences first, then longest
+        Length,     ///< longest first, then most occurrences
+    };
+
+    /** Options of `shared_patterns` */
+    struct SharedPatternOptions {
+        std::size_t min_length = 2U;       ///< shortest pattern to report
+        std::size_t min_nonzeros = 2U;     ///< fewest non-zero digits of a reported pattern
+        std::size_t min_occurrences = 2U;  ///< fewest occurrences to report
+        std::size_t top_k = 10U;           ///< number of patterns to return, 0 for all
+        PatternOrder order = PatternOrder::Frequency;
+        bool sign_flips = true;  ///< whether P and its negation -P count as the same pattern
+    };
+
+    /**
+     * @brief The most frequent or longest digit patterns shared by a set of CSD strings
+     *
+     * Unlike concatenating the strings and calling
+     * `longest_repeated_substring`, matches never cross from one string to
+     * the next (nor across a binary point): the strings are joined with a
+     * unique separator symbol each into one generalized suffix array. With
+     * `sign_flips`, the negation of every string is added as well, so that
+     * "+0-" and "-0+" are found as one pattern, reported in the form whose
+     * first non-zero digit is '+'.
+     *
+     * The candidates are the maximal repeats, i.e. the internal nodes of
+     * the generalized suffix tree whose occurrences are not all preceded by
+     * the same digit; a pattern that can be extended on either side without
+     * losing an occurrence is only reported in its extended form.
+     * Patterns begin and end with a non-zero digit: zeros at either end are
+     * trimmed, so that "0+0-" and "+0-0" are both reported as "+0-", with
+     * all the occurrences of "+0-". Only a pattern of zeros is kept as is,
+     * which takes `min_nonzeros` of 0. Occurrences may overlap.
+     *
+     * Building the suffix array takes O(N log N) for a total length N, and
+     * finding the candidates O(N) plus sorting them. Reporting a pattern
+     * adds its length and the sorting of its occurrences, which for
+     * short frequent patterns can dominate.
+     *
+     * @param[in] csds - The CSD strings
+     * @param[in] options - Filters, ranking and number of results
+     * @return The best `options.top_k` patterns with their occurrences
+     */
+    extern auto shared_patterns(const std::vector<std::string> &csds,
+                                const SharedPatternOptions &options = SharedPatternOptions())
+        -> std::vector<SharedPattern>;
+
 }  // namespace csd
@@ -0,0 +1,116 @@
+/// @file mcm.hpp
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for int64_t
+#include <string>   // for basic_string
+#include <vector>   // for vector
+
+namespace csd {
+
+    /**
+     * @brief One adder (or subtractor) of an adder graph
+     *
+     * Computes `lhs_sign * (node[lhs] << lhs_shift) + rhs_sign * (node[rhs] << rhs_shift)`.
+     */
+    struct AdderNode {
+        std::size_t lhs;         ///< first operand node
+        unsigned int lhs_shift;  ///< left shift of the first operand
+        int lhs_sign;            ///< +1 or -1
+        std::size_t rhs;         ///< second operand node
+        unsigned int rhs_shift;  ///< left shift of the second operand
+        int rhs_sign;            ///< +1 or -1
+        std::int64_t value;      ///< the multiple of the input this node computes
+    };
+
+    /**
+     * @brief How one coefficient is read off an adder graph
+     *
+     * The coefficient is `sign * node_value(node) * 2^shift`; the shift is
+     * negative for fractional coefficients, and `sign` is 0 for a zero
+     * coefficient.
+     */
+    struct McmOutput {
+        std::size_t node;  ///< the node computing the coefficient
+        int shift;         ///< power of two applied to the node
+        int sign;          ///< +1, -1, or 0 for a zero coefficient
+    };
+
+    /**
+     * @brief Shared adder graph computing several constant multiples of one input
+     *
+     * Node 0 is the input itself (value 1) and node k >= 1 is `adders[k - 1]`,
+     * whose operands are always lower numbered nodes.
+     */
+    struct AdderGraph {
+        std::vector<AdderNode> adders;    ///< the adders, in evaluation order
+        std::vector<McmOutput> outputs;  ///< one entry per coefficient
+    };
+
+    /**
+     * @brief The multiple of the input computed by a node
+     *
+     * @param[in] graph - The adder graph
+     * @param[in] node - The node index (0 for the input)
+     * @return The value of the node
+     */
+    inline auto node_value(const AdderGraph &graph, std::size_t node) -> std::int64_t {
+        return node == 0U ? 1 : graph.adders[node - 1U].value;
+    }
+
+    /**
+     * @brief Number of adders (and subtractors) of an adder graph
+     */
+    inline auto adder_count(const AdderGraph &graph) -> std::size_t { return graph.adders.size(); }
+
+    /**
+     * @brief The coefficient produced by one output of an adder graph
+     *
+     * @param[in] graph - The adder graph
+     * @param[in] output - The output index
+     * @return The exact coefficient (as long as it fits a double)
+     */
+    extern auto output_value(const AdderGraph &graph, std::size_t output) -> double;
+
+    /**
+     * @brief Multiple constant multiplication of CSD coefficients
+     *
+     * Builds one adder graph multiplying an input by all the given CSD
+     * constants, sharing common subexpressions between them:
+     *
+     * 1. every coefficient is reduced to an odd fundamental, so that equal
+     *    coefficients and coefficients differing by a sign or a power of two
+     *    share the same node;
+     * 2. long common digit patterns (three or more non-zero digits) are found
+     *    with `shared_patterns` over all the digit strings, and their
+     *    negations, and replaced by a single shared node, the most non-zero
+     *    digits first (patterns may in turn contain patterns);
+     * 3. the remaining common pairs of non-zero digits are extracted greedily,
+     *    most frequent first (Hartley's method);
+     * 4. the remaining terms of every node are summed with a balanced tree.
+     *
+     * Each extracted pattern of k digits with m occurrences saves
+     * (m - 1)(k - 1) adders compared to implementing the CSD digits directly.
+     *
+     * @param[in] csds - The coefficients as CSD strings
+     * @return The adder graph, with one output per coefficient
+     * @throw std::invalid_argument if an invalid character is encountered
+     * @throw std::length_error if a coefficient spans more than 62 digits
+     */
+    extern auto mcm_adder_graph(const std::vector<std::string> &csds) -> AdderGraph;
+
+    /**
+     * @brief Multiple constant multiplication of quantized coefficients
+     *
+     * Every coefficient is converted with `to_csdfixed(coefficient, nnz)`
+     * and the resulting CSD strings are passed to
+     * `mcm_adder_graph(const std::vector<std::string> &)`.
+     *
+     * @param[in] coefficients - The coefficients
+     * @param[in] nnz - The maximum number of non-zero digits per coefficient
+     * @return The adder graph, with one output per coefficient
+     */
+    extern auto mcm_adder_graph(const std::vector<double> &coefficients, unsigned int nnz)
+        -> AdderGraph;
+
+}  // namespace csd
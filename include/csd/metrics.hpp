@@ -0,0 +1,169 @@
+/// @file metrics.hpp
+#pragma once
+
+#include <chrono>   // for steady_clock, nanoseconds, duration_cast
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint64_t
+#include <string>   // for basic_string
+
+/**
+ * Define `CSD_ENABLE_METRICS` to 1 when building the library (the CMake
+ * option of the same name does so) to count the conversion calls. By
+ * default, and in a `CSD_HEADER_ONLY` build, the hooks are empty inline
+ * functions and cost nothing.
+ */
+#ifndef CSD_ENABLE_METRICS
+#    define CSD_ENABLE_METRICS 0
+#endif
+
+// A CSD_HEADER_ONLY build has no library to hold the counters
+#ifdef CSD_HEADER_ONLY
+#    undef CSD_ENABLE_METRICS
+#    define CSD_ENABLE_METRICS 0
+#endif
+
+namespace csd {
+
+    /**
+     * @brief The instrumented entry points
+     *
+     * The size of a call is the length of the result for the conversions,
+     * the number of strings for a batch and the input length for lcsre.
+     */
+    enum class MetricFunction : unsigned int {
+        ToCsd,           ///< `to_csd`
+        ToCsdFixed,      ///< `to_csdfixed`
+        ToDecimalBatch,  ///< `to_decimal_batch`, the runtime entry of `to_decimal`
+        Lcsre,           ///< `longest_repeated_substring`
+    };
+
+    /** Number of `MetricFunction` values */
+    constexpr std::size_t metric_functions = 4U;
+
+    /** Number of buckets of a histogram */
+    constexpr std::size_t metric_buckets = 32U;
+
+    /**
+     * @brief What the calls of one function have seen
+     *
+     * Both histograms have power-of-two buckets: bucket 0 counts the value
+     * 0 and bucket b > 0 the values in [2^(b-1), 2^b), the last bucket
+     * taking everything above.
+     */
+    struct FunctionMetrics {
+        std::uint64_t calls;            ///< number of calls
+        std::uint64_t nanoseconds;      ///< time spent in all the calls
+        std::uint64_t max_nanoseconds;  ///< the slowest call
+        std::uint64_t table_bytes;      ///< working memory allocated, summed over the calls
+        std::uint64_t sizes[metric_buckets];      ///< calls by size, see `MetricFunction`
+        std::uint64_t latencies[metric_buckets];  ///< calls by nanoseconds
+    };
+
+    /**
+     * @brief The counters of all the threads, added up
+     */
+    struct MetricsSnapshot {
+        FunctionMetrics functions[metric_functions];
+
+        auto operator[](MetricFunction function) const -> const FunctionMetrics & {
+            return functions[static_cast<std::size_t>(function)];
+        }
+    };
+
+    /** Whether the library was built with `CSD_ENABLE_METRICS` */
+    extern auto metrics_available() -> bool;
+
+    /** Name of the instrumented function, e.g. "to_csd" */
+    extern auto metric_name(MetricFunction function) -> const char *;
+
+    /**
+     * @brief Add up the counters of the running threads and the finished ones
+     *
+     * Every thread updates its own counters without synchronization, so
+     * calls in flight on other threads may or may not be included.
+     */
+    extern auto metrics_snapshot() -> MetricsSnapshot;
+
+    /**
+     * @brief Set all the counters to zero
+     *
+     * Safe while other threads are counting: they zero their own counters
+     * on their next call, so a call in flight may or may not be included
+     * in the following snapshots.
+     */
+    extern auto reset_metrics() -> void;
+
+    /**
+     * @brief Latency below which the fraction `q` of the calls fall
+     *
+     * @param[in] metrics - The counters of one function
+     * @param[in] q - The quantile, e.g. 0.99
+     * @return The upper bound of the latency bucket holding the quantile, in nanoseconds
+     */
+    extern auto latency_percentile(const FunctionMetrics &metrics, double q) -> std::uint64_t;
+
+    /**
+     * @brief One line per function of `name key=value ...` pairs
+     */
+    extern auto format_metrics(const MetricsSnapshot &snapshot) -> std::string;
+
+    namespace detail {
+        /** Add one call to the counters of the calling thread */
+        extern auto record_metric(MetricFunction function, std::uint64_t nanoseconds,
+                                  std::size_t size, std::size_t table_bytes) -> void;
+
+        // Each setting has an inline namespace of its own, so that translation
+        // units built with and without metrics never share a ScopedMetric
+#if CSD_ENABLE_METRICS
+        inline namespace metrics_enabled {
+            /**
+             * @brief Times the enclosing scope and records it as one call
+             */
+            class ScopedMetric {
+              public:
+                explicit ScopedMetric(MetricFunction function)
+                    : function_(function),
+                      size_(0U),
+                      table_bytes_(0U),
+                      start_(std::chrono::steady_clock::now()) {}
+
+                ScopedMetric(const ScopedMetric &) = delete;
+                auto operator=(const ScopedMetric &) -> ScopedMetric & = delete;
+
+                ~ScopedMetric() {
+                    auto const elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - start_);
+                    record_metric(function_, static_cast<std::uint64_t>(elapsed.count()), size_,
+                                  table_bytes_);
+                }
+
+                /** Size of the call, see `MetricFunction` */
+                auto set_size(std::size_t size) -> void { size_ = size; }
+
+                /** Working memory of the call */
+                auto set_table_bytes(std::size_t bytes) -> void { table_bytes_ = bytes; }
+
+              private:
+                MetricFunction function_;
+                std::size_t size_;
+                std::size_t table_bytes_;
+                std::chrono::steady_clock::time_point start_;
+            };
+        }  // namespace metrics_enabled
+#else
+        inline namespace metrics_disabled {
+            class ScopedMetric {
+              public:
+                explicit ScopedMetric(MetricFunction /* function */) {}
+
+                ScopedMetric(const ScopedMetric &) = delete;
+                auto operator=(const ScopedMetric &) -> ScopedMetric & = delete;
+
+                auto set_size(std::size_t /* size */) -> void {}
+                auto set_table_bytes(std::size_t /* bytes */) -> void {}
+            };
+        }  // namespace metrics_disabled
+#endif
+    }  // namespace detail
+
+}  // namespace csd
@@ -0,0 +1,117 @@
+/// @file msd.hpp
+#pragma once
+
+#include <cstdint>  // for int64_t, uint64_t
+#include <vector>   // for vector
+
+#include "packed.hpp"  // for PackedCsd
+
+namespace csd {
+
+    /** Largest magnitude accepted by the MSD functions */
+    constexpr std::int64_t msd_max_magnitude = std::int64_t{1} << 62;
+
+    /**
+     * @brief Number of non-zero digits of the minimal signed-digit forms of `value`
+     *
+     * It is the weight of the CSD, read off the x ^ 3x masks.
+     *
+     * @param[in] value - The integer, |value| <= `msd_max_magnitude`
+     */
+    CONSTEXPR14 auto msd_weight(std::int64_t value) -> unsigned int {
+        return num_nonzeros(to_csd_i_packed(value));
+    }
+
+    /**
+     * @brief Lazy enumerator of all the minimal signed-digit (MSD) forms of a number
+     *
+     * A signed-digit form is minimal when no other one has fewer non-zero
+     * digits; the CSD is the one without adjacent non-zero digits, but e.g.
+     * 3 is both "+0-" and "++". The forms are generated from the least
+     * significant digit up: an even rest takes a '0', and an odd rest n a
+     * '+' (leaving (n - 1) / 2) or a '-' (leaving (n + 1) / 2), each kept
+     * only if the rest can still be written with one digit less. Every
+     * form is thus one path of choices, so none is produced twice, and no
+     * path is abandoned halfway. The first form produced is the
+     * non-adjacent form, i.e. `to_csd_i_packed` for an integer.
+     *
+     * Each form's length is that of its highest non-zero digit, like
+     * `to_csd_i_packed`; the fixed-point forms also have the binary point
+     * and at least one integral digit, like `to_csd_packed`.
+     */
+    class MsdEnumerator {
+      public:
+        /**
+         * @brief Enumerate the MSD forms of an integer
+         *
+         * @param[in] value - The integer, |value| <= `msd_max_magnitude`
+         * @throw std::length_error if the value is too large
+         */
+        explicit MsdEnumerator(std::int64_t value);
+
+        /**
+         * @brief Enumerate the MSD forms of the value of `to_csd(decimal_value, places)`
+         *
+         * These may have integral digits when |decimal_value| < 1, where
+         * `to_csd` has none, e.g. "+.0-" besides "0.++" for 0.75.
+         *
+         * @param[in] decimal_value - The number, quantized as by `to_csd`
+         * @param[in] places - The number of digits after the binary point
+         * @throw std::length_error if the forms would need more than 63 digits
+         */
+        MsdEnumerator(double decimal_value, int places);
+
+        /**
+         * @brief Produce the next form
+         *
+         * @param[out] msd - The form, when there is one
+         * @return Whether there was one left
+         */
+        auto next(PackedCsd &msd) -> bool;
+
+        /** Number of non-zero digits of every form */
+        auto weight() const -> unsigned int { return weight_; }
+
+      private:
+        /** A partial form: the digits below `position`, and the value left above them */
+        struct Branch {
+            std::int64_t rest;
+            std::uint64_t pos;
+            std::uint64_t neg;
+            unsigned int position;
+        };
+
+        std::vector<Branch> pending_;
+        unsigned int weight_;
+        unsigned int frac_;
+        bool has_point_;
+    };
+
+    /**
+     * @brief Number of MSD forms of an integer, without enumerating them
+     *
+     * The rests after k digits are always floor(value / 2^k) or one more,
+     * so memoizing two counts per digit takes O(log |value|) steps.
+     *
+     * @param[in] value - The integer, |value| <= `msd_max_magnitude`
+     * @throw std::length_error if the value is too large
+     */
+    extern auto msd_count(std::int64_t value) -> std::uint64_t;
+
+    /**
+     * @brief All the MSD forms of an integer, the CSD first
+     *
+     * @see MsdEnumerator
+     */
+    extern auto to_msd_all(std::int64_t value) -> std::vector<PackedCsd>;
+
+    /**
+     * @brief All the MSD forms of the value of `to_csd(decimal_value, places)`
+     *
+     * The non-adjacent form comes first.
+     *
+     * @see MsdEnumerator
+     */
+    extern auto to_msd_all(double decimal_value, int places) -> std::vector<PackedCsd>;
+
+}  // namespace csd
@@ -0,0 +1,280 @@
+/// @file packed.hpp
+#pragma once
+
+#include <cmath>      // for ldexp
+#include <cstdint>    // for uint64_t, uint32_t, int64_t
+#include <stdexcept>  // for length_error
+#include <string>     // for basic_string
+
+#include "csd.hpp"  // for CONSTEXPR14, CSD_INLINE, CSD_BEGIN_INLINE_NAMESPACE
+
+namespace csd {
+
+    /** Maximum number of digits a PackedCsd can hold */
+    constexpr unsigned int packed_max_digits = 64U;
+
+    /**
+     * @brief Packed binary representation of a CSD number
+     *
+     * The digits are kept in two bit masks, one for the '+' digits and one for
+     * the '-' digits, so that no heap memory is needed and each digit costs two
+     * bits. Bit 0 corresponds to the last (least significant) digit of the
+     * string form.
+     *
+     * `length` counts all digits (the binary point is not a digit), `frac`
+     * counts the digits after the binary point, and `has_point` records whether
+     * the string form contains a '.' at all. Together they make the conversion
+     * to and from the string format exact, e.g. "+00-00.+0" is stored as
+     * pos = 0b10000010, neg = 0b00010000, length = 8, frac = 2.
+     */
+    struct PackedCsd {
+        std::uint64_t pos;   ///< mask of the '+' digits
+        std::uint64_t neg;   ///< mask of the '-' digits
+        unsigned int length; ///< number of digits
+        unsigned int frac;   ///< number of digits after the binary point
+        bool has_point;      ///< whether the string form contains a '.'
+
+        /**
+         * @brief Construct an empty PackedCsd (no digits, no binary point)
+         */
+        constexpr PackedCsd() : pos{0U}, neg{0U}, length{0U}, frac{0U}, has_point{false} {}
+
+        /**
+         * @brief Construct a PackedCsd from its digit masks
+         *
+         * @param[in] pos - mask of the '+' digits
+         * @param[in] neg - mask of the '-' digits
+         * @param[in] length - number of digits
+         * @param[in] frac - number of digits after the binary point
+         * @param[in] has_point - whether the string form contains a '.'
+         */
+        constexpr PackedCsd(std::uint64_t pos, std::uint64_t neg, unsigned int length,
+                            unsigned int frac = 0U, bool has_point = false)
+            : pos{pos}, neg{neg}, length{length}, frac{frac}, has_point{has_point} {}
+
+        constexpr auto operator==(const PackedCsd &other) const -> bool {
+            return pos == other.pos && neg == other.neg && length == other.length
+                   && frac == other.frac && has_point == other.has_point;
+        }
+
+        constexpr auto operator!=(const PackedCsd &other) const -> bool {
+            return !(*this == other);
+        }
+    };
+
+    CSD_BEGIN_INLINE_NAMESPACE
+
+    /**
+     * @brief Convert a CSD string to its packed representation
+     *
+     * The string is validated the same way as in `to_decimal`.
+     *
+     * @param[in] csd - Pointer to the null-terminated CSD string
+     * @return The packed representation of the CSD string
+     * @throw std::invalid_argument if an invalid character is encountered
+     * @throw std::length_error if the string has more than 64 digits
+     */
+    CSD_INLINE auto to_packed(const char *csd) -> PackedCsd;
+
+    /**
+     * @brief Convert a packed CSD number back to the string format
+     *
+     * @param[in] csd - The packed CSD number
+     * @return String representation in CSD format
+     */
+    CSD_INLINE auto to_string(const PackedCsd &csd) -> std::string;
+
+    /**
+     * @brief Convert a double to packed CSD format with a specified number of places
+     *
+     * Produces the same digits as `to_csd` without building a string.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] places - The number of decimal places to include in the CSD representation.
+     * @return Packed representation of the input number in CSD format.
+     * @throw std::length_error if the result has more than 64 digits
+     */
+    CSD_INLINE auto to_csd_packed(double decimal_value, int places) -> PackedCsd;
+    CSD_END_INLINE_NAMESPACE
+
+    /**
+     * @brief Number of significant bits of an unsigned 64-bit integer
+     *
+     * @param[in] x - The integer
+     * @return The position of the highest set bit plus one, or 0 if `x` is 0
+     */
+    constexpr auto bit_length(std::uint64_t x) -> unsigned int {
+#if defined(__GNUC__) || defined(__clang__)
+        return x == 0U ? 0U : 64U - static_cast<unsigned int>(__builtin_clzll(x));
+#else
+        return x == 0U ? 0U : 1U + bit_length(x >> 1);
+#endif
+    }
+
+    namespace detail {
+        /**
+         * @brief Assemble the CSD of a magnitude from x >> 1 and 3x >> 1
+         *
+         * With xh = x >> 1 and x3 = x + xh, the bits where xh and x3 differ are
+         * exactly the non-zero digits of the non-adjacent form (i.e. the CSD) of
+         * x: a '+' where x3 has a one and a '-' where xh has a one. There are no
+         * carries to propagate digit by digit, so the whole encoding takes a
+         * handful of ALU operations.
+         */
+        constexpr auto naf_packed(std::uint64_t xh, std::uint64_t x3, bool negative)
+            -> PackedCsd {
+            return negative ? PackedCsd(xh & (xh ^ x3), x3 & (xh ^ x3),
+                                        x3 == 0U ? 1U : bit_length(xh ^ x3))
+                            : PackedCsd(x3 & (xh ^ x3), xh & (xh ^ x3),
+                                        x3 == 0U ? 1U : bit_length(xh ^ x3));
+        }
+
+        constexpr auto naf_packed(std::uint64_t magnitude, bool negative) -> PackedCsd {
+            return naf_packed(magnitude >> 1, magnitude + (magnitude >> 1), negative);
+        }
+
+        /**
+         * @brief Report a result of more than 64 digits
+         *
+         * A function rather than a throw expression, so that the C++11
+         * constexpr conditional still has a branch when exceptions are off.
+         */
+        [[noreturn]] inline auto packed_overflow() -> PackedCsd {
+            CSD_THROW(std::length_error("CSD number exceeds 64 digits"));
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Convert a 64-bit integer to packed CSD format
+     *
+     * Branch-free: the digit masks are computed from x and 3x in constant
+     * time. Every `int64_t` (including INT64_MIN) fits in 64 digits.
+     *
+     * @param[in] decimal_value - The integer to convert to CSD format.
+     * @return Packed representation of the input integer in CSD format.
+     */
+    constexpr auto to_csd_i_packed(std::int64_t decimal_value) -> PackedCsd {
+        return detail::naf_packed(decimal_value < 0 ? 0U - static_cast<std::uint64_t>(decimal_value)
+                                                    : static_cast<std::uint64_t>(decimal_value),
+                                  decimal_value < 0);
+    }
+
+    /**
+     * @brief Convert an unsigned 64-bit integer to packed CSD format
+     *
+     * Values above 2^65 / 3 need 65 CSD digits and are rejected.
+     *
+     * @param[in] decimal_value - The integer to convert to CSD format.
+     * @return Packed representation of the input integer in CSD format.
+     * @throw std::length_error if the result has more than 64 digits
+     */
+    constexpr auto to_csd_i_packed(std::uint64_t decimal_value) -> PackedCsd {
+        return decimal_value + (decimal_value >> 1) < decimal_value
+                   ? detail::packed_overflow()
+                   : detail::naf_packed(decimal_value, false);
+    }
+
+    /**
+     * @brief Convert an integer to packed CSD format
+     *
+     * Produces the same digits as `to_csd_i` without building a string.
+     *
+     * @param[in] decimal_value - The integer to convert to CSD format.
+     * @return Packed representation of the input integer in CSD format.
+     */
+    constexpr auto to_csd_i_packed(int decimal_value) -> PackedCsd {
+        return to_csd_i_packed(static_cast<std::int64_t>(decimal_value));
+    }
+
+    CSD_BEGIN_INLINE_NAMESPACE
+    /**
+     * @brief Convert a double to packed CSD format with a fixed number of non-zero digits
+     *
+     * Produces the same digits as `to_csdfixed` without building a string.
+     *
+     * @param[in] decimal_value - The number to convert to CSD format.
+     * @param[in] nnz - The maximum number of non-zero digits allowed in the CSD representation.
+     * @return Packed representation of the input number in CSD format.
+     * @throw std::length_error if the result has more than 64 digits
+     */
+    CSD_INLINE auto to_csdfixed_packed(double decimal_value, unsigned int nnz) -> PackedCsd;
+    CSD_END_INLINE_NAMESPACE
+
+    /**
+     * @brief Number of non-zero digits of a packed CSD number
+     *
+     * @param[in] csd - The packed CSD number
+     * @return The number of '+' and '-' digits
+     */
+    CONSTEXPR14 auto num_nonzeros(const PackedCsd &csd) -> unsigned int {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_popcountll(csd.pos | csd.neg));
+#else
+        auto count = 0U;
+        for (auto mask = csd.pos | csd.neg; mask != 0U; mask &= mask - 1U) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+    /**
+     * @brief Convert the integral part of a packed CSD number to a decimal
+     *
+     * The digits before the binary point are a plain signed binary number,
+     * so the result is just the difference of the shifted masks. As with the
+     * string version, the result is accumulated in an `int`.
+     *
+     * @param[in] csd - The packed CSD number
+     * @return The decimal value of the integral part
+     */
+    CONSTEXPR14 auto to_decimal_integral(const PackedCsd &csd) -> int {
+        return csd.frac >= packed_max_digits
+                   ? 0
+                   : static_cast<int>(
+                         static_cast<std::uint32_t>((csd.pos >> csd.frac) - (csd.neg >> csd.frac)));
+    }
+
+    /**
+     * @brief Convert the fractional part of a packed CSD number to a decimal
+     *
+     * The result is exact (and identical to the string version) for up to 53
+     * fractional digits.
+     *
+     * @param[in] csd - The packed CSD number
+     * @return The decimal value of the fractional part
+     */
+    inline auto to_decimal_fractional(const PackedCsd &csd) -> double {
+        auto const mask = csd.frac >= packed_max_digits ? ~std::uint64_t{0U}
+                                                        : (std::uint64_t{1U} << csd.frac) - 1U;
+        auto const value = static_cast<std::int64_t>((csd.pos & mask) - (csd.neg & mask));
+        return std::ldexp(static_cast<double>(value), -static_cast<int>(csd.frac));
+    }
+
+    /**
+     * @brief Convert a packed CSD number to a decimal
+     *
+     * @param[in] csd - The packed CSD number
+     * @return The decimal value of the CSD number
+     */
+    inline auto to_decimal(const PackedCsd &csd) -> double {
+        auto integral = to_decimal_integral(csd);
+        if (!csd.has_point) {
+            return double(integral);
+        }
+        return double(integral) + to_decimal_fractional(csd);
+    }
+
+    /**
+     * @brief Convert a packed CSD number to an integer
+     *
+     * @param[in] csd - The packed CSD number
+     * @return int decimal value of the integral part
+     */
+    CONSTEXPR14 auto to_decimal_i(const PackedCsd &csd) -> int { return to_decimal_integral(csd); }
+
+}  // namespace csd
+
+#ifdef CSD_HEADER_ONLY
+#    include "packed_impl.hpp"
+#endif
@@ -0,0 +1,80 @@
+/// @file packed_impl.hpp
+#pragma once
+
+#include <cstdint>    // for uint64_t
+#include <stdexcept>  // for invalid_argument, length_error
+#include <string>     // for basic_string
+
+#include "packed.hpp"  // for PackedCsd, packed_max_digits, CSD_BEGIN_INLINE_NAMESPACE
+
+// Compiled once by source/packed.cpp, or included by packed.hpp into every
+// translation unit of a CSD_HEADER_ONLY build.
+
+namespace csd {
+    CSD_BEGIN_INLINE_NAMESPACE
+    /**
+     * @brief Convert a CSD string to its packed representation
+     *
+     * The digits are shifted in one at a time, so the first character ends up
+     * as the most significant bit. The integral part accepts '0', '+', '-' and
+     * a single '.', the fractional part only '0', '+' and '-', with the same
+     * error messages as `to_decimal`.
+     *
+     * @param[in] csd - Pointer to the null-terminated CSD string
+     * @return The packed representation of the CSD string
+     */
+    auto to_packed(const char *csd) -> PackedCsd {
+        PackedCsd result{};
+        for (; *csd != '\0'; ++csd) {
+            auto const digit = *csd;
+            if (digit == '.' && !result.has_point) {
+                result.has_point = true;
+                continue;
+            }
+            if (digit != '0' && digit != '+' && digit != '-') {
+                if (result.has_point) {
+                    CSD_THROW(std::invalid_argument("Fractional part work with 0, +, and - only"));
+                }
+                CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
+            }
+            if (result.length == packed_max_digits) {
+                CSD_THROW(std::length_error("CSD number exceeds 64 digits"));
+            }
+            result.pos = (result.pos << 1) | std::uint64_t(digit == '+');
+            result.neg = (result.neg << 1) | std::uint64_t(digit == '-');
+            ++result.length;
+            if (result.has_point) {
+                ++result.frac;
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief Convert a packed CSD number back to the string format
+     *
+     * @param[in] csd - The packed CSD number
+     * @return String representation in CSD format
+     */
+    auto to_string(const PackedCsd &csd) -> std::string {
+        auto res = std::string(csd.length + (csd.has_point ? 1U : 0U), '0');
+        auto out = res.begin();
+        for (auto i = csd.length; i != 0U; --i) {
+            if (csd.has_point && i == csd.frac) {
+                *out++ = '.';
+            }
+            auto const bit = std::uint64_t{1U} << (i - 1U);
+            if ((csd.pos & bit) != 0U) {
+                *out = '+';
+            } else if ((csd.neg & bit) != 0U) {
+                *out = '-';
+            }
+            ++out;
+        }
+        if (csd.has_point && csd.frac == 0U) {
+            *out = '.';
+        }
+        return res;
+    }
+    CSD_END_INLINE_NAMESPACE
+}  // namespace csd
@@ -0,0 +1,75 @@
+/// @file parallel.hpp
+#pragma once
+
+#include <cstddef>  // for size_t
+
+#include "string_table.hpp"  // for CsdStringTable
+
+namespace csd {
+
+    // The ranges run on a pool of threads started on the first call and
+    // shared by all the calls, with the calling thread taking its share.
+
+    /**
+     * @brief Convert an array of doubles to CSD strings on several threads
+     *
+     * The array is split into one contiguous range per thread. The exact
+     * length of every result is computed first, so all the strings are then
+     * written in place into a single preallocated buffer, without any
+     * allocation per element or shared state between the threads. The
+     * buffer is not zeroed first: every range writes its own part.
+     *
+     * @param[in] values - The `n` numbers to convert
+     * @param[in] n - Number of values
+     * @param[in] places - The number of decimal places, as for `to_csd`
+     * @param[in] threads - Number of threads, or 0 for the hardware concurrency
+     * @return The `n` CSD strings, the same as `to_csd` on every value
+     */
+    extern auto to_csd_parallel(const double *values, std::size_t n, int places,
+                                unsigned int threads = 0U) -> CsdStringTable;
+
+    /**
+     * @brief Convert an array of doubles to CSD strings with a fixed number
+     * of non-zero digits on several threads
+     *
+     * Every thread appends its results to a buffer of its own, and the
+     * buffers are then copied (again in parallel) into the single output
+     * buffer.
+     *
+     * @param[in] values - The `n` numbers to convert
+     * @param[in] n - Number of values
+     * @param[in] nnz - The maximum number of non-zero digits, as for `to_csdfixed`
+     * @param[in] threads - Number of threads, or 0 for the hardware concurrency
+     * @return The `n` CSD strings, the same as `to_csdfixed` on every value
+     */
+    extern auto to_csdfixed_parallel(const double *values, std::size_t n, unsigned int nnz,
+                                     unsigned int threads = 0U) -> CsdStringTable;
+
+    /**
+     * @brief Convert an array of CSD strings to decimals on several threads
+     *
+     * Each thread runs `to_decimal_batch` on its own range. If conversions
+     * fail, the exception of the first failing range is rethrown once all the
+     * threads are done.
+     *
+     * @param[in] csd - Array of `n` null-terminated CSD strings
+     * @param[in] n - Number of strings
+     * @param[out] out - Array receiving the `n` decimal values
+     * @param[in] threads - Number of threads, or 0 for the hardware concurrency
+     * @throw std::invalid_argument if an invalid character is encountered
+     */
+    extern auto to_decimal_parallel(const char *const *csd, std::size_t n, double *out,
+                                    unsigned int threads = 0U) -> void;
+
+    /**
+     * @brief Convert a table of CSD strings to decimals on several threads
+     *
+     * @param[in] csd - The CSD strings
+     * @param[out] out - Array receiving the `csd.size()` decimal values
+     * @param[in] threads - Number of threads, or 0 for the hardware concurrency
+     * @see to_decimal_parallel(const char *const *, std::size_t, double *, unsigned int)
+     */
+    extern auto to_decimal_parallel(const CsdStringTable &csd, double *out,
+                                    unsigned int threads = 0U) -> void;
+
+}  // namespace csd
@@ -0,0 +1,98 @@
+/// @file quantize.hpp
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for basic_string
+
+namespace csd {
+
+    /**
+     * @brief Best approximation with at most `nnz` non-zero digits and `places` fractional digits
+     *
+     * Unlike `to_csdfixed`, which keeps the first `nnz` non-zero digits of the
+     * expansion, this finds the value closest to `decimal_value` among all
+     * the multiples of 2^-places whose CSD form has at most `nnz` non-zero
+     * digits. As CSD has the fewest non-zero digits of all signed-digit forms,
+     * these are also all the values with such an MSD (minimal signed digit)
+     * form.
+     *
+     * The search is a depth-first branch and bound over non-adjacent forms:
+     * the leading digit of the best approximation of r is ±2^e with e within
+     * one of floor(log2 |r|), and the rest is the best approximation of the
+     * remainder with one digit less and exponents at most e - 2. A branch is
+     * cut as soon as even the largest value its exponents can reach leaves a
+     * larger error than the best found so far. Ties go to the value with
+     * fewer non-zero digits.
+     *
+     * @param[in] decimal_value - The number to quantize
+     * @param[in] nnz - The maximum number of non-zero digits
+     * @param[in] places - The number of fractional digits
+     * @return The best approximation
+     * @throw std::invalid_argument if `decimal_value * 2^places` is not finite
+     */
+    extern auto quantize(double decimal_value, unsigned int nnz, unsigned int places) -> double;
+
+    /**
+     * @brief `quantize` over an array
+     *
+     * @param[in] values - The `n` numbers to quantize
+     * @param[in] n - Number of values
+     * @param[in] nnz - The maximum number of non-zero digits
+     * @param[in] places - The number of fractional digits
+     * @param[out] out - Receives the `n` approximations; may be `values`
+     */
+    extern auto quantize(const double *values, std::size_t n, unsigned int nnz,
+                         unsigned int places, double *out) -> void;
+
+    /**
+     * @brief The CSD form of the best approximation
+     *
+     * The layout is that of `to_csd`: the integral digits (or "0"), a '.'
+     * and exactly `places` fractional digits, e.g. "+0-000.00" for 23.0 with
+     * two non-zero digits and two places. The digits are canonical, so there
+     * are at most `nnz` non-zero ones; for |value| < 1 this may differ from
+     * `to_csd`, which never gives such values an integral digit.
+     *
+     * @param[in] decimal_value - The number to quantize
+     * @param[in] nnz - The maximum number of non-zero digits
+     * @param[in] places - The number of fractional digits
+     * @return The CSD string of `quantize(decimal_value, nnz, places)`
+     */
+    extern auto to_csd_optimal(double decimal_value, unsigned int nnz, unsigned int places)
+        -> std::string;
+
+    /**
+     * @brief The values of `to_csdfixed(decimal_value, k)` for all k up to `max_nnz`
+     *
+     * `to_csdfixed` with k non-zero digits keeps the first k non-zero
+     * digits of one greedy expansion, so a single `CsdGenerator` run gives
+     * all of them: entry k - 1 is the sum of the first k digits, i.e.
+     * `to_decimal(to_csdfixed(decimal_value, k).c_str())`, without building
+     * or parsing any string. Once the expansion runs out, the remaining
+     * entries repeat the exact value.
+     *
+     * @param[in] decimal_value - The number to quantize
+     * @param[in] max_nnz - The largest number of non-zero digits
+     * @param[out] quantized - Receives the `max_nnz` approximations
+     * @param[out] errors - Receives `quantized[k] - decimal_value` for every
+     *                      entry, unless it is null
+     */
+    extern auto csdfixed_sweep(double decimal_value, unsigned int max_nnz, double *quantized,
+                               double *errors = nullptr) -> void;
+
+    /**
+     * @brief `csdfixed_sweep` over an array
+     *
+     * The results of value i are entries `i * max_nnz` to
+     * `(i + 1) * max_nnz - 1` of `quantized` and of `errors`.
+     *
+     * @param[in] values - The `n` numbers to quantize
+     * @param[in] n - Number of values
+     * @param[in] max_nnz - The largest number of non-zero digits
+     * @param[out] quantized - Receives the `n * max_nnz` approximations
+     * @param[out] errors - Receives the `n * max_nnz` errors, unless it is null
+     */
+    extern auto csdfixed_sweep(const double *values, std::size_t n, unsigned int max_nnz,
+                               double *quantized, double *errors = nullptr) -> void;
+
+}  // namespace csd
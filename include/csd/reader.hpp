@@ -0,0 +1,99 @@
+/// @file reader.hpp
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <string>   // for basic_string
+#include <vector>   // for vector
+
+#include "csd.hpp"  // for CSD_HAS_STRING_VIEW
+
+namespace csd {
+
+    /**
+     * @brief Read-only view of a whole file
+     *
+     * The file is memory-mapped (`mmap` on POSIX, a file mapping on Windows),
+     * so the pages are read by the kernel as they are touched and nothing is
+     * copied. Where mapping is not available, or fails, the file is read
+     * into a buffer instead.
+     */
+    class MappedFile {
+      public:
+        /**
+         * @brief Map a file
+         *
+         * @param[in] path - The file to map
+         * @throw std::runtime_error if the file cannot be opened or read
+         */
+        explicit MappedFile(const std::string &path);
+        ~MappedFile();
+
+        MappedFile(MappedFile &&other) noexcept;
+        auto operator=(MappedFile &&other) noexcept -> MappedFile &;
+        MappedFile(const MappedFile &) = delete;
+        auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+        /** The contents; not null-terminated */
+        auto data() const -> const char * { return data_; }
+
+        /** Number of bytes */
+        auto size() const -> std::size_t { return size_; }
+
+      private:
+        auto release() -> void;
+
+        const char *data_;
+        std::size_t size_;
+        bool mapped_;  ///< whether `data_` is a mapping rather than `buffer_`
+        std::vector<char> buffer_;
+    };
+
+    /**
+     * @brief Decode every CSD field of a text buffer
+     *
+     * Fields are separated by `delimiter` or by line breaks; blanks and tabs
+     * around a field, a '\r' before the '\n', and empty fields are ignored.
+     * The boundaries are found with `memchr`, which the C library scans a
+     * vector register at a time, and the fields are handed to
+     * `to_decimal_batch` as slices of the buffer, so nothing is copied. The
+     * values are those of `to_decimal` on each field, except that a '\0'
+     * inside a field is an invalid character rather than its end.
+     *
+     * @param[in] first - Start of the text
+     * @param[in] last - End of the text; no null terminator is needed
+     * @param[in] delimiter - The field separator within a line
+     * @param[out] out - The values are appended to it, in the order of the fields
+     * @param[in] first_line - The number of the line at `first`, for the error messages
+     * @return The number of values appended
+     * @throw std::invalid_argument if a field is not a CSD number, with the
+     *        message of `to_decimal` prefixed by "line <n>: "; `out` is then
+     *        left as it was
+     */
+    extern auto decode_csd_text(const char *first, const char *last, char delimiter,
+                                std::vector<double> &out, std::size_t first_line = 1U)
+        -> std::size_t;
+
+#ifdef CSD_HAS_STRING_VIEW
+    /**
+     * @brief `decode_csd_text(first, last, delimiter, out, first_line)` over a string view
+     */
+    inline auto decode_csd_text(std::string_view text, char delimiter, std::vector<double> &out,
+                                std::size_t first_line = 1U) -> std::size_t {
+        return decode_csd_text(text.data(), text.data() + text.size(), delimiter, out,
+                               first_line);
+    }
+#endif
+
+    /**
+     * @brief Decode every CSD field of a file into a contiguous array
+     *
+     * @param[in] path - The file, mapped with `MappedFile`
+     * @param[in] delimiter - The field separator within a line
+     * @return The values of the fields, as for `decode_csd_text`
+     * @throw std::runtime_error if the file cannot be read
+     * @throw std::invalid_argument if a field is not a CSD number
+     */
+    extern auto read_csd_file(const std::string &path, char delimiter = ',')
+        -> std::vector<double>;
+
+}  // namespace csd
@@ -0,0 +1,86 @@
+/// @file serialize.hpp
+#pragma once
+
+#include <cstddef>  // for size_t
+#include <cstdint>  // for uint8_t
+#include <string>   // for basic_string
+#include <vector>   // for vector
+
+#include "packed.hpp"  // for PackedCsd
+
+namespace csd {
+
+    /** Version written into the header of a serialized table */
+    constexpr std::uint8_t csd_format_version = 1U;
+
+    /**
+     * @brief How the digits of every record of a serialized table are stored
+     */
+    enum class CsdEncoding : std::uint8_t {
+        /// the '+' and '-' masks, `(length + 7) / 8` little-endian bytes each
+        Dense = 0U,
+        /// one byte per non-zero digit: its bit position, and 0x80 for a '-'
+        Sparse = 1U,
+    };
+
+    /**
+     * @brief Serialize packed CSD numbers to the binary table format
+     *
+     * A table is a 16-byte header (the magic "CSDT", the format version, the
+     * encoding, two reserved zero bytes and the record count as a
+     * little-endian 64-bit integer) followed by the records. Every record
+     * starts with the number of digits and a byte holding `frac` in its low
+     * seven bits and `has_point` in its top bit; a sparse record then has
+     * its non-zero count and positions, a dense one its two masks.
+     *
+     * The dense encoding takes at most 18 bytes per number; the sparse one
+     * takes 3 bytes plus one per non-zero digit, which is smaller for long
+     * numbers with few non-zero digits, like the output of `to_csdfixed`.
+     *
+     * @param[in] csds - Array of `n` packed CSD numbers
+     * @param[in] n - Number of values
+     * @param[in] encoding - The encoding of the records
+     * @return The serialized table
+     */
+    extern auto serialize(const PackedCsd *csds, std::size_t n,
+                          CsdEncoding encoding = CsdEncoding::Dense)
+        -> std::vector<unsigned char>;
+
+    /**
+     * @brief Read back a table written by `serialize`
+     *
+     * The digit masks are copied from the records as they are; nothing is
+     * parsed digit by digit.
+     *
+     * @param[in] data - The serialized table
+     * @param[in] size - Number of bytes of the table
+     * @return The packed CSD numbers, in the order they were written
+     * @throw std::runtime_error if the table is truncated, malformed, or of
+     *        an unsupported version
+     */
+    extern auto deserialize(const unsigned char *data, std::size_t size)
+        -> std::vector<PackedCsd>;
+
+    /**
+     * @brief Write packed CSD numbers to a file in the binary table format
+     *
+     * @param[in] path - The file to write
+     * @param[in] csds - The packed CSD numbers
+     * @param[in] encoding - The encoding of the records
+     * @throw std::runtime_error if the file cannot be written
+     */
+    extern auto write_csd_table(const std::string &path, const std::vector<PackedCsd> &csds,
+                                CsdEncoding encoding = CsdEncoding::Dense) -> void;
+
+    /**
+     * @brief Read a file written by `write_csd_table`
+     *
+     * The file is memory-mapped with `MappedFile` and deserialized in place.
+     *
+     * @param[in] path - The file to read
+     * @return The packed CSD numbers
+     * @throw std::runtime_error if the file cannot be read or is not a valid table
+     */
+    extern auto read_csd_table(const std::string &path) -> std::vector<PackedCsd>;
+
+}  // namespace csd
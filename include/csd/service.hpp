@@ -0,0 +1,95 @@
+/// @file service.hpp
+#pragma once
+
+#include <chrono>      // for microseconds
+#include <cstddef>     // for size_t
+#include <exception>   // for exception_ptr
+#include <functional>  // for function
+#include <future>      // for future
+#include <memory>      // for unique_ptr
+#include <string>      // for basic_string
+
+namespace csd {
+
+    /**
+     * @brief Called once with the result of a request, or with the exception it raised
+     *
+     * The value is meaningless when the exception is set.
+     */
+    template <typename T> using Completion = std::function<void(T, std::exception_ptr)>;
+
+    /**
+     * @brief How a `ConversionService` forms its batches
+     */
+    struct ServiceOptions {
+        /** Requests from which a batch is dispatched at once */
+        std::size_t max_batch = 1024U;
+
+        /** Longest time the first request of a batch waits for more to arrive */
+        std::chrono::microseconds max_delay = std::chrono::microseconds(200);
+
+        /** Threads of the batch kernels, or 0 for the hardware concurrency */
+        unsigned int threads = 0U;
+    };
+
+    /**
+     * @brief Collects single conversion requests into micro-batches
+     *
+     * Requests with the same operation and the same `places` or `nnz` are
+     * queued together, and a worker thread hands each queue to the
+     * `to_csd_parallel`, `to_csdfixed_parallel` or `to_decimal_parallel`
+     * kernel once it holds `max_batch` requests or its oldest request has
+     * waited `max_delay`, whichever comes first. This bounds the extra
+     * latency of a single request by `max_delay` plus one batch, while
+     * callers arriving together share the throughput of the batch paths.
+     *
+     * The completions run on the worker thread, once each, in request order
+     * within a batch, and should return quickly (e.g. resume a coroutine on
+     * an executor, or set a promise). An exception escaping a completion is
+     * dropped. The destructor dispatches whatever is still queued before
+     * returning.
+     */
+    class ConversionService {
+      public:
+        explicit ConversionService(const ServiceOptions &options = ServiceOptions());
+        ~ConversionService();
+
+        ConversionService(const ConversionService &) = delete;
+        auto operator=(const ConversionService &) -> ConversionService & = delete;
+
+        /** Queue `to_csd(decimal_value, places)` */
+        auto to_csd(double decimal_value, int places, Completion<std::string> done) -> void;
+
+        /** Queue `to_csdfixed(decimal_value, nnz)` */
+        auto to_csdfixed(double decimal_value, unsigned int nnz, Completion<std::string> done)
+            -> void;
+
+        /**
+         * @brief Queue `to_decimal(csd)`
+         *
+         * An invalid string completes with the `std::invalid_argument` of
+         * `to_decimal` and does not affect the rest of its batch.
+         */
+        auto to_decimal(std::string csd, Completion<double> done) -> void;
+
+        /** `to_csd(decimal_value, places)`, completed by the worker */
+        auto to_csd(double decimal_value, int places) -> std::future<std::string>;
+
+        /** `to_csdfixed(decimal_value, nnz)`, completed by the worker */
+        auto to_csdfixed(double decimal_value, unsigned int nnz) -> std::future<std::string>;
+
+        /** `to_decimal(csd)`, completed by the worker */
+        auto to_decimal(std::string csd) -> std::future<double>;
+
+        /** Dispatch all the queued requests without waiting for their deadlines */
+        auto flush() -> void;
+
+        /** Number of batches dispatched so far */
+        auto batches() const -> std::size_t;
+
+      private:
+        struct Impl;
+        std::unique_ptr<Impl> impl_;
+    };
+
+}  // namespace csd
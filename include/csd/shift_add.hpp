@@ -0,0 +1,183 @@
+/// @file shift_add.hpp
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <limits>     // for numeric_limits
+#include <stdexcept>  // for overflow_error
+#include <string>     // for basic_string
+#include <vector>     // for vector
+
+#include "csd.hpp"     // for CSD_THROW
+#include "packed.hpp"  // for PackedCsd
+
+namespace csd {
+
+    /**
+     * @brief One term of a shift-and-add program: `sign * (x << shift)`
+     */
+    struct ShiftAddTerm {
+        unsigned int shift;  ///< left shift applied to the input
+        int sign;            ///< +1 to add the shifted input, -1 to subtract it
+    };
+
+    /**
+     * @brief Multiplication by a CSD constant as shifts, additions and subtractions
+     *
+     * The constant is `sum(sign * 2^shift) / 2^frac`, with one term per
+     * non-zero digit, the most significant first. Fractional digits are
+     * turned into larger shifts plus one final right shift by `frac`, and
+     * `frac` is as small as possible (e.g. "+00-00.+0" gives the terms
+     * {6, +1}, {3, -1}, {0, +1} with frac = 1).
+     */
+    struct ShiftAddProgram {
+        std::vector<ShiftAddTerm> terms;  ///< the non-zero digits, most significant first
+        unsigned int frac;                ///< final right shift
+    };
+
+    /**
+     * @brief Build the shift-and-add program of a CSD string
+     *
+     * @param[in] csd - Pointer to the null-terminated CSD string
+     * @return The shift-and-add program
+     * @throw std::invalid_argument if an invalid character is encountered
+     */
+    extern auto to_shift_add(const char *csd) -> ShiftAddProgram;
+
+    /**
+     * @brief Build the shift-and-add program of a packed CSD number
+     *
+     * @param[in] csd - The packed CSD number
+     * @return The shift-and-add program
+     */
+    extern auto to_shift_add(const PackedCsd &csd) -> ShiftAddProgram;
+
+    /**
+     * @brief Number of two-input adders (or subtractors) of a program
+     *
+     * @param[in] program - The shift-and-add program
+     * @return One less than the number of terms, or 0 for a zero constant
+     */
+    inline auto adder_count(const ShiftAddProgram &program) -> std::size_t {
+        return program.terms.empty() ? 0U : program.terms.size() - 1U;
+    }
+
+    /**
+     * @brief Emit a program as a C expression
+     *
+     * E.g. "(((x << 6) - (x << 3) + x) >> 1)" for "+00-00.+0".
+     *
+     * @param[in] program - The shift-and-add program
+     * @param[in] input - The name of the input variable
+     * @return The C (or C++) expression
+     */
+    extern auto to_c_expression(const ShiftAddProgram &program, const std::string &input = "x")
+        -> std::string;
+
+    /**
+     * @brief Emit a program as a Verilog module
+     *
+     * The module has a signed input `x` of `WIDTH` bits (a parameter,
+     * defaulting to `width`) and a signed output `y` wide enough for the full
+     * product before the final arithmetic right shift.
+     *
+     * @param[in] program - The shift-and-add program
+     * @param[in] module_name - The name of the Verilog module
+     * @param[in] width - The default input width
+     * @return The Verilog source
+     */
+    extern auto to_verilog(const ShiftAddProgram &program, const std::string &module_name,
+                           unsigned int width = 16U) -> std::string;
+
+    namespace detail {
+        /**
+         * @brief Check that the shifts of a program are defined on `T`
+         *
+         * `T{1} << shift` must stay below the sign bit, and the final right
+         * shift by `frac` below the width of `T`.
+         *
+         * @throw std::overflow_error if a shift is too large for `T`
+         */
+        template <typename T> inline auto check_shift_add_width(const ShiftAddProgram &program)
+            -> void {
+            auto const digits = static_cast<unsigned int>(std::numeric_limits<T>::digits);
+            auto const width = digits + (std::numeric_limits<T>::is_signed ? 1U : 0U);
+            auto fits = program.frac < width;
+            for (auto const &term : program.terms) {
+                fits = fits && term.shift < digits;
+            }
+            if (!fits) {
+                CSD_THROW(std::overflow_error("Shift-and-add program exceeds the integer width"));
+            }
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Multiply a single integer or fixed-point value by a program
+     *
+     * The terms are accumulated exactly and shifted right by `frac` once at
+     * the end, so the result is `floor(x * constant)` as long as the
+     * accumulation does not overflow `T`.
+     *
+     * @tparam T A signed or unsigned integer type
+     * @param[in] program - The shift-and-add program
+     * @param[in] x - The input value
+     * @return The product
+     * @throw std::overflow_error if a shift reaches the sign bit or the width of `T`
+     */
+    template <typename T> inline auto apply_shift_add(const ShiftAddProgram &program, T x) -> T {
+        detail::check_shift_add_width<T>(program);
+        T acc = 0;
+        for (auto const &term : program.terms) {
+            auto const shifted = static_cast<T>(x * static_cast<T>(T{1} << term.shift));
+            acc = static_cast<T>(term.sign > 0 ? acc + shifted : acc - shifted);
+        }
+        return static_cast<T>(acc >> program.frac);
+    }
+
+    /**
+     * @brief Multiply an array of integer or fixed-point values by a program
+     *
+     * The array is processed in blocks of 256 values that stay in L1 cache;
+     * for every term, one tight loop adds or subtracts the shifted block, so
+     * each loop is a single shift and add per element that the compiler
+     * vectorizes. `in` and `out` may be the same array.
+     *
+     * @tparam T A signed or unsigned integer type
+     * @param[in] program - The shift-and-add program
+     * @param[in] in - The `n` input values
+     * @param[out] out - Receives the `n` products
+     * @param[in] n - Number of values
+     * @throw std::overflow_error if a shift reaches the sign bit or the width of `T`
+     * @see apply_shift_add(const ShiftAddProgram &, T)
+     */
+    template <typename T> inline auto apply_shift_add(const ShiftAddProgram &program, const T *in,
+                                                      T *out, std::size_t n) -> void {
+        detail::check_shift_add_width<T>(program);
+        constexpr std::size_t block = 256U;
+        T acc[block];
+        for (std::size_t first = 0U; first < n; first += block) {
+            auto const count = n - first < block ? n - first : block;
+            auto const *const src = in + first;
+            for (std::size_t i = 0U; i != count; ++i) {
+                acc[i] = 0;
+            }
+            for (auto const &term : program.terms) {
+                auto const factor = static_cast<T>(T{1} << term.shift);
+                if (term.sign > 0) {
+                    for (std::size_t i = 0U; i != count; ++i) {
+                        acc[i] = static_cast<T>(acc[i] + src[i] * factor);
+                    }
+                } else {
+                    for (std::size_t i = 0U; i != count; ++i) {
+                        acc[i] = static_cast<T>(acc[i] - src[i] * factor);
+                    }
+                }
+            }
+            auto *const dst = out + first;
+            for (std::size_t i = 0U; i != count; ++i) {
+                dst[i] = static_cast<T>(acc[i] >> program.frac);
+            }
+        }
+    }
+
+}  // namespace csd
@@ -0,0 +1,197 @@
+/// @file string_table.hpp
+#pragma once
+
+#include <cstddef>      // for size_t
+#include <memory>       // for allocator, allocator_traits
+#include <new>          // for operator new
+#include <string>       // for basic_string
+#include <type_traits>  // for enable_if, is_constructible
+#include <utility>      // for move, forward
+#include <vector>       // for vector
+
+#include "csd.hpp"  // for to_csd_into, to_csd_length, to_csdfixed_into
+
+#if defined(CSD_HAS_STRING_VIEW) && defined(__has_include)
+#    if __has_include(<memory_resource>)
+#        include <memory_resource>  // for polymorphic_allocator
+#        define CSD_HAS_PMR 1
+#    endif
+#endif
+
+namespace csd {
+
+    namespace detail {
+        /**
+         * @brief `Alloc`, except that `resize` leaves the new elements uninitialized
+         *
+         * A table only grows its buffers to write over the new elements, and
+         * zeroing a whole arena first would be serial work before the
+         * parallel conversions.
+         */
+        template <typename Alloc> class UninitializedAllocator : public Alloc {
+            using traits = std::allocator_traits<Alloc>;
+
+          public:
+            template <typename U> struct rebind {
+                using other = UninitializedAllocator<typename traits::template rebind_alloc<U>>;
+            };
+
+            UninitializedAllocator() = default;
+
+            template <typename Other, typename = typename std::enable_if<
+                                          std::is_constructible<Alloc, const Other &>::value>::type>
+            UninitializedAllocator(const Other &other) : Alloc(other) {}
+
+            template <typename U> auto construct(U *p) -> void { ::new (static_cast<void *>(p)) U; }
+
+            template <typename U, typename... Args> auto construct(U *p, Args &&...args) -> void {
+                traits::construct(static_cast<Alloc &>(*this), p, std::forward<Args>(args)...);
+            }
+        };
+    }  // namespace detail
+
+    /**
+     * @brief Many CSD strings stored back to back in one buffer
+     *
+     * String i occupies `data[offsets[i]]` up to (not including)
+     * `data[offsets[i + 1] - 1]`, which is its terminating '\0', so every
+     * entry can be passed to the `const char *` functions directly. One
+     * table costs two allocations however many strings it holds, and
+     * destroying or clearing it frees them all at once.
+     *
+     * Both buffers are obtained from `Alloc` (rebound to `std::size_t` for
+     * the offsets), so a whole batch of results can live in an arena, e.g.
+     * with `pmr::CsdStringTable` and a `std::pmr::monotonic_buffer_resource`.
+     * Growing the buffers leaves the new elements uninitialized, for the
+     * caller to write.
+     *
+     * @tparam Alloc - Allocator of `char`
+     */
+    template <typename Alloc = std::allocator<char>> class BasicCsdStringTable {
+      public:
+        using allocator_type = Alloc;
+        using offset_allocator =
+            typename std::allocator_traits<Alloc>::template rebind_alloc<std::size_t>;
+        using buffer_type = std::vector<char, detail::UninitializedAllocator<Alloc>>;
+        using offsets_type
+            = std::vector<std::size_t, detail::UninitializedAllocator<offset_allocator>>;
+
+        BasicCsdStringTable() : BasicCsdStringTable(Alloc()) {}
+
+        /**
+         * @brief Construct an empty table drawing its memory from `alloc`
+         */
+        explicit BasicCsdStringTable(const Alloc &alloc)
+            : data_(alloc), offsets_(1U, 0U, offset_allocator(alloc)) {}
+
+        /**
+         * @brief Take over a filled buffer and its offsets
+         *
+         * @param[in] data - The null-terminated strings, back to back
+         * @param[in] offsets - Start of every string, followed by `data.size()`
+         */
+        BasicCsdStringTable(buffer_type data, offsets_type offsets)
+            : data_(std::move(data)), offsets_(std::move(offsets)) {}
+
+        /** Number of strings */
+        auto size() const -> std::size_t { return offsets_.size() - 1U; }
+
+        /** Whether the table holds no strings */
+        auto empty() const -> bool { return size() == 0U; }
+
+        /** The null-terminated string i */
+        auto operator[](std::size_t i) const -> const char * { return data_.data() + offsets_[i]; }
+
+        /** Number of characters of string i */
+        auto length(std::size_t i) const -> std::size_t {
+            return offsets_[i + 1U] - offsets_[i] - 1U;
+        }
+
+        /** Copy of string i */
+        auto str(std::size_t i) const -> std::string {
+            return std::string((*this)[i], length(i));
+        }
+
+#ifdef CSD_HAS_STRING_VIEW
+        /** String i, without copying */
+        auto view(std::size_t i) const -> std::string_view {
+            return std::string_view((*this)[i], length(i));
+        }
+#endif
+
+        /** Append a string */
+        auto push_back(const char *csd, std::size_t length) -> void {
+            data_.insert(data_.end(), csd, csd + length);
+            data_.push_back('\0');
+            offsets_.push_back(data_.size());
+        }
+
+        /**
+         * @brief Append `to_csd(decimal_value, places)`, written in place
+         */
+        auto push_back_csd(double decimal_value, int places) -> void {
+            auto const start = data_.size();
+            auto const length = to_csd_length(decimal_value, places);
+            data_.resize(start + length + 1U);
+            to_csd_into(decimal_value, places, data_.data() + start, length + 1U);
+            offsets_.push_back(data_.size());
+        }
+
+        /**
+         * @brief Append `to_csdfixed(decimal_value, nnz)`, written in place
+         */
+        auto push_back_csdfixed(double decimal_value, unsigned int nnz) -> void {
+            auto const start = data_.size();
+            // Most results fit in 64 characters; retry once with the exact size
+            data_.resize(start + 64U);
+            auto const length = to_csdfixed_into(decimal_value, nnz, data_.data() + start, 64U);
+            if (length >= 64U) {
+                data_.resize(start + length + 1U);
+                to_csdfixed_into(decimal_value, nnz, data_.data() + start, length + 1U);
+            }
+            data_.resize(start + length + 1U);
+            offsets_.push_back(data_.size());
+        }
+
+        /**
+         * @brief Reserve room for more strings
+         *
+         * @param[in] strings - Number of strings to hold in all
+         * @param[in] chars - Number of characters to hold in all, counting the terminators
+         */
+        auto reserve(std::size_t strings, std::size_t chars) -> void {
+            offsets_.reserve(strings + 1U);
+            data_.reserve(chars);
+        }
+
+        /** Remove all the strings */
+        auto clear() -> void {
+            data_.clear();
+            offsets_.resize(1U);
+        }
+
+        /** The allocator of the character buffer */
+        auto get_allocator() const -> allocator_type { return data_.get_allocator(); }
+
+        /** The underlying buffer */
+        auto data() const -> const buffer_type & { return data_; }
+
+        /** The start offsets, followed by the buffer size */
+        auto offsets() const -> const offsets_type & { return offsets_; }
+
+      private:
+        buffer_type data_;
+        offsets_type offsets_;
+    };
+
+    /** The table with the default allocator */
+    using CsdStringTable = BasicCsdStringTable<>;
+
+#ifdef CSD_HAS_PMR
+    namespace pmr {
+        /** The table drawing its memory from a `std::pmr::memory_resource` */
+        using CsdStringTable = BasicCsdStringTable<std::pmr::polymorphic_allocator<char>>;
+    }  // namespace pmr
+#endif
+
+}  // namespace csd
@@ -0,0 +1,244 @@
+/// @file wide.hpp
+#pragma once
+
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint64_t, int64_t, uint32_t, int32_t
+#include <stdexcept>  // for invalid_argument, overflow_error
+#include <string>     // for basic_string
+#include <utility>    // for move
+#include <vector>     // for vector
+
+#include "csd.hpp"  // for CSD_THROW, int128_t, uint128_t
+
+namespace csd {
+
+    /**
+     * @brief Arbitrary-precision signed integer, for CSD conversions only
+     *
+     * Sign and magnitude, with the magnitude in 64-bit limbs, least
+     * significant first and without leading zero limbs (zero has no limbs
+     * and is never negative).
+     */
+    class BigInt {
+      public:
+        BigInt() : negative_(false), limbs_() {}
+
+        /**
+         * @brief Construct from a built-in integer
+         *
+         * @param[in] value - The value
+         */
+        BigInt(std::int64_t value)  // NOLINT(google-explicit-constructor)
+            : negative_(value < 0), limbs_() {
+            auto const magnitude = value < 0 ? 0U - static_cast<std::uint64_t>(value)
+                                             : static_cast<std::uint64_t>(value);
+            if (magnitude != 0U) {
+                limbs_.push_back(magnitude);
+            }
+        }
+
+        /**
+         * @brief Construct from a sign and a magnitude
+         *
+         * @param[in] negative - Whether the value is negative
+         * @param[in] limbs - The magnitude, least significant limb first
+         */
+        BigInt(bool negative, std::vector<std::uint64_t> limbs)
+            : negative_(negative), limbs_(std::move(limbs)) {
+            while (!limbs_.empty() && limbs_.back() == 0U) {
+                limbs_.pop_back();
+            }
+            negative_ = negative_ && !limbs_.empty();
+        }
+
+        /** Whether the value is negative */
+        auto negative() const -> bool { return negative_; }
+
+        /** The magnitude, least significant limb first */
+        auto limbs() const -> const std::vector<std::uint64_t> & { return limbs_; }
+
+        auto operator==(const BigInt &other) const -> bool {
+            return negative_ == other.negative_ && limbs_ == other.limbs_;
+        }
+
+        auto operator!=(const BigInt &other) const -> bool { return !(*this == other); }
+
+      private:
+        bool negative_;
+        std::vector<std::uint64_t> limbs_;
+    };
+
+    /**
+     * @brief Decimal string of a big integer, e.g. "-1267650600228229401496703205376"
+     *
+     * @param[in] value - The big integer
+     * @return The decimal digits, with a leading '-' if negative
+     */
+    extern auto to_string(const BigInt &value) -> std::string;
+
+    namespace detail {
+        /**
+         * @brief The unsigned counterpart and width of the supported integers
+         *
+         * `std::make_unsigned` and `std::numeric_limits` know nothing of
+         * `__int128` in strict ISO modes, hence this small table.
+         */
+        template <typename Int> struct WideTraits;
+
+        template <> struct WideTraits<std::int32_t> {
+            using Unsigned = std::uint32_t;
+            static constexpr unsigned int bits = 32U;
+        };
+
+        template <> struct WideTraits<std::int64_t> {
+            using Unsigned = std::uint64_t;
+            static constexpr unsigned int bits = 64U;
+        };
+
+#if defined(__SIZEOF_INT128__)
+        template <> struct WideTraits<int128_t> {
+            using Unsigned = uint128_t;
+            static constexpr unsigned int bits = 128U;
+        };
+#endif
+
+        /**
+         * @brief The digits of the '+' and '-' masks, from digit `count - 1` down
+         */
+        template <typename Unsigned>
+        inline auto append_digits(std::string &csd, Unsigned pos, Unsigned neg, unsigned int count)
+            -> void {
+            for (auto k = count; k != 0U; --k) {
+                auto const plus = static_cast<unsigned int>(pos >> (k - 1U)) & 1U;
+                auto const minus = static_cast<unsigned int>(neg >> (k - 1U)) & 1U;
+                csd += "0+-"[plus | (minus << 1U)];
+            }
+        }
+
+        /**
+         * @brief Number of digits up to the most significant set bit
+         */
+        template <typename Unsigned> inline auto bit_width(Unsigned x) -> unsigned int {
+            auto width = 0U;
+            for (; x != 0U; x >>= 1U) {
+                ++width;
+            }
+            return width;
+        }
+    }  // namespace detail
+
+    /**
+     * @brief Convert a 64-bit or 128-bit integer to CSD format
+     *
+     * The whole non-adjacent form is computed a word at a time with
+     * x ^ 3x: with h = x >> 1 and t = x + h, the non-zero digits are
+     * c = h ^ t, the '+' digits t & c and the '-' digits h & c.
+     * Produces the same digits as `to_csd_i` for every `int`.
+     *
+     * @tparam Int `std::int32_t`, `std::int64_t` or `csd::int128_t`
+     * @param[in] decimal_value - The integer to convert to CSD format.
+     * @return String representation of the input integer in CSD format.
+     */
+    template <typename Int> inline auto to_csd_wide(Int decimal_value) -> std::string {
+        using Unsigned = typename detail::WideTraits<Int>::Unsigned;
+        if (decimal_value == 0) {
+            return "0";
+        }
+        auto const x = decimal_value < 0 ? Unsigned(Unsigned{0U} - Unsigned(decimal_value))
+                                         : Unsigned(decimal_value);
+        auto const half = Unsigned(x >> 1U);
+        auto const triple = Unsigned(x + half);  // |x| <= 2^(W-1), so no carry out
+        auto const nonzero = Unsigned(half ^ triple);
+        auto pos = Unsigned(triple & nonzero);
+        auto neg = Unsigned(half & nonzero);
+        if (decimal_value < 0) {
+            auto const swap = pos;
+            pos = neg;
+            neg = swap;
+        }
+        auto const count = detail::bit_width(Unsigned(pos | neg));
+        std::string csd;
+        csd.reserve(count);
+        detail::append_digits(csd, pos, neg, count);
+        return csd;
+    }
+
+    /**
+     * @brief Convert a big integer to CSD format
+     *
+     * Same method as `to_csd_wide(Int)`, one 64-bit limb (64 digits) per
+     * step, with the shift and the carry of x + (x >> 1) chained across limbs.
+     *
+     * @param[in] decimal_value - The integer to convert to CSD format.
+     * @return String representation of the input integer in CSD format.
+     */
+    extern auto to_csd_wide(const BigInt &decimal_value) -> std::string;
+
+    /**
+     * @brief Convert the integral part of a CSD string to a 64-bit or 128-bit integer
+     *
+     * Like `to_decimal_i`, the conversion stops at a '.' or at the end of the
+     * string. The '+' and '-' digits are gathered into two masks and the
+     * result is their difference. The leading digit gives the sign of the
+     * value, so overflow is detected exactly even when the digits fill the
+     * whole word.
+     *
+     * @tparam Int `std::int32_t`, `std::int64_t` or `csd::int128_t`
+     * @param[in] csd - Pointer to the null-terminated CSD string
+     * @return The integer value of the integral part
+     * @throw std::invalid_argument if an invalid character is encountered
+     * @throw std::overflow_error if the value does not fit `Int`
+     */
+    template <typename Int> inline auto to_decimal_wide(const char *csd) -> Int {
+        using Unsigned = typename detail::WideTraits<Int>::Unsigned;
+        constexpr auto bits = detail::WideTraits<Int>::bits;
+        auto pos = Unsigned{0U};
+        auto neg = Unsigned{0U};
+        auto digits = 0U;  // counted from the leading non-zero digit
+        auto leading = 0;
+        for (;; ++csd) {
+            auto const digit = *csd;
+            if (digit == '.' || digit == '\0') {
+                break;
+            }
+            if (digit != '0' && digit != '+' && digit != '-') {
+                CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
+            }
+            if (leading == 0 && digit == '0') {
+                continue;
+            }
+            if (leading == 0) {
+                leading = digit == '+' ? 1 : -1;
+            }
+            if (++digits > bits) {
+                CSD_THROW(std::overflow_error("CSD number exceeds the integer width"));
+            }
+            pos = Unsigned((pos << 1U) | Unsigned(digit == '+' ? 1U : 0U));
+            neg = Unsigned((neg << 1U) | Unsigned(digit == '-' ? 1U : 0U));
+        }
+        // |value| < 2^digits, so its sign and its value modulo 2^bits fix it
+        auto const value = Unsigned(pos - neg);
+        auto const top = Unsigned(Unsigned{1U} << (bits - 1U));
+        if ((leading > 0 && value >= top) || (leading < 0 && value < top)) {
+            CSD_THROW(std::overflow_error("CSD number exceeds the integer width"));
+        }
+        if (leading >= 0) {
+            return Int(value);
+        }
+        // value - 2^bits, without converting an out-of-range unsigned value
+        return Int(-Int(Unsigned(~value)) - 1);
+    }
+
+    /**
+     * @brief Convert the integral part of a CSD string to a big integer
+     *
+     * The digits are gathered into '+' and '-' masks 64 at a time, one limb
+     * per step, and subtracted with a borrow chain.
+     *
+     * @param[in] csd - Pointer to the null-terminated CSD string
+     * @return The integer value of the integral part
+     * @throw std::invalid_argument if an invalid character is encountered
+     */
+    template <> auto to_decimal_wide<BigInt>(const char *csd) -> BigInt;
+
+}  // namespace csd
@@ -0,0 +1,420 @@
+/// @file batch.cpp
+#include <csd/batch.hpp>    // for to_decimal_batch
+#include <csd/csd.hpp>      // for to_decimal
+#include <csd/metrics.hpp>  // for ScopedMetric, MetricFunction
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint64_t, uint32_t, int64_t, uintptr_t
+#include <cstring>          // for memcpy, memset
+#include <stdexcept>        // for invalid_argument
+#include <string>           // for basic_string
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    include <emmintrin.h>
+#    define CSD_BATCH_SSE2 1
+#    if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#        include <immintrin.h>
+#        define CSD_BATCH_AVX2 1
+#    endif
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#    include <arm_neon.h>
+#    define CSD_BATCH_NEON 1
+#endif
+
+using std::size_t;
+using std::uint64_t;
+
+namespace {
+    /** Longest string handled by the vectorized path */
+    constexpr size_t block_size = 64U;
+
+    /** Longest fractional part whose sum is exact in a double */
+    constexpr unsigned int max_exact_frac = 53U;
+
+    /**
+     * @brief Character classes of a 64-character block, one bit per character
+     *
+     * Bit 63 - i of each mask corresponds to the i-th character of the
+     * block, so that a string of n characters is read as a number by
+     * shifting its mask right by 64 - n. The classifiers reverse the bytes
+     * before taking their masks.
+     */
+    struct CharMasks {
+        uint64_t plus;
+        uint64_t minus;
+        uint64_t valid;  ///< '+', '-', '0' or '.'
+        uint64_t point;
+        uint64_t nul;
+    };
+
+    inline auto count_leading_zeros(uint64_t x) -> unsigned int {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<unsigned int>(__builtin_clzll(x));
+#else
+        auto count = 0U;
+        for (; (x >> 63U) == 0U; x <<= 1) {
+            ++count;
+        }
+        return count;
+#endif
+    }
+
+#if defined(__GNUC__) || defined(__clang__)
+    /** Lets the compiler inline the classifier of the instruction set into the batch loop */
+#    define CSD_BATCH_FLATTEN __attribute__((flatten))
+    /**
+     * The vector loads read a whole block in place, past the end of a short
+     * string but never past its page, which address sanitizers would report
+     */
+#    define CSD_BATCH_IN_PLACE __attribute__((no_sanitize_address))
+#else
+#    define CSD_BATCH_FLATTEN
+#    define CSD_BATCH_IN_PLACE
+#endif
+
+    /** Size of the strings of the pointer overload, found by the classifier */
+    constexpr size_t unknown_size = ~size_t{0U};
+
+    /** Reads that stay inside a page cannot fault, wherever the string ends in it */
+    constexpr std::uintptr_t page_size = 4096U;
+
+    inline auto block_in_page(const char *csd) -> bool {
+        return (reinterpret_cast<std::uintptr_t>(csd) & (page_size - 1U)) <= page_size - block_size;
+    }
+
+#if !defined(CSD_BATCH_SSE2) && !defined(CSD_BATCH_NEON)
+    struct ClassifyScalar {
+        auto operator()(const char *chars, size_t limit) const -> CharMasks {
+            CharMasks masks{0U, 0U, 0U, 0U, 0U};
+            for (auto i = 0U; i != limit; ++i) {
+                auto const bit = uint64_t{1U} << (63U - i);
+                switch (chars[i]) {
+                    case '+':
+                        masks.plus |= bit;
+                        masks.valid |= bit;
+                        break;
+                    case '-':
+                        masks.minus |= bit;
+                        masks.valid |= bit;
+                        break;
+                    case '0':
+                        masks.valid |= bit;
+                        break;
+                    case '.':
+                        masks.point |= bit;
+                        masks.valid |= bit;
+                        break;
+                    case '\0':
+                        masks.nul |= bit;
+                        return masks;
+                    default:
+                        break;
+                }
+            }
+            return masks;
+        }
+    };
+#endif
+
+#if defined(CSD_BATCH_SSE2)
+    inline auto reverse_bytes_sse2(__m128i x) -> __m128i {
+        x = _mm_shuffle_epi32(x, _MM_SHUFFLE(0, 1, 2, 3));
+        x = _mm_shufflelo_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        x = _mm_shufflehi_epi16(x, _MM_SHUFFLE(2, 3, 0, 1));
+        return _mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8));
+    }
+
+    struct ClassifySse2 {
+        CSD_BATCH_IN_PLACE auto operator()(const char *chars, size_t limit) const -> CharMasks {
+            CharMasks masks{0U, 0U, 0U, 0U, 0U};
+            auto const plus = _mm_set1_epi8('+');
+            auto const minus = _mm_set1_epi8('-');
+            auto const zero = _mm_set1_epi8('0');
+            auto const point = _mm_set1_epi8('.');
+            auto const nul = _mm_setzero_si128();
+            for (auto i = 0U; i < limit && masks.nul == 0U; i += 16U) {
+                auto const block = reverse_bytes_sse2(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i *>(chars + i)));
+                auto const is_plus = _mm_cmpeq_epi8(block, plus);
+                auto const is_minus = _mm_cmpeq_epi8(block, minus);
+                auto const is_point = _mm_cmpeq_epi8(block, point);
+                auto const is_zero = _mm_cmpeq_epi8(block, zero);
+                auto const is_valid = _mm_or_si128(_mm_or_si128(is_plus, is_minus),
+                                                   _mm_or_si128(is_point, is_zero));
+                auto mask = [&](__m128i matches) {
+                    return uint64_t(static_cast<std::uint32_t>(_mm_movemask_epi8(matches)))
+                           << (48U - i);
+                };
+                masks.plus |= mask(is_plus);
+                masks.minus |= mask(is_minus);
+                masks.valid |= mask(is_valid);
+                masks.point |= mask(is_point);
+                masks.nul |= mask(_mm_cmpeq_epi8(block, nul));
+            }
+            return masks;
+        }
+    };
+#endif
+
+#if defined(CSD_BATCH_AVX2)
+    __attribute__((target("avx2"))) inline auto mask_avx2(__m256i matches, unsigned int i)
+        -> uint64_t {
+        return uint64_t(static_cast<std::uint32_t>(_mm256_movemask_epi8(matches))) << (32U - i);
+    }
+
+    struct ClassifyAvx2 {
+        __attribute__((target("avx2"))) CSD_BATCH_IN_PLACE auto operator()(const char *chars,
+                                                                           size_t limit) const
+            -> CharMasks {
+            CharMasks masks{0U, 0U, 0U, 0U, 0U};
+            auto const reverse = _mm256_setr_epi8(15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2,
+                                                  1, 0, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4,
+                                                  3, 2, 1, 0);
+            for (auto i = 0U; i < limit && masks.nul == 0U; i += 32U) {
+                auto const block = _mm256_permute4x64_epi64(
+                    _mm256_shuffle_epi8(
+                        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(chars + i)), reverse),
+                    0x4E);
+                auto const is_plus = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('+'));
+                auto const is_minus = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('-'));
+                auto const is_point = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('.'));
+                auto const is_zero = _mm256_cmpeq_epi8(block, _mm256_set1_epi8('0'));
+                masks.plus |= mask_avx2(is_plus, i);
+                masks.minus |= mask_avx2(is_minus, i);
+                masks.valid |= mask_avx2(
+                    _mm256_or_si256(_mm256_or_si256(is_plus, is_minus),
+                                    _mm256_or_si256(is_point, is_zero)),
+                    i);
+                masks.point |= mask_avx2(is_point, i);
+                masks.nul |= mask_avx2(_mm256_cmpeq_epi8(block, _mm256_setzero_si256()), i);
+            }
+            return masks;
+        }
+    };
+
+    auto has_avx2() -> bool {
+        // The CPUs with AVX2 have BMI2, whose shifts by a variable count are single uops
+        static const bool supported
+            = __builtin_cpu_supports("avx2") != 0 && __builtin_cpu_supports("bmi2") != 0;
+        return supported;
+    }
+#endif
+
+#if defined(CSD_BATCH_NEON)
+    inline auto movemask_neon(uint8x16_t matches) -> uint64_t {
+        static const uint8_t weights[16] = {1, 2, 4, 8, 16, 32, 64, 128,
+                                            1, 2, 4, 8, 16, 32, 64, 128};
+        auto const bits = vandq_u8(matches, vld1q_u8(weights));
+        return uint64_t(vaddv_u8(vget_low_u8(bits))) | (uint64_t(vaddv_u8(vget_high_u8(bits))) << 8);
+    }
+
+    struct ClassifyNeon {
+        CSD_BATCH_IN_PLACE auto operator()(const char *chars, size_t limit) const -> CharMasks {
+            CharMasks masks{0U, 0U, 0U, 0U, 0U};
+            for (auto i = 0U; i < limit && masks.nul == 0U; i += 16U) {
+                auto const forward = vld1q_u8(reinterpret_cast<const uint8_t *>(chars + i));
+                auto const reversed = vrev64q_u8(forward);
+                auto const block = vextq_u8(reversed, reversed, 8);
+                auto const shift = 48U - i;
+                auto const is_plus = vceqq_u8(block, vdupq_n_u8('+'));
+                auto const is_minus = vceqq_u8(block, vdupq_n_u8('-'));
+                auto const is_point = vceqq_u8(block, vdupq_n_u8('.'));
+                auto const is_zero = vceqq_u8(block, vdupq_n_u8('0'));
+                auto const is_valid
+                    = vorrq_u8(vorrq_u8(is_plus, is_minus), vorrq_u8(is_point, is_zero));
+                masks.plus |= movemask_neon(is_plus) << shift;
+                masks.minus |= movemask_neon(is_minus) << shift;
+                masks.valid |= movemask_neon(is_valid) << shift;
+                masks.point |= movemask_neon(is_point) << shift;
+                masks.nul |= movemask_neon(vceqq_u8(block, vdupq_n_u8(0U))) << shift;
+            }
+            return masks;
+        }
+    };
+#endif
+
+    /**
+     * @brief Decode a string that does not fit the vectorized path
+     */
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((noinline))
+#endif
+    auto decode_scalar(const char *csd, size_t size, bool terminated) -> double {
+        if (terminated) {
+            return csd::to_decimal(csd);
+        }
+        return csd::to_decimal(std::string(csd, size).c_str());
+    }
+
+    /**
+     * @brief Copy the start of a string that ends near a page into a zeroed block
+     */
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((noinline))
+#endif
+    auto copy_block(const char *csd, size_t limit, char *block) -> const char * {
+        std::memset(block, 0, block_size);
+        for (size_t i = 0U; i != limit && csd[i] != '\0'; ++i) {
+            block[i] = csd[i];
+        }
+        return block;
+    }
+
+    /** 2^-k, exactly, for k up to `max_exact_frac` */
+    inline auto inverse_power_of_two(unsigned int k) -> double {
+        auto const bits = uint64_t(1023U - k) << 52U;
+        double value;
+        std::memcpy(&value, &bits, sizeof value);
+        return value;
+    }
+
+    /**
+     * @brief The value of a string of at most 64 characters from its masks
+     *
+     * @param[in] masks - The classes of its characters
+     * @param[in] csd - Pointer to the first character, for the scalar fallback
+     * @param[in] size - Number of characters, or `unknown_size` up to its '\0'
+     * @param[in] terminated - Whether the string is null-terminated
+     */
+    inline auto combine(const CharMasks &masks, const char *csd, size_t size, bool terminated)
+        -> double {
+        if (masks.nul == 0U && size == unknown_size) {
+            return decode_scalar(csd, size, terminated);  // longer than a block
+        }
+        // A '\0' inside the range also ends the string
+        size_t const nul_length = masks.nul == 0U ? block_size : count_leading_zeros(masks.nul);
+        auto const length = nul_length < size ? nul_length : size;
+        auto const in_range = length == 0U ? 0U : ~uint64_t{0U} << (block_size - length);
+        auto const points = masks.point & in_range;
+
+        // Position of the binary point (or the end) and of the first bad character
+        auto const dot = points == 0U ? unsigned(length) : count_leading_zeros(points);
+        auto const first_point = points == 0U ? 0U : (uint64_t{1U} << 63U) >> dot;
+        auto const bad = (in_range & ~masks.valid) | (points ^ first_point);
+        if (bad != 0U) {
+            if (count_leading_zeros(bad) < dot) {
+                CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
+            }
+            CSD_THROW(std::invalid_argument("Fractional part work with 0, +, and - only"));
+        }
+
+        auto const frac = points == 0U ? 0U : unsigned(length) - dot - 1U;
+        if (frac > max_exact_frac) {
+            return decode_scalar(csd, size, terminated);
+        }
+
+        // The last character becomes bit 0
+        auto const shift = unsigned(block_size - length);
+        auto const plus = shift == block_size ? 0U : masks.plus >> shift;
+        auto const minus = shift == block_size ? 0U : masks.minus >> shift;
+
+        auto const int_shift = points == 0U ? 0U : frac + 1U;
+        auto const integral = int_shift >= block_size
+                                  ? 0
+                                  : static_cast<int>(static_cast<std::uint32_t>(
+                                      (plus >> int_shift) - (minus >> int_shift)));
+        if (points == 0U) {
+            return double(integral);
+        }
+
+        // The fractional digits as an integer, exact below 2^53, times 2^-frac
+        auto const frac_mask = (uint64_t{1U} << frac) - 1U;
+        auto const fractional = static_cast<std::int64_t>((plus & frac_mask) - (minus & frac_mask));
+        return double(integral) + double(fractional) * inverse_power_of_two(frac);
+    }
+
+    /** The strings of the pointer overload, of unknown sizes */
+    struct TerminatedStrings {
+        const char *const *csd;
+        auto data(size_t i) const -> const char * { return csd[i]; }
+        auto size(size_t) const -> size_t { return unknown_size; }
+        auto terminated() const -> bool { return true; }
+    };
+
+    struct StdStrings {
+        const std::string *csd;
+        auto data(size_t i) const -> const char * { return csd[i].c_str(); }
+        auto size(size_t i) const -> size_t { return csd[i].size(); }
+        auto terminated() const -> bool { return true; }
+    };
+
+    struct CharRanges {
+        const char *const *csd;
+        const size_t *sizes;
+        auto data(size_t i) const -> const char * { return csd[i]; }
+        auto size(size_t i) const -> size_t { return sizes[i]; }
+        auto terminated() const -> bool { return false; }
+    };
+
+    /**
+     * @brief Decode `n` strings, each classified where it lies
+     *
+     * Only a string that ends within a block of its page's end is copied
+     * first, so that the block reads stay inside the page.
+     */
+    template <typename Strings, typename Classify>
+    inline auto decode_strings(const Strings &strings, size_t n, double *out, Classify classify)
+        -> void {
+        alignas(32) char block[block_size];
+        for (size_t i = 0U; i != n; ++i) {
+            auto const *const csd = strings.data(i);
+            auto const size = strings.size(i);
+            if (size != unknown_size && size > block_size) {
+                out[i] = decode_scalar(csd, size, strings.terminated());
+                continue;
+            }
+            auto const limit = size == unknown_size ? block_size : size;
+            auto const *const chars = block_in_page(csd) ? csd : copy_block(csd, limit, block);
+            out[i] = combine(classify(chars, limit), csd, size, strings.terminated());
+        }
+    }
+
+#if defined(CSD_BATCH_AVX2)
+    template <typename Strings>
+    __attribute__((target("avx2,bmi2"))) CSD_BATCH_FLATTEN auto decode_avx2(const Strings &strings,
+                                                                            size_t n, double *out)
+        -> void {
+        decode_strings(strings, n, out, ClassifyAvx2());
+    }
+#endif
+
+    /**
+     * @brief Decode with the widest classifier supported by the running CPU
+     */
+    template <typename Strings>
+    auto decode_batch(const Strings &strings, size_t n, double *out) -> void {
+#if defined(CSD_BATCH_AVX2)
+        if (has_avx2()) {
+            decode_avx2(strings, n, out);
+            return;
+        }
+#endif
+#if defined(CSD_BATCH_SSE2)
+        decode_strings(strings, n, out, ClassifySse2());
+#elif defined(CSD_BATCH_NEON)
+        decode_strings(strings, n, out, ClassifyNeon());
+#else
+        decode_strings(strings, n, out, ClassifyScalar());
+#endif
+    }
+}  // namespace
+
+namespace csd {
+    auto to_decimal_batch(const char *const *csd, size_t n, double *out) -> void {
+        detail::ScopedMetric metric(MetricFunction::ToDecimalBatch);
+        metric.set_size(n);
+        decode_batch(TerminatedStrings{csd}, n, out);
+    }
+
+    auto to_decimal_batch(const std::string *csd, size_t n, double *out) -> void {
+        detail::ScopedMetric metric(MetricFunction::ToDecimalBatch);
+        metric.set_size(n);
+        decode_batch(StdStrings{csd}, n, out);
+    }
+
+    auto to_decimal_batch(const char *const *csd, const size_t *sizes, size_t n, double *out)
+        -> void {
+        detail::ScopedMetric metric(MetricFunction::ToDecimalBatch);
+        metric.set_size(n);
+        decode_batch(CharRanges{csd, sizes}, n, out);
+    }
+}  // namespace csd
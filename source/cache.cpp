@@ -0,0 +1,242 @@
+/// @file cache.cpp
+#include <csd/cache.hpp>  // for CsdCache
+#include <csd/csd.hpp>    // for to_csd_into, to_csdfixed_into
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uint64_t, uint32_t
+#include <cstring>        // for memcpy
+#include <memory>         // for unique_ptr
+#include <mutex>          // for mutex, lock_guard
+#include <string>         // for basic_string
+#include <vector>         // for vector
+
+using std::size_t;
+using std::string;
+using std::uint64_t;
+
+namespace {
+    /** Number of independently locked shards (a power of two) */
+    constexpr size_t shard_count = 16U;
+
+    /** Slots per set */
+    constexpr size_t ways = 4U;
+
+    /** Which conversion a slot caches */
+    enum class Kind : unsigned char { Empty, Csd, CsdFixed };
+
+    struct Slot {
+        uint64_t bits;
+        int param;
+        Kind kind;
+        string csd;
+    };
+
+    struct Set {
+        Slot slots[ways];
+        unsigned char victim;  ///< next slot to replace when the set is full
+    };
+
+    /**
+     * @brief One independently locked part of the table
+     */
+    struct Shard {
+        std::mutex mutex;
+        std::vector<Set> sets;
+        size_t payload_bytes;  ///< heap storage of the cached strings
+        size_t payload_budget;
+        size_t entries;
+        uint64_t hits;
+        uint64_t misses;
+    };
+
+    /**
+     * @brief Heap bytes held by a string (none while it fits in place)
+     */
+    auto heap_bytes(const string &csd) -> size_t {
+        static const auto inline_capacity = string().capacity();
+        return csd.capacity() > inline_capacity ? csd.capacity() + 1U : 0U;
+    }
+
+    /**
+     * @brief splitmix64 finalizer of the key
+     */
+    auto hash_key(uint64_t bits, int param, Kind kind) -> uint64_t {
+        auto x = bits ^ (uint64_t(std::uint32_t(param)) << 8U) ^ uint64_t(kind);
+        x += 0x9E3779B97F4A7C15U;
+        x = (x ^ (x >> 30U)) * 0xBF58476D1CE4E5B9U;
+        x = (x ^ (x >> 27U)) * 0x94D049BB133111EBU;
+        return x ^ (x >> 31U);
+    }
+
+    auto bits_of(double value) -> uint64_t {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        return bits;
+    }
+}  // namespace
+
+namespace csd {
+    struct CsdCache::Impl {
+        Shard shards[shard_count];
+        size_t sets_per_shard;  // a power of two
+
+        explicit Impl(size_t max_bytes) : shards(), sets_per_shard(1U) {
+            // Half the budget for the slots, half for the strings they own
+            auto const slot_budget = max_bytes / 2U / shard_count;
+            while (2U * sets_per_shard * sizeof(Set) <= slot_budget) {
+                sets_per_shard *= 2U;
+            }
+            auto const payload_budget
+                = (max_bytes > shard_count * sets_per_shard * sizeof(Set)
+                       ? max_bytes - shard_count * sets_per_shard * sizeof(Set)
+                       : size_t{0U})
+                  / shard_count;
+            for (auto &shard : shards) {
+                shard.sets.resize(sets_per_shard);
+                shard.payload_bytes = 0U;
+                shard.payload_budget = payload_budget;
+                shard.entries = 0U;
+                shard.hits = 0U;
+                shard.misses = 0U;
+            }
+        }
+
+        /**
+         * @brief Look the key up, and convert and store it on a miss
+         *
+         * The conversion runs outside the lock, so a slow conversion never
+         * blocks other threads on the shard; if two threads miss on the same
+         * key, both convert and the second store finds the key present.
+         */
+        template <typename Convert>
+        auto lookup(double value, int param, Kind kind, string &out, Convert convert) -> size_t {
+            auto const bits = bits_of(value);
+            auto const hash = hash_key(bits, param, kind);
+            auto &shard = shards[hash >> 60U];
+            auto &set = shard.sets[size_t(hash) & (sets_per_shard - 1U)];
+            auto const matches = [&](const Slot &slot) {
+                return slot.kind == kind && slot.bits == bits && slot.param == param;
+            };
+            {
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (auto &slot : set.slots) {
+                    if (matches(slot)) {
+                        ++shard.hits;
+                        out.assign(slot.csd);
+                        return out.size();
+                    }
+                }
+                ++shard.misses;
+            }
+
+            convert(out);
+
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            Slot *target = nullptr;
+            for (auto &slot : set.slots) {
+                if (matches(slot)) {
+                    return out.size();
+                }
+                if (target == nullptr && slot.kind == Kind::Empty) {
+                    target = &slot;
+                }
+            }
+            if (target == nullptr) {
+                target = &set.slots[set.victim];
+                set.victim = static_cast<unsigned char>((set.victim + 1U) % ways);
+                shard.payload_bytes -= heap_bytes(target->csd);
+                target->kind = Kind::Empty;
+                target->csd = string();
+                --shard.entries;
+            }
+            target->csd.assign(out);
+            auto const payload = heap_bytes(target->csd);
+            if (shard.payload_bytes + payload > shard.payload_budget) {
+                target->csd = string();
+                return out.size();
+            }
+            shard.payload_bytes += payload;
+            target->bits = bits;
+            target->param = param;
+            target->kind = kind;
+            ++shard.entries;
+            return out.size();
+        }
+    };
+
+    CsdCache::CsdCache(size_t max_bytes) : impl_(new Impl(max_bytes)) {}
+
+    CsdCache::~CsdCache() = default;
+
+    auto CsdCache::to_csd(double decimal_value, int places) -> string {
+        string csd;
+        to_csd_into(decimal_value, places, csd);
+        return csd;
+    }
+
+    auto CsdCache::to_csd_into(double decimal_value, int places, string &out) -> size_t {
+        return impl_->lookup(decimal_value, places, Kind::Csd, out, [&](string &res) {
+            csd::to_csd_into(decimal_value, places, res);
+        });
+    }
+
+    auto CsdCache::to_csdfixed(double decimal_value, unsigned int nnz) -> string {
+        string csd;
+        to_csdfixed_into(decimal_value, nnz, csd);
+        return csd;
+    }
+
+    auto CsdCache::to_csdfixed_into(double decimal_value, unsigned int nnz, string &out)
+        -> size_t {
+        return impl_->lookup(decimal_value, int(nnz), Kind::CsdFixed, out, [&](string &res) {
+            csd::to_csdfixed_into(decimal_value, nnz, res);
+        });
+    }
+
+    auto CsdCache::hits() const -> uint64_t {
+        auto sum = uint64_t{0U};
+        for (auto &shard : impl_->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            sum += shard.hits;
+        }
+        return sum;
+    }
+
+    auto CsdCache::misses() const -> uint64_t {
+        auto sum = uint64_t{0U};
+        for (auto &shard : impl_->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            sum += shard.misses;
+        }
+        return sum;
+    }
+
+    auto CsdCache::size() const -> size_t {
+        auto sum = size_t{0U};
+        for (auto &shard : impl_->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            sum += shard.entries;
+        }
+        return sum;
+    }
+
+    auto CsdCache::capacity() const -> size_t {
+        return shard_count * impl_->sets_per_shard * ways;
+    }
+
+    auto CsdCache::clear() -> void {
+        for (auto &shard : impl_->shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto &set : shard.sets) {
+                for (auto &slot : set.slots) {
+                    slot.kind = Kind::Empty;
+                    slot.csd = string();
+                }
+                set.victim = 0U;
+            }
+            shard.payload_bytes = 0U;
+            shard.entries = 0U;
+            shard.hits = 0U;
+            shard.misses = 0U;
+        }
+    }
+}  // namespace csd
@@ -0,0 +1,136 @@
+/// @file decode_lut.cpp
+#include <csd/csd.hpp>  // for to_decimal, to_decimal_using_lut
+#include <cstddef>      // for size_t
+#include <cstdint>      // for uint64_t, uint8_t, int64_t, int8_t
+#include <cstring>      // for memchr, memcpy, strlen
+#include <stdexcept>    // for invalid_argument
+
+using std::size_t;
+
+namespace {
+    /** Digits decoded per lookup in the chunk table */
+    constexpr unsigned int chunk_digits = 4U;
+
+    /** Longest integral part decoded by table (the scalar decoder works in an int) */
+    constexpr size_t max_lut_integral = 31U;
+
+    /** Longest fractional part whose sum is exact in a double */
+    constexpr size_t max_lut_frac = 53U;
+
+    /** Code flagging a character that is not a digit */
+    constexpr std::uint8_t invalid_code = 0x80U;
+
+    /**
+     * @brief The lookup tables of the chunk decoder, 512 bytes in all
+     *
+     * `code` maps a character to its two-bit digit code, '0' to 0, '+' to 1
+     * and '-' to 2, and anything else to `invalid_code`. `value` maps the
+     * codes of four digits, the first one in the top two bits, to the value
+     * of the chunk.
+     */
+    struct ChunkTables {
+        std::uint8_t code[256];
+        std::int8_t value[1U << (2U * chunk_digits)];
+
+        ChunkTables() : code(), value() {
+            for (auto &entry : code) {
+                entry = invalid_code;
+            }
+            code[static_cast<unsigned char>('0')] = 0U;
+            code[static_cast<unsigned char>('+')] = 1U;
+            code[static_cast<unsigned char>('-')] = 2U;
+            for (auto index = 0U; index != 1U << (2U * chunk_digits); ++index) {
+                auto sum = 0;
+                for (auto shift = 2U * chunk_digits; shift != 0U; shift -= 2U) {
+                    auto const digit = (index >> (shift - 2U)) & 3U;
+                    sum = 2 * sum + (digit == 1U ? 1 : digit == 2U ? -1 : 0);
+                }
+                value[index] = static_cast<std::int8_t>(sum);
+            }
+        }
+    };
+
+    const ChunkTables tables{};
+
+    inline auto code_of(char digit) -> unsigned int {
+        return tables.code[static_cast<unsigned char>(digit)];
+    }
+
+    /**
+     * @brief Decode up to 62 digits, four at a time
+     *
+     * The invalid flags of all the codes are accumulated and checked once at
+     * the end, so the loop has no data-dependent branches.
+     *
+     * @param[in] csd - The digits
+     * @param[in] n - Number of digits
+     * @param[out] value - The integer value of the digits
+     * @return false if a character is not a digit
+     */
+    inline auto decode_digits(const char *csd, size_t n, std::int64_t &value) -> bool {
+        auto acc = std::int64_t{0};
+        auto flags = 0U;
+        for (; n >= chunk_digits; n -= chunk_digits, csd += chunk_digits) {
+            auto const c0 = code_of(csd[0]);
+            auto const c1 = code_of(csd[1]);
+            auto const c2 = code_of(csd[2]);
+            auto const c3 = code_of(csd[3]);
+            flags |= c0 | c1 | c2 | c3;
+            auto const index = ((c0 << 6U) | (c1 << 4U) | (c2 << 2U) | c3) & 0xFFU;
+            acc = acc * (std::int64_t{1} << chunk_digits) + tables.value[index];
+        }
+        for (; n != 0U; --n, ++csd) {
+            auto const c0 = code_of(*csd);
+            flags |= c0;
+            acc = acc * 2 + tables.value[c0 & 3U];
+        }
+        value = acc;
+        return (flags & invalid_code) == 0U;
+    }
+
+    /**
+     * @brief 2^-k for k <= 53, from its exponent bits
+     *
+     * `ldexp` goes through the general (and on some C libraries slow) path
+     * for a value that is just an exponent.
+     */
+    inline auto inverse_power_of_two(size_t k) -> double {
+        auto const bits = std::uint64_t{1023U - k} << 52U;
+        double scale;
+        std::memcpy(&scale, &bits, sizeof scale);
+        return scale;
+    }
+}  // namespace
+
+namespace csd {
+    /**
+     * @brief Convert a CSD string to a decimal with a chunk lookup table
+     *
+     * The integral and the fractional digits are each decoded into an
+     * integer, four digits per lookup, and the fractional integer is scaled
+     * once at the end. Both are exact, so the result is the same as that of
+     * `to_decimal`; longer strings are passed to `to_decimal`.
+     */
+    auto to_decimal_using_lut(const char *csd) -> double {
+        auto const length = std::strlen(csd);
+        auto const *point = static_cast<const char *>(std::memchr(csd, '.', length));
+        auto const integral_length = point != nullptr ? size_t(point - csd) : length;
+        auto const frac_length = point != nullptr ? length - integral_length - 1U : size_t{0U};
+        if (integral_length > max_lut_integral || frac_length > max_lut_frac) {
+            return to_decimal(csd);
+        }
+
+        auto integral = std::int64_t{0};
+        if (!decode_digits(csd, integral_length, integral)) {
+            CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
+        }
+        if (point == nullptr) {
+            return double(integral);
+        }
+        auto fractional = std::int64_t{0};
+        if (!decode_digits(point + 1, frac_length, fractional)) {
+            CSD_THROW(std::invalid_argument("Fractional part work with 0, +, and - only"));
+        }
+        return double(integral) + double(fractional) * inverse_power_of_two(frac_length);
+    }
+}  // namespace csd
@@ -0,0 +1,416 @@
+/// @file fir.cpp
+#include <algorithm>          // for max, min, fill, sort
+#include <csd/fir.hpp>        // for CsdFir, FirFormat, FirOverflow
+#include <csd/shift_add.hpp>  // for to_shift_add, ShiftAddProgram
+#include <cstddef>            // for size_t
+#include <cstdint>            // for int32_t, int64_t, uint32_t, uint64_t
+#include <cstring>            // for memcpy, memmove
+#include <stdexcept>          // for invalid_argument, length_error
+#include <string>             // for basic_string
+#include <tuple>              // for tuple, get
+#include <vector>             // for vector
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#    include <immintrin.h>
+#    define CSD_FIR_AVX2 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#    include <arm_neon.h>
+#    define CSD_FIR_NEON 1
+#endif
+
+using std::int32_t;
+using std::int64_t;
+using std::size_t;
+using std::vector;
+using csd::detail::FirColumn;
+
+namespace {
+    /** Smallest k with 2^k >= n */
+    auto ceil_log2(size_t n) -> unsigned int {
+        auto bits = 0U;
+        while ((size_t{1} << bits) < n) {
+            ++bits;
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Add the shifted samples of every column to `count` accumulators
+     *
+     * Accumulator i gets `window[offset + i] << shift` for each added
+     * offset of a column, minus the same for each subtracted one; the
+     * arithmetic is done unsigned, which gives the two's complement result
+     * without signed overflow or left shifts of negative numbers.
+     */
+    template <typename Acc, typename UAcc>
+    auto accumulate_scalar(const vector<FirColumn> &columns, const size_t *offsets,
+                           const int32_t *window, Acc *acc, size_t count) -> void {
+        for (auto const &column : columns) {
+            auto const shift = column.shift;
+            for (auto t = column.first; t != column.last; ++t) {
+                auto const *const src = window + offsets[t];
+                if (t >= column.negative) {
+                    for (size_t i = 0U; i != count; ++i) {
+                        acc[i] = static_cast<Acc>(static_cast<UAcc>(acc[i])
+                                                  - (static_cast<UAcc>(Acc{src[i]}) << shift));
+                    }
+                } else {
+                    for (size_t i = 0U; i != count; ++i) {
+                        acc[i] = static_cast<Acc>(static_cast<UAcc>(acc[i])
+                                                  + (static_cast<UAcc>(Acc{src[i]}) << shift));
+                    }
+                }
+            }
+        }
+    }
+
+#if defined(CSD_FIR_AVX2)
+    /**
+     * 32 outputs per step, in four vectors that stay in registers through
+     * all the columns, so that each step loads and stores them only once;
+     * a column sums its samples in four more, then shifts them once
+     */
+    __attribute__((target("avx2"))) auto accumulate_avx2(const vector<FirColumn> &columns,
+                                                         const size_t *offsets,
+                                                         const int32_t *window, int32_t *acc,
+                                                         size_t count) -> void {
+        auto const steps = count / 32U * 32U;
+        for (size_t i = 0U; i != steps; i += 32U) {
+            auto *const dst = reinterpret_cast<__m256i *>(acc + i);
+            auto s0 = _mm256_loadu_si256(dst);
+            auto s1 = _mm256_loadu_si256(dst + 1);
+            auto s2 = _mm256_loadu_si256(dst + 2);
+            auto s3 = _mm256_loadu_si256(dst + 3);
+            for (auto const &column : columns) {
+                auto c0 = _mm256_setzero_si256();
+                auto c1 = _mm256_setzero_si256();
+                auto c2 = _mm256_setzero_si256();
+                auto c3 = _mm256_setzero_si256();
+                for (auto t = column.first; t != column.negative; ++t) {
+                    auto const *const src
+                        = reinterpret_cast<const __m256i *>(window + offsets[t] + i);
+                    c0 = _mm256_add_epi32(c0, _mm256_loadu_si256(src));
+                    c1 = _mm256_add_epi32(c1, _mm256_loadu_si256(src + 1));
+                    c2 = _mm256_add_epi32(c2, _mm256_loadu_si256(src + 2));
+                    c3 = _mm256_add_epi32(c3, _mm256_loadu_si256(src + 3));
+                }
+                for (auto t = column.negative; t != column.last; ++t) {
+                    auto const *const src
+                        = reinterpret_cast<const __m256i *>(window + offsets[t] + i);
+                    c0 = _mm256_sub_epi32(c0, _mm256_loadu_si256(src));
+                    c1 = _mm256_sub_epi32(c1, _mm256_loadu_si256(src + 1));
+                    c2 = _mm256_sub_epi32(c2, _mm256_loadu_si256(src + 2));
+                    c3 = _mm256_sub_epi32(c3, _mm256_loadu_si256(src + 3));
+                }
+                auto const shift = _mm_cvtsi32_si128(static_cast<int>(column.shift));
+                s0 = _mm256_add_epi32(s0, _mm256_sll_epi32(c0, shift));
+                s1 = _mm256_add_epi32(s1, _mm256_sll_epi32(c1, shift));
+                s2 = _mm256_add_epi32(s2, _mm256_sll_epi32(c2, shift));
+                s3 = _mm256_add_epi32(s3, _mm256_sll_epi32(c3, shift));
+            }
+            _mm256_storeu_si256(dst, s0);
+            _mm256_storeu_si256(dst + 1, s1);
+            _mm256_storeu_si256(dst + 2, s2);
+            _mm256_storeu_si256(dst + 3, s3);
+        }
+        accumulate_scalar<int32_t, std::uint32_t>(columns, offsets, window + steps, acc + steps,
+                                                  count - steps);
+    }
+
+    /** 16 outputs per step, the samples sign-extended to 64 bits */
+    __attribute__((target("avx2"))) auto accumulate_avx2(const vector<FirColumn> &columns,
+                                                         const size_t *offsets,
+                                                         const int32_t *window, int64_t *acc,
+                                                         size_t count) -> void {
+        auto const steps = count / 16U * 16U;
+        for (size_t i = 0U; i != steps; i += 16U) {
+            auto *const dst = reinterpret_cast<__m256i *>(acc + i);
+            auto s0 = _mm256_loadu_si256(dst);
+            auto s1 = _mm256_loadu_si256(dst + 1);
+            auto s2 = _mm256_loadu_si256(dst + 2);
+            auto s3 = _mm256_loadu_si256(dst + 3);
+            for (auto const &column : columns) {
+                auto c0 = _mm256_setzero_si256();
+                auto c1 = _mm256_setzero_si256();
+                auto c2 = _mm256_setzero_si256();
+                auto c3 = _mm256_setzero_si256();
+                for (auto t = column.first; t != column.negative; ++t) {
+                    auto const *const src
+                        = reinterpret_cast<const __m128i *>(window + offsets[t] + i);
+                    c0 = _mm256_add_epi64(c0, _mm256_cvtepi32_epi64(_mm_loadu_si128(src)));
+                    c1 = _mm256_add_epi64(c1, _mm256_cvtepi32_epi64(_mm_loadu_si128(src + 1)));
+                    c2 = _mm256_add_epi64(c2, _mm256_cvtepi32_epi64(_mm_loadu_si128(src + 2)));
+                    c3 = _mm256_add_epi64(c3, _mm256_cvtepi32_epi64(_mm_loadu_si128(src + 3)));
+                }
+                for (auto t = column.negative; t != column.last; ++t) {
+                    auto const *const src
+                        = reinterpret_cast<const __m128i *>(window + offsets[t] + i);
+                    c0 = _mm256_sub_epi64(c0, _mm256_cvtepi32_epi64(_mm_loadu_si128(src)));
+                    c1 = _mm256_sub_epi64(c1, _mm256_cvtepi32_epi64(_mm_loadu_si128(src + 1)));
+                    c2 = _mm256_sub_epi64(c2, _mm256_cvtepi32_epi64(_mm_loadu_si128(src + 2)));
+                    c3 = _mm256_sub_epi64(c3, _mm256_cvtepi32_epi64(_mm_loadu_si128(src + 3)));
+                }
+                auto const shift = _mm_cvtsi32_si128(static_cast<int>(column.shift));
+                s0 = _mm256_add_epi64(s0, _mm256_sll_epi64(c0, shift));
+                s1 = _mm256_add_epi64(s1, _mm256_sll_epi64(c1, shift));
+                s2 = _mm256_add_epi64(s2, _mm256_sll_epi64(c2, shift));
+                s3 = _mm256_add_epi64(s3, _mm256_sll_epi64(c3, shift));
+            }
+            _mm256_storeu_si256(dst, s0);
+            _mm256_storeu_si256(dst + 1, s1);
+            _mm256_storeu_si256(dst + 2, s2);
+            _mm256_storeu_si256(dst + 3, s3);
+        }
+        accumulate_scalar<int64_t, std::uint64_t>(columns, offsets, window + steps, acc + steps,
+                                                  count - steps);
+    }
+
+    auto has_avx2() -> bool {
+        static const bool avx2 = __builtin_cpu_supports("avx2") != 0;
+        return avx2;
+    }
+#endif
+
+#if defined(CSD_FIR_NEON)
+    /** 16 outputs per step, kept in registers like the AVX2 version */
+    auto accumulate_neon(const vector<FirColumn> &columns, const size_t *offsets,
+                         const int32_t *window, int32_t *acc, size_t count) -> void {
+        auto const steps = count / 16U * 16U;
+        for (size_t i = 0U; i != steps; i += 16U) {
+            auto *const dst = acc + i;
+            auto s0 = vld1q_s32(dst);
+            auto s1 = vld1q_s32(dst + 4);
+            auto s2 = vld1q_s32(dst + 8);
+            auto s3 = vld1q_s32(dst + 12);
+            for (auto const &column : columns) {
+                auto c0 = vdupq_n_s32(0);
+                auto c1 = vdupq_n_s32(0);
+                auto c2 = vdupq_n_s32(0);
+                auto c3 = vdupq_n_s32(0);
+                for (auto t = column.first; t != column.negative; ++t) {
+                    auto const *const src = window + offsets[t] + i;
+                    c0 = vaddq_s32(c0, vld1q_s32(src));
+                    c1 = vaddq_s32(c1, vld1q_s32(src + 4));
+                    c2 = vaddq_s32(c2, vld1q_s32(src + 8));
+                    c3 = vaddq_s32(c3, vld1q_s32(src + 12));
+                }
+                for (auto t = column.negative; t != column.last; ++t) {
+                    auto const *const src = window + offsets[t] + i;
+                    c0 = vsubq_s32(c0, vld1q_s32(src));
+                    c1 = vsubq_s32(c1, vld1q_s32(src + 4));
+                    c2 = vsubq_s32(c2, vld1q_s32(src + 8));
+                    c3 = vsubq_s32(c3, vld1q_s32(src + 12));
+                }
+                auto const shift = vdupq_n_s32(static_cast<int32_t>(column.shift));
+                s0 = vaddq_s32(s0, vshlq_s32(c0, shift));
+                s1 = vaddq_s32(s1, vshlq_s32(c1, shift));
+                s2 = vaddq_s32(s2, vshlq_s32(c2, shift));
+                s3 = vaddq_s32(s3, vshlq_s32(c3, shift));
+            }
+            vst1q_s32(dst, s0);
+            vst1q_s32(dst + 4, s1);
+            vst1q_s32(dst + 8, s2);
+            vst1q_s32(dst + 12, s3);
+        }
+        accumulate_scalar<int32_t, std::uint32_t>(columns, offsets, window + steps, acc + steps,
+                                                  count - steps);
+    }
+
+    /** 8 outputs per step, the samples sign-extended to 64 bits */
+    auto accumulate_neon(const vector<FirColumn> &columns, const size_t *offsets,
+                         const int32_t *window, int64_t *acc, size_t count) -> void {
+        auto const steps = count / 8U * 8U;
+        for (size_t i = 0U; i != steps; i += 8U) {
+            auto *const dst = acc + i;
+            auto s0 = vld1q_s64(dst);
+            auto s1 = vld1q_s64(dst + 2);
+            auto s2 = vld1q_s64(dst + 4);
+            auto s3 = vld1q_s64(dst + 6);
+            for (auto const &column : columns) {
+                auto c0 = vdupq_n_s64(0);
+                auto c1 = vdupq_n_s64(0);
+                auto c2 = vdupq_n_s64(0);
+                auto c3 = vdupq_n_s64(0);
+                for (auto t = column.first; t != column.negative; ++t) {
+                    auto const low = vld1q_s32(window + offsets[t] + i);
+                    auto const high = vld1q_s32(window + offsets[t] + i + 4U);
+                    c0 = vaddw_s32(c0, vget_low_s32(low));
+                    c1 = vaddw_high_s32(c1, low);
+                    c2 = vaddw_s32(c2, vget_low_s32(high));
+                    c3 = vaddw_high_s32(c3, high);
+                }
+                for (auto t = column.negative; t != column.last; ++t) {
+                    auto const low = vld1q_s32(window + offsets[t] + i);
+                    auto const high = vld1q_s32(window + offsets[t] + i + 4U);
+                    c0 = vsubw_s32(c0, vget_low_s32(low));
+                    c1 = vsubw_high_s32(c1, low);
+                    c2 = vsubw_s32(c2, vget_low_s32(high));
+                    c3 = vsubw_high_s32(c3, high);
+                }
+                auto const shift = vdupq_n_s64(static_cast<int64_t>(column.shift));
+                s0 = vaddq_s64(s0, vshlq_s64(c0, shift));
+                s1 = vaddq_s64(s1, vshlq_s64(c1, shift));
+                s2 = vaddq_s64(s2, vshlq_s64(c2, shift));
+                s3 = vaddq_s64(s3, vshlq_s64(c3, shift));
+            }
+            vst1q_s64(dst, s0);
+            vst1q_s64(dst + 2, s1);
+            vst1q_s64(dst + 4, s2);
+            vst1q_s64(dst + 6, s3);
+        }
+        accumulate_scalar<int64_t, std::uint64_t>(columns, offsets, window + steps, acc + steps,
+                                                  count - steps);
+    }
+#endif
+
+    auto accumulate(const vector<FirColumn> &columns, const size_t *offsets,
+                    const int32_t *window, int32_t *acc, size_t count) -> void {
+#if defined(CSD_FIR_AVX2)
+        if (has_avx2()) {
+            accumulate_avx2(columns, offsets, window, acc, count);
+            return;
+        }
+#elif defined(CSD_FIR_NEON)
+        accumulate_neon(columns, offsets, window, acc, count);
+        return;
+#endif
+        accumulate_scalar<int32_t, std::uint32_t>(columns, offsets, window, acc, count);
+    }
+
+    auto accumulate(const vector<FirColumn> &columns, const size_t *offsets,
+                    const int32_t *window, int64_t *acc, size_t count) -> void {
+#if defined(CSD_FIR_AVX2)
+        if (has_avx2()) {
+            accumulate_avx2(columns, offsets, window, acc, count);
+            return;
+        }
+#elif defined(CSD_FIR_NEON)
+        accumulate_neon(columns, offsets, window, acc, count);
+        return;
+#endif
+        accumulate_scalar<int64_t, std::uint64_t>(columns, offsets, window, acc, count);
+    }
+
+    auto to_programs(const vector<std::string> &csds) -> vector<csd::ShiftAddProgram> {
+        vector<csd::ShiftAddProgram> programs;
+        programs.reserve(csds.size());
+        for (auto const &csd : csds) {
+            programs.push_back(csd::to_shift_add(csd.c_str()));
+        }
+        return programs;
+    }
+}  // namespace
+
+namespace csd {
+    constexpr size_t CsdFir::block_size;
+
+    /**
+     * Every coefficient is scaled to the largest fraction, so that all the
+     * products share one final right shift. Its digits are then sorted by
+     * weight into columns, the sum of the products being the sum of the
+     * columns' samples shifted by their weights; tap k reads the window at
+     * `history_ - k`, the window holding the last `history_` samples of
+     * the previous block before the current one.
+     */
+    CsdFir::CsdFir(const vector<ShiftAddProgram> &taps, const FirFormat &format)
+        : format_(format),
+          columns_(),
+          offsets_(),
+          history_(taps.empty() ? 0U : taps.size() - 1U),
+          frac_(0U),
+          wide_(false),
+          window_(),
+          acc32_(),
+          acc64_() {
+        if (taps.empty()) {
+            CSD_THROW(std::invalid_argument("a FIR filter needs at least one tap"));
+        }
+        if (format.input_bits - 1U >= 32U || format.output_bits - 1U >= 32U) {
+            CSD_THROW(std::invalid_argument("FIR sample widths must be 1 to 32 bits"));
+        }
+        for (auto const &tap : taps) {
+            frac_ = std::max(frac_, tap.frac);
+        }
+        if (frac_ + format.output_shift > 62U) {
+            CSD_THROW(std::invalid_argument("FIR right shift must be at most 62 bits"));
+        }
+        // (shift, subtracted, offset) of every digit
+        vector<std::tuple<unsigned int, bool, size_t>> digits;
+        for (size_t k = 0U; k != taps.size(); ++k) {
+            for (auto const &term : taps[k].terms) {
+                digits.emplace_back(term.shift + frac_ - taps[k].frac, term.sign < 0, history_ - k);
+            }
+        }
+        std::sort(digits.begin(), digits.end());
+        for (auto const &digit : digits) {
+            auto const shift = std::get<0>(digit);
+            if (columns_.empty() || columns_.back().shift != shift) {
+                auto const first = offsets_.size();
+                columns_.push_back(FirColumn{shift, first, first, first});
+            }
+            if (!std::get<1>(digit)) {
+                ++columns_.back().negative;
+            }
+            offsets_.push_back(std::get<2>(digit));
+            ++columns_.back().last;
+        }
+        // |sum| <= digits * 2^(input_bits - 1 + max_shift)
+        auto const max_shift = columns_.empty() ? 0U : columns_.back().shift;
+        auto const sum_bits = format.input_bits - 1U + max_shift + ceil_log2(digits.size());
+        if (sum_bits > 61U) {
+            CSD_THROW(std::length_error("FIR sums are limited to 62 bits"));
+        }
+        wide_ = sum_bits > 30U;
+        window_.assign(history_ + block_size, 0);
+        if (wide_) {
+            acc64_.resize(block_size);
+        } else {
+            acc32_.resize(block_size);
+        }
+    }
+
+    CsdFir::CsdFir(const vector<std::string> &csds, const FirFormat &format)
+        : CsdFir(to_programs(csds), format) {}
+
+    auto CsdFir::quantize(int64_t sum) const -> int32_t {
+        auto const shift = frac_ + format_.output_shift;
+        if (format_.round && shift != 0U) {
+            sum += int64_t{1} << (shift - 1U);
+        }
+        auto const value = sum >> shift;
+        auto const bits = format_.output_bits;
+        if (format_.overflow == FirOverflow::Saturate) {
+            auto const high = (int64_t{1} << (bits - 1U)) - 1;
+            return static_cast<int32_t>(std::min(std::max(value, -high - 1), high));
+        }
+        // Keep the low bits, then sign-extend from the top one
+        auto const mask = (std::uint64_t{1} << bits) - 1U;
+        auto const sign = std::uint64_t{1} << (bits - 1U);
+        auto const low = static_cast<std::uint64_t>(value) & mask;
+        return static_cast<int32_t>(static_cast<int64_t>(low ^ sign) - static_cast<int64_t>(sign));
+    }
+
+    auto CsdFir::filter(const int32_t *in, int32_t *out, size_t n) -> void {
+        for (size_t first = 0U; first < n; first += block_size) {
+            auto const count = std::min(n - first, block_size);
+            std::memcpy(window_.data() + history_, in + first, count * sizeof(int32_t));
+            if (wide_) {
+                std::fill(acc64_.begin(), acc64_.end(), 0);
+                accumulate(columns_, offsets_.data(), window_.data(), acc64_.data(), count);
+                for (size_t i = 0U; i != count; ++i) {
+                    out[first + i] = quantize(acc64_[i]);
+                }
+            } else {
+                std::fill(acc32_.begin(), acc32_.end(), 0);
+                accumulate(columns_, offsets_.data(), window_.data(), acc32_.data(), count);
+                for (size_t i = 0U; i != count; ++i) {
+                    out[first + i] = quantize(acc32_[i]);
+                }
+            }
+            // The last samples seen become the history of the next block
+            std::memmove(window_.data(), window_.data() + count, history_ * sizeof(int32_t));
+        }
+    }
+
+    auto CsdFir::reset() -> void { std::fill(window_.begin(), window_.end(), 0); }
+}  // namespace csd
@@ -0,0 +1,79 @@
+/// @file generator.cpp
+#include <cmath>              // for fabs, ceil, log2, frexp, ldexp
+#include <csd/generator.hpp>  // for CsdGenerator, CsdDigit
+#include <cstdint>            // for uint64_t
+#include <cstring>            // for memcpy
+
+namespace {
+    /**
+     * @brief 2^exp, from its exponent bits when it is a normal double
+     *
+     * Exactly the value the reference loop reaches by halving.
+     */
+    inline auto power_of_two(int exp) -> double {
+        if (exp < -1022 || exp > 1023) {
+            return std::ldexp(1.0, exp);
+        }
+        auto const bits = std::uint64_t(exp + 1023) << 52U;
+        double res;
+        std::memcpy(&res, &bits, sizeof res);
+        return res;
+    }
+}  // namespace
+
+namespace csd {
+    CsdGenerator::CsdGenerator(double decimal_value)
+        : value_(decimal_value), residual_(decimal_value), p2n_(1.0), rem_(0), nnz_(0U) {
+        auto const absnum = std::fabs(decimal_value);
+        if (absnum >= 1.0) {
+            rem_ = int(std::ceil(std::log2(absnum * 1.5)));
+        }
+        p2n_ = power_of_two(rem_);
+    }
+
+    auto CsdGenerator::step() -> int {
+        p2n_ /= 2.0;
+        rem_ -= 1;
+        auto const det = 1.5 * residual_;
+        if (det > p2n_) {
+            residual_ -= p2n_;
+            ++nnz_;
+            return 1;
+        }
+        if (det < -p2n_) {
+            residual_ += p2n_;
+            ++nnz_;
+            return -1;
+        }
+        return 0;
+    }
+
+    auto CsdGenerator::next_nonzero(int lowest, CsdDigit &digit) -> bool {
+        auto const top = position();
+        if (lowest > top) {
+            return false;
+        }
+        // The largest k with 2^k < |det| is the first position `step` accepts
+        auto const det = std::fabs(1.5 * residual_);
+        auto k = lowest - 1;
+        if (det != 0.0) {
+            auto exp = 0;
+            auto const mantissa = std::frexp(det, &exp);
+            k = mantissa == 0.5 ? exp - 2 : exp - 1;
+        }
+        if (k > top) {
+            k = top;
+        }
+        if (k < lowest) {
+            rem_ = lowest;
+            p2n_ = power_of_two(rem_);
+            return false;
+        }
+        // All the digits above k are zeros
+        rem_ = k + 1;
+        p2n_ = power_of_two(rem_);
+        digit.position = k;
+        digit.sign = step();
+        return true;
+    }
+}  // namespace csd
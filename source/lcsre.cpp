@@ -1,11 +1,19 @@
 /// @file lcsre.cpp
+#include <algorithm>        // for max, min, fill, swap, sort, upper_bound
+#include <csd/lcsre.hpp>    // for LcsreEngine, longest_repeated_substring, shared_patterns
+#include <csd/metrics.hpp>  // for ScopedMetric, MetricFunction
+#include <cstddef>          // for size_t, ptrdiff_t
+#include <set>              // for set
 #include <string>
 #include <vector>
 
+using std::size_t;
 using std::string;
 using std::vector;
 
-namespace csd {
+namespace {
+    using csd::LcsreEngine;
+
     /**
      * Finds the longest repeated substring in the given string.
      *
@@ -18,16 +26,8 @@ namespace csd {
      * it returns an empty string.
      *
      * Time complexity is O(n^2) where n is length of input string.
-     *
-     * @param[in] sv The parameter `sv` is a pointer to a character array, which
-     * represents the input string. It is assumed that the string is
-     * null-terminated.
-     * @param[in] n The parameter `n` represents the length of the input string `sv`.
-     *
-     * @return The function `longest_repeated_substring` returns a string, which is
-     * the longest repeated substring in the given input string `sv`.
      */
-    auto longest_repeated_substring(const char *sv, size_t len) -> string {
+    auto lcsre_dynamic_programming(const char *sv, size_t len) -> string {
         auto ndim = len + 1;
         auto lcsre = vector<vector<unsigned int>>(ndim, vector<unsigned int>(ndim, 0U));
 
@@ -63,7 +63,7 @@ namespace csd {
 
         auto res = string("");  // To store result
         if (res_length > 0) {
-            res = string(sv).substr(index - res_length, res_length);
+            res = string(sv + (index - res_length), res_length);
             // for (auto i = index - res_length + 1; i != index + 1; ++i) {
             //     res += sv[i - 1];
             // }
@@ -73,4 +73,504 @@ namespace csd {
     }
 
     // This code is contributed by ita_c
+
+    /**
+     * Finds the longest repeated substring keeping only two rows of the DP table.
+     *
+     * Row i of the table only depends on row i - 1 at column j - 1, so the
+     * previous and the current row live in one flat buffer of 2 (n + 1)
+     * entries and swap roles after every row. The inner loop has no branches
+     * left (the match and the non-overlap check are combined arithmetically),
+     * which lets the compiler vectorize it. This performs the same comparisons in the same row order
+     * as `lcsre_dynamic_programming` and returns the same substring, with
+     * O(n) memory and a single allocation instead of O(n^2) and n + 1.
+     */
+    auto lcsre_rolling_row(const char *sv, size_t len) -> string {
+        auto const ndim = len + 1;
+        auto rows = vector<unsigned int>(2 * ndim, 0U);
+        auto *prev = rows.data();
+        auto *cur = prev + ndim;
+
+        auto res_length = 0U;
+        auto index = size_t{0U};
+        for (auto i = size_t{1U}; i < ndim; ++i) {
+            auto const row_char = sv[i - 1];
+            auto row_max = 0U;
+            // Column j = i + 1 + k, so that k + 1 is the distance j - i
+            auto const *const chars = sv + i;
+            auto const *const diag = prev + i;
+            auto *const row = cur + i + 1;
+            auto const count = static_cast<unsigned int>(ndim - i - 1);
+            for (auto k = 0U; k < count; ++k) {
+                // (j-i) > lcsre[i-1][j-1] to remove overlapping
+                auto const match = unsigned(chars[k] == row_char) & unsigned(diag[k] <= k);
+                auto const length = match * (diag[k] + 1U);
+                row[k] = length;
+                row_max = row_max < length ? length : row_max;
+            }
+            if (row_max > res_length) {
+                res_length = row_max;
+                index = i;
+            }
+            std::swap(prev, cur);
+        }
+
+        if (res_length == 0U) {
+            return string("");
+        }
+        return string(sv + (index - res_length), res_length);
+    }
+
+    /**
+     * @brief Suffix array by prefix doubling with radix sort
+     *
+     * @param[in] text The symbols of the text, each less than `alphabet`
+     * @param[in] alphabet The number of distinct symbol values
+     *
+     * @return The starting positions of the suffixes of `text` in sorted order.
+     * Time complexity is O(n log n).
+     */
+    auto suffix_array(const vector<size_t> &text, size_t alphabet) -> vector<size_t> {
+        auto const n = text.size();
+        auto sa = vector<size_t>(n);
+        if (n == 0U) {
+            return sa;
+        }
+        auto rank = vector<size_t>(n);
+        auto tmp = vector<size_t>(n);
+        auto count = vector<size_t>(std::max(alphabet, n) + 1U, 0U);
+
+        // Counting sort by the first symbol
+        for (auto symbol : text) {
+            ++count[symbol + 1U];
+        }
+        for (size_t c = 1U; c != count.size(); ++c) {
+            count[c] += count[c - 1U];
+        }
+        for (size_t i = 0U; i != n; ++i) {
+            sa[count[text[i]]++] = i;
+        }
+        auto classes = size_t{1U};
+        rank[sa[0]] = 0U;
+        for (size_t j = 1U; j != n; ++j) {
+            if (text[sa[j]] != text[sa[j - 1U]]) {
+                ++classes;
+            }
+            rank[sa[j]] = classes - 1U;
+        }
+
+        // Sort by the first 2k symbols, knowing the order of the first k
+        for (size_t k = 1U; classes < n; k <<= 1U) {
+            // Order by the second half: suffixes shorter than k come first
+            auto pos = size_t{0U};
+            for (auto i = n - k; i != n; ++i) {
+                tmp[pos++] = i;
+            }
+            for (size_t j = 0U; j != n; ++j) {
+                if (sa[j] >= k) {
+                    tmp[pos++] = sa[j] - k;
+                }
+            }
+
+            // Stable counting sort by the first half
+            std::fill(count.begin(), count.begin() + static_cast<std::ptrdiff_t>(classes + 1U), 0U);
+            for (size_t i = 0U; i != n; ++i) {
+                ++count[rank[i] + 1U];
+            }
+            for (size_t c = 1U; c <= classes; ++c) {
+                count[c] += count[c - 1U];
+            }
+            for (size_t j = 0U; j != n; ++j) {
+                sa[count[rank[tmp[j]]]++] = tmp[j];
+            }
+
+            // New equivalence classes
+            auto second = [&](size_t i) { return i + k < n ? rank[i + k] + 1U : 0U; };
+            tmp[sa[0]] = 0U;
+            classes = 1U;
+            for (size_t j = 1U; j != n; ++j) {
+                auto const cur = sa[j];
+                auto const prev = sa[j - 1U];
+                if (rank[cur] != rank[prev] || second(cur) != second(prev)) {
+                    ++classes;
+                }
+                tmp[cur] = classes - 1U;
+            }
+            std::swap(rank, tmp);
+        }
+        return sa;
+    }
+
+    /**
+     * @brief Longest common prefix of adjacent suffixes (Kasai's algorithm)
+     *
+     * @return lcp[j] is the length of the common prefix of the suffixes
+     * starting at sa[j - 1] and sa[j] (lcp[0] is 0).
+     */
+    template <typename Text>
+    auto lcp_array(const Text &text, const vector<size_t> &sa) -> vector<size_t> {
+        auto const n = sa.size();
+        auto rank = vector<size_t>(n);
+        for (size_t j = 0U; j != n; ++j) {
+            rank[sa[j]] = j;
+        }
+        auto lcp = vector<size_t>(n, 0U);
+        auto h = size_t{0U};
+        for (size_t i = 0U; i != n; ++i) {
+            if (rank[i] == 0U) {
+                h = 0U;
+                continue;
+            }
+            auto const other = sa[rank[i] - 1U];
+            while (i + h < n && other + h < n && text[i + h] == text[other + h]) {
+                ++h;
+            }
+            lcp[rank[i]] = h;
+            if (h > 0U) {
+                --h;
+            }
+        }
+        return lcp;
+    }
+
+    /**
+     * Finds the longest repeated non-overlapping substring with a suffix array.
+     *
+     * Suffixes sharing a prefix of length L are adjacent in the suffix array,
+     * forming a group bounded by LCP values below L. A non-overlapping repeat of
+     * length L exists iff some group spans positions at least L apart, which is
+     * monotone in L, so the length is found by binary search. Among the groups
+     * of the final length, the one with the smallest start position wins, which
+     * is the substring the dynamic programming table reports as well.
+     *
+     * Time complexity is O(n log n) and memory is O(n).
+     */
+    auto lcsre_suffix_array(const char *sv, size_t len) -> string {
+        auto text = vector<size_t>(len);
+        for (size_t i = 0U; i != len; ++i) {
+            text[i] = static_cast<unsigned char>(sv[i]);
+        }
+        auto const sa = suffix_array(text, 256U);
+        auto const lcp = lcp_array(text, sa);
+
+        // Earliest start of a non-overlapping repeat of `length`, or `len` if none
+        auto earliest = [&](size_t length) {
+            auto best = len;
+            auto lo = len;
+            auto hi = size_t{0U};
+            for (size_t j = 0U; j != len; ++j) {
+                if (j == 0U || lcp[j] < length) {
+                    lo = sa[j];
+                    hi = sa[j];
+                } else {
+                    lo = std::min(lo, sa[j]);
+                    hi = std::max(hi, sa[j]);
+                }
+                if (hi - lo >= length) {
+                    best = std::min(best, lo);
+                }
+            }
+            return best;
+        };
+
+        auto lo = size_t{0U};     // a repeat of this length exists
+        auto hi = len / 2U + 1U;  // no repeat of this length exists
+        while (hi - lo > 1U) {
+            auto const mid = lo + (hi - lo) / 2U;
+            if (earliest(mid) != len) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        if (lo == 0U) {
+            return string("");
+        }
+        return string(sv + earliest(lo), lo);
+    }
+
+    /**
+     * @brief Bytes the tables of an engine allocate for a string of `len` characters
+     *
+     * For the suffix array, the peak of the text, the suffix array, the
+     * two rank arrays and the counts.
+     */
+    auto lcsre_table_bytes(LcsreEngine engine, size_t len) -> size_t {
+        auto const ndim = len + 1U;
+        switch (engine) {
+            case LcsreEngine::DynamicProgramming:
+                return ndim * ndim * sizeof(unsigned int);
+            case LcsreEngine::RollingRow:
+                return 2U * ndim * sizeof(unsigned int);
+            case LcsreEngine::SuffixArray:
+            case LcsreEngine::Auto:
+            default:
+                break;
+        }
+        return (4U * len + std::max(len, size_t{256U}) + 1U) * sizeof(size_t);
+    }
+
+    /** Symbols from here on are separators, each used once */
+    constexpr size_t first_separator = 256U;
+
+    /** Left context of an interval: not seen yet, all different, or one common symbol */
+    constexpr size_t no_left = ~size_t{0U};
+    constexpr size_t diverse_left = ~size_t{0U} - 1U;
+
+    auto merge_left(size_t a, size_t b) -> size_t {
+        return a == no_left ? b : a == b ? a : diverse_left;
+    }
+
+    /**
+     * @brief The strings (and their negations) joined into one text of unique separators
+     */
+    struct GeneralizedText {
+        vector<size_t> symbols;
+        vector<size_t> starts;         ///< start of every segment, followed by the size
+        vector<size_t> next_nonzero;   ///< first '+' or '-' at or after every position
+        vector<size_t> nonzero_end;    ///< past the last '+' or '-' before every position, or 0
+        vector<size_t> nonzero_count;  ///< number of '+' and '-' before every position
+        size_t strings;                ///< segments from here on are negated copies
+
+        GeneralizedText(const vector<string> &csds, bool sign_flips)
+            : symbols(),
+              starts(),
+              next_nonzero(),
+              nonzero_end(),
+              nonzero_count(),
+              strings(csds.size()) {
+            auto separator = first_separator;
+            for (auto copy = 0; copy != (sign_flips ? 2 : 1); ++copy) {
+                for (auto const &csd : csds) {
+                    starts.push_back(symbols.size());
+                    for (auto c : csd) {
+                        if (copy == 1 && (c == '+' || c == '-')) {
+                            c = c == '+' ? '-' : '+';
+                        }
+                        // A match never spans the binary point
+                        symbols.push_back(c == '.' ? separator++
+                                                   : size_t(static_cast<unsigned char>(c)));
+                    }
+                    symbols.push_back(separator++);
+                }
+            }
+            starts.push_back(symbols.size());
+            next_nonzero.resize(symbols.size() + 1U, symbols.size());
+            for (auto i = symbols.size(); i != 0U; --i) {
+                next_nonzero[i - 1U] = is_nonzero(i - 1U) ? i - 1U : next_nonzero[i];
+            }
+            nonzero_end.resize(symbols.size() + 1U, 0U);
+            nonzero_count.resize(symbols.size() + 1U, 0U);
+            for (size_t i = 0U; i != symbols.size(); ++i) {
+                auto const nonzero = is_nonzero(i);
+                nonzero_end[i + 1U] = nonzero ? i + 1U : nonzero_end[i];
+                nonzero_count[i + 1U] = nonzero_count[i] + (nonzero ? 1U : 0U);
+            }
+        }
+
+        auto is_nonzero(size_t position) const -> bool {
+            return symbols[position] == size_t('+') || symbols[position] == size_t('-');
+        }
+
+        /** The symbol before a position, or `diverse_left` at the start of a segment */
+        auto left(size_t position) const -> size_t {
+            return position == 0U || symbols[position - 1U] >= first_separator
+                       ? diverse_left
+                       : symbols[position - 1U];
+        }
+
+        auto occurrence(size_t position) const -> csd::PatternOccurrence {
+            auto const segment = size_t(std::upper_bound(starts.begin(), starts.end(), position)
+                                        - starts.begin())
+                                 - 1U;
+            return csd::PatternOccurrence{segment % strings, position - starts[segment],
+                                          segment >= strings};
+        }
+    };
+
+    /**
+     * A maximal repeat: the suffixes sa[lb..rb] share their first symbols, of
+     * which the pattern is the `length` from `offset` on
+     */
+    struct Candidate {
+        size_t lb;
+        size_t rb;
+        size_t offset;  ///< zeros trimmed at the start
+        size_t length;
+        size_t count;
+        bool symmetric;  ///< only zeros, so every occurrence shows up in both copies
+    };
+}  // namespace
+
+namespace csd {
+    /**
+     * Finds the longest repeated substring in the given string.
+     *
+     * Short inputs use the two-row dynamic programming; from
+     * `lcsre_suffix_array_threshold` characters on, the suffix array engine is
+     * used so that long CSD strings do not need O(n^2) memory.
+     *
+     * @param[in] sv The parameter `sv` is a pointer to a character array, which
+     * represents the input string. It is assumed that the string is
+     * null-terminated.
+     * @param[in] n The parameter `n` represents the length of the input string `sv`.
+     *
+     * @return The function `longest_repeated_substring` returns a string, which is
+     * the longest repeated substring in the given input string `sv`.
+     */
+    auto longest_repeated_substring(const char *sv, size_t len) -> string {
+        return longest_repeated_substring(sv, len, LcsreEngine::Auto);
+    }
+
+    auto longest_repeated_substring(const char *sv, size_t len, LcsreEngine engine) -> string {
+        if (engine == LcsreEngine::Auto) {
+            engine = len < lcsre_suffix_array_threshold ? LcsreEngine::RollingRow
+                                                        : LcsreEngine::SuffixArray;
+        }
+        detail::ScopedMetric metric(MetricFunction::Lcsre);
+        metric.set_size(len);
+        metric.set_table_bytes(lcsre_table_bytes(engine, len));
+        switch (engine) {
+            case LcsreEngine::DynamicProgramming:
+                return lcsre_dynamic_programming(sv, len);
+            case LcsreEngine::RollingRow:
+                return lcsre_rolling_row(sv, len);
+            case LcsreEngine::SuffixArray:
+            case LcsreEngine::Auto:
+            default:
+                break;
+        }
+        return lcsre_suffix_array(sv, len);
+    }
+
+    /**
+     * @brief The most frequent or longest digit patterns shared by a set of CSD strings
+     *
+     * The lcp intervals are enumerated bottom-up with a stack. Each frame
+     * also merges the symbols preceding its suffixes, so that only maximal
+     * repeats become candidates; with sign flips, the form -P of a pattern P
+     * is skipped as its own interval has the same occurrences.
+     *
+     * A repeat 0..0 P 0..0 stands for P, whose occurrences are those of the
+     * interval as long as P is longer than the parent interval: otherwise P
+     * has more occurrences, and it is found higher up the tree. The same P
+     * with different zeros in front comes from several intervals, of which
+     * the one with the most occurrences has all of them.
+     */
+    auto shared_patterns(const vector<string> &csds, const SharedPatternOptions &options)
+        -> vector<SharedPattern> {
+        GeneralizedText const text(csds, options.sign_flips);
+        auto const n = text.symbols.size();
+        auto const sa = suffix_array(text.symbols, first_separator + n);
+        auto const lcp = lcp_array(text.symbols, sa);
+        auto const min_length = std::max(options.min_length, size_t{1U});
+
+        vector<Candidate> candidates;
+        auto const consider = [&](size_t lb, size_t rb, size_t length, size_t parent_length,
+                                  size_t left) {
+            if (left != diverse_left) {
+                return;
+            }
+            auto const start = sa[lb];
+            auto const first = text.next_nonzero[start];
+            if (first >= start + length) {
+                // Only zeros: with sign flips, every occurrence is seen in both copies
+                if (options.min_nonzeros == 0U && length >= min_length) {
+                    auto const count
+                        = options.sign_flips ? (rb - lb + 1U) / 2U : rb - lb + 1U;
+                    if (count >= options.min_occurrences) {
+                        candidates.push_back(
+                            Candidate{lb, rb, 0U, length, count, options.sign_flips});
+                    }
+                }
+                return;
+            }
+            auto const last = text.nonzero_end[start + length];
+            if (last <= start + parent_length) {
+                return;
+            }
+            if (last - first < min_length
+                || text.nonzero_count[last] - text.nonzero_count[first] < options.min_nonzeros) {
+                return;
+            }
+            if (options.sign_flips && text.symbols[first] != size_t('+')) {
+                return;
+            }
+            if (rb - lb + 1U >= options.min_occurrences) {
+                candidates.push_back(
+                    Candidate{lb, rb, first - start, last - first, rb - lb + 1U, false});
+            }
+        };
+
+        struct Frame {
+            size_t length;
+            size_t lb;
+            size_t left;
+        };
+        vector<Frame> stack{Frame{0U, 0U, no_left}};
+        for (size_t i = 1U; i <= n; ++i) {
+            auto const height = i < n ? lcp[i] : 0U;
+            auto left = text.left(sa[i - 1U]);
+            auto lb = i - 1U;
+            while (height < stack.back().length) {
+                auto const frame = stack.back();
+                stack.pop_back();
+                left = merge_left(frame.left, left);
+                consider(frame.lb, i - 1U, frame.length, std::max(height, stack.back().length),
+                         left);
+                lb = frame.lb;
+            }
+            if (height > stack.back().length) {
+                stack.push_back(Frame{height, lb, left});
+            } else {
+                stack.back().left = merge_left(stack.back().left, left);
+            }
+        }
+
+        auto const better = [&](const Candidate &a, const Candidate &b) {
+            if (options.order == PatternOrder::Length && a.length != b.length) {
+                return a.length > b.length;
+            }
+            if (a.count != b.count) {
+                return a.count > b.count;
+            }
+            if (a.length != b.length) {
+                return a.length > b.length;
+            }
+            return sa[a.lb] + a.offset < sa[b.lb] + b.offset;
+        };
+        std::sort(candidates.begin(), candidates.end(), better);
+
+        vector<SharedPattern> patterns;
+        std::set<string> seen;
+        for (auto const &candidate : candidates) {
+            if (options.top_k != 0U && patterns.size() == options.top_k) {
+                break;
+            }
+            auto const start = sa[candidate.lb] + candidate.offset;
+            string digits;
+            for (auto i = start; i != start + candidate.length; ++i) {
+                digits += char(text.symbols[i]);
+            }
+            // The first of the same digits has the most occurrences
+            if (!seen.insert(digits).second) {
+                continue;
+            }
+            patterns.push_back(SharedPattern{std::move(digits), {}});
+            auto &occurrences = patterns.back().occurrences;
+            for (auto j = candidate.lb; j <= candidate.rb; ++j) {
+                auto occurrence = text.occurrence(sa[j]);
+                occurrence.position += candidate.offset;
+                if (!(candidate.symmetric && occurrence.negated)) {
+                    occurrences.push_back(occurrence);
+                }
+            }
+            std::sort(occurrences.begin(), occurrences.end(),
+                      [](const PatternOccurrence &a, const PatternOccurrence &b) {
+                          return a.string != b.string ? a.string < b.string
+                                                      : a.position < b.position;
+                      });
+        }
+        return patterns;
+    }
 }  // namespace csd
@@ -0,0 +1,531 @@
+/// @file mcm.cpp
+#include <algorithm>          // for sort, min
+#include <cmath>              // for ldexp
+#include <csd/csd.hpp>        // for to_csdfixed
+#include <csd/lcsre.hpp>      // for shared_patterns, SharedPatternOptions
+#include <csd/mcm.hpp>        // for AdderGraph, AdderNode, McmOutput
+#include <csd/shift_add.hpp>  // for to_shift_add
+#include <cstddef>            // for size_t
+#include <cstdint>            // for int64_t
+#include <map>                // for map
+#include <queue>              // for priority_queue
+#include <stdexcept>          // for length_error
+#include <string>             // for basic_string
+#include <unordered_map>      // for unordered_map
+#include <utility>            // for pair, move
+#include <vector>             // for vector
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+namespace {
+    using csd::AdderGraph;
+    using csd::AdderNode;
+
+    /** Widest digit string of a fundamental, so that every node fits an int64_t */
+    constexpr size_t max_span = 62U;
+
+    /** Fewest non-zero digits of a pattern taken from `shared_patterns` */
+    constexpr unsigned int min_pattern_digits = 3U;
+
+    /**
+     * @brief A reference from a fundamental to a shared pattern
+     */
+    struct PatternRef {
+        size_t entry;  ///< the pattern's entry
+        int shift;     ///< position of the pattern's last digit
+        int sign;      ///< +1 or -1
+    };
+
+    /**
+     * @brief An odd fundamental (or an extracted pattern) being optimized
+     *
+     * The value is the digits, which become plain shifted inputs, plus the
+     * referenced patterns. Digits taken over by a pattern are set to '0'.
+     */
+    struct Entry {
+        string digits;            ///< CSD digits, the most significant first
+        vector<PatternRef> refs;  ///< patterns extracted from this entry
+    };
+
+    /**
+     * @brief A shifted and signed graph node: `sign * node << shift`
+     */
+    struct Term {
+        size_t node;
+        int shift;
+        int sign;
+    };
+
+    auto negate(char digit) -> char {
+        return digit == '+' ? '-' : digit == '-' ? '+' : digit;
+    }
+
+    auto count_nonzeros(const string &digits) -> unsigned int {
+        auto count = 0U;
+        for (auto digit : digits) {
+            count += digit != '0' ? 1U : 0U;
+        }
+        return count;
+    }
+
+    /** Where a pattern may start: the entry and the index of its first digit */
+    struct Site {
+        size_t entry;
+        size_t start;
+    };
+
+    /** Every start of a pattern of `length` digits in the given entries */
+    auto all_sites(const vector<Entry> &pool, const vector<size_t> &entries, size_t length)
+        -> vector<Site> {
+        vector<Site> sites;
+        for (auto const e : entries) {
+            for (size_t start = 0U; start + length <= pool[e].digits.size(); ++start) {
+                sites.push_back(Site{e, start});
+            }
+        }
+        return sites;
+    }
+
+    /** Positions of the non-zero digits of a pattern */
+    auto nonzero_offsets(const string &pattern) -> vector<size_t> {
+        vector<size_t> offsets;
+        for (size_t i = 0U; i != pattern.size(); ++i) {
+            if (pattern[i] != '0') {
+                offsets.push_back(i);
+            }
+        }
+        return offsets;
+    }
+
+    /**
+     * @brief Whether a pattern matches at a start, whatever the digits at its zero positions
+     *
+     * @return +1, -1 for its negation, or 0 if it does not match
+     */
+    auto match_sign(const string &digits, size_t start, const string &pattern,
+                    const vector<size_t> &offsets) -> int {
+        if (start + pattern.size() > digits.size()) {
+            return 0;
+        }
+        auto const lead = digits[start + offsets[0]];
+        if (lead == '0') {
+            return 0;
+        }
+        auto const sign = lead == pattern[offsets[0]] ? 1 : -1;
+        for (auto offset : offsets) {
+            auto const want = sign > 0 ? pattern[offset] : negate(pattern[offset]);
+            if (digits[start + offset] != want) {
+                return 0;
+            }
+        }
+        return sign;
+    }
+
+    /**
+     * @brief Replace the non-overlapping occurrences of a pattern by a new entry
+     *
+     * Only the given sites, sorted by entry and start, are tried; the
+     * pattern matches (possibly negated) where all of its non-zero digits
+     * are present, whatever the digits at its zero positions are. Nothing
+     * changes unless there are at least two occurrences.
+     *
+     * @return The entries that changed, empty if nothing did
+     */
+    auto extract(vector<Entry> &pool, const string &pattern, const vector<Site> &sites)
+        -> vector<size_t> {
+        auto const offsets = nonzero_offsets(pattern);
+        auto const new_entry = pool.size();
+        auto occurrences = size_t{0U};
+        vector<std::pair<size_t, Entry>> changed;
+        for (auto const &site : sites) {
+            auto const &digits = pool[site.entry].digits;
+            if (changed.empty() || changed.back().first != site.entry) {
+                changed.emplace_back(site.entry, Entry{digits, {}});
+            }
+            auto &updated = changed.back().second;
+            auto const sign = match_sign(updated.digits, site.start, pattern, offsets);
+            if (sign == 0) {
+                continue;
+            }
+            for (auto offset : offsets) {
+                updated.digits[site.start + offset] = '0';
+            }
+            auto const shift = int(digits.size() - site.start - pattern.size());
+            updated.refs.push_back(PatternRef{new_entry, shift, sign});
+            ++occurrences;
+        }
+
+        vector<size_t> entries;
+        if (occurrences < 2U) {
+            return entries;
+        }
+        for (auto &change : changed) {
+            if (change.second.refs.empty()) {
+                continue;
+            }
+            auto &entry = pool[change.first];
+            entry.digits = std::move(change.second.digits);
+            entry.refs.insert(entry.refs.end(), change.second.refs.begin(),
+                              change.second.refs.end());
+            entries.push_back(change.first);
+        }
+        pool.push_back(Entry{pattern, {}});
+        return entries;
+    }
+
+    /** Number of pair keys: twice the distances up to `max_span` */
+    constexpr size_t pair_keys = 2U * max_span;
+
+    /** Key of a pair of non-zero digits: twice their distance, plus one if their signs differ */
+    auto pair_key(size_t distance, bool same_sign) -> size_t {
+        return 2U * distance + (same_sign ? 0U : 1U);
+    }
+
+    /** Count the pairs of non-zero digits of one entry by key, overlapping or not */
+    auto count_pairs(const string &digits, vector<size_t> &counts) -> void {
+        counts.assign(pair_keys, 0U);
+        for (size_t i = 0U; i != digits.size(); ++i) {
+            if (digits[i] == '0') {
+                continue;
+            }
+            for (auto j = i + 1U; j != digits.size(); ++j) {
+                if (digits[j] != '0') {
+                    ++counts[pair_key(j - i, digits[i] == digits[j])];
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Extract common patterns of three or more digits, most non-zero digits first
+     *
+     * The candidates are the repeats `shared_patterns` finds in the digit
+     * strings and their negations, without zeros at either end; ties go to
+     * the most occurrences. One suffix array serves a whole round: a
+     * candidate whose occurrences the earlier extractions took away is
+     * ranked again by what is left before it is tried, and it is only
+     * searched for in the entries holding the pair of its outer digits.
+     * The rounds repeat as long as they extract anything, for the patterns
+     * inside the new entries.
+     */
+    auto extract_long_patterns(vector<Entry> &pool) -> void {
+        auto options = csd::SharedPatternOptions();
+        options.min_nonzeros = min_pattern_digits;
+        options.top_k = 0U;
+        options.order = csd::PatternOrder::Length;
+        for (;;) {
+            vector<string> digits;
+            vector<size_t> entries;
+            // Extractions only take digits away, so the pairs counted here stay a superset
+            auto const round_entries = pool.size();
+            auto pairs = vector<vector<size_t>>(round_entries);
+            for (size_t e = 0U; e != round_entries; ++e) {
+                count_pairs(pool[e].digits, pairs[e]);
+            }
+            for (size_t e = 0U; e != pool.size(); ++e) {
+                if (count_nonzeros(pool[e].digits) >= min_pattern_digits) {
+                    digits.push_back(pool[e].digits);
+                    entries.push_back(e);
+                }
+            }
+            struct Candidate {
+                string pattern;
+                unsigned int nonzeros;
+                vector<Site> sites;  ///< including overlapping ones
+            };
+            vector<Candidate> candidates;
+            for (auto &shared : csd::shared_patterns(digits, options)) {
+                auto const nonzeros = count_nonzeros(shared.pattern);
+                vector<Site> sites;
+                for (auto const &occurrence : shared.occurrences) {
+                    sites.push_back(Site{entries[occurrence.string], occurrence.position});
+                }
+                candidates.push_back(
+                    Candidate{std::move(shared.pattern), nonzeros, std::move(sites)});
+            }
+
+            // Most non-zero digits, then most sites, then first found
+            using Rank = std::pair<std::pair<unsigned int, size_t>, size_t>;
+            auto const rank = [&](size_t c) {
+                return Rank{{candidates[c].nonzeros, candidates[c].sites.size()},
+                            candidates.size() - c};
+            };
+            std::priority_queue<Rank> queue;
+            for (size_t c = 0U; c != candidates.size(); ++c) {
+                queue.push(rank(c));
+            }
+            auto extracted = false;
+            while (!queue.empty()) {
+                auto const top = queue.top();
+                queue.pop();
+                auto &candidate = candidates[candidates.size() - top.second];
+                auto const offsets = nonzero_offsets(candidate.pattern);
+                vector<Site> left;
+                for (auto const &site : candidate.sites) {
+                    if (match_sign(pool[site.entry].digits, site.start, candidate.pattern,
+                                   offsets)
+                        != 0) {
+                        left.push_back(site);
+                    }
+                }
+                if (left.size() < candidate.sites.size()) {
+                    candidate.sites = std::move(left);
+                    if (candidate.sites.size() >= 2U) {
+                        queue.push(Rank{{candidate.nonzeros, candidate.sites.size()}, top.second});
+                    }
+                    continue;
+                }
+                auto const key = pair_key(offsets.back() - offsets.front(),
+                                          candidate.pattern[offsets.front()]
+                                              == candidate.pattern[offsets.back()]);
+                vector<size_t> holders;
+                for (size_t e = 0U; e != pool.size(); ++e) {
+                    if (e >= round_entries || pairs[e][key] != 0U) {
+                        holders.push_back(e);
+                    }
+                }
+                auto const sites = all_sites(pool, holders, candidate.pattern.size());
+                if (!extract(pool, candidate.pattern, sites).empty()) {
+                    extracted = true;
+                }
+            }
+            if (!extracted) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief Extract the common pairs of non-zero digits, most frequent first
+     *
+     * The counts include overlapping pairs, so a pair that turns out to
+     * have a single non-overlapping occurrence is skipped in favour of the
+     * next one; it cannot gain occurrences later, as extractions only take
+     * digits away. After an extraction only the counts of the entries it
+     * changed are updated, and only the entries holding a pair are searched.
+     */
+    auto extract_pairs(vector<Entry> &pool) -> void {
+        auto totals = vector<size_t>(pair_keys, 0U);
+        auto per_entry = vector<vector<size_t>>(pool.size());
+        auto const recount = [&](size_t e) {
+            for (size_t key = 0U; key != pair_keys; ++key) {
+                totals[key] -= per_entry[e][key];
+            }
+            count_pairs(pool[e].digits, per_entry[e]);
+            for (size_t key = 0U; key != pair_keys; ++key) {
+                totals[key] += per_entry[e][key];
+            }
+        };
+        for (size_t e = 0U; e != pool.size(); ++e) {
+            per_entry[e].assign(pair_keys, 0U);
+            recount(e);
+        }
+
+        auto failed = vector<bool>(pair_keys, false);
+        for (;;) {
+            auto best = pair_keys;
+            for (size_t key = 0U; key != pair_keys; ++key) {
+                if (!failed[key] && totals[key] >= 2U
+                    && (best == pair_keys || totals[key] > totals[best])) {
+                    best = key;
+                }
+            }
+            if (best == pair_keys) {
+                return;
+            }
+
+            vector<size_t> holders;
+            for (size_t e = 0U; e != pool.size(); ++e) {
+                if (per_entry[e][best] != 0U) {
+                    holders.push_back(e);
+                }
+            }
+            auto pattern = string(best / 2U + 1U, '0');
+            pattern.front() = '+';
+            pattern.back() = best % 2U == 0U ? '+' : '-';
+            auto const changed = extract(pool, pattern, all_sites(pool, holders, pattern.size()));
+            if (changed.empty()) {
+                failed[best] = true;
+                continue;
+            }
+            for (auto const e : changed) {
+                recount(e);
+            }
+            per_entry.emplace_back(pair_keys, 0U);
+            recount(pool.size() - 1U);
+        }
+    }
+
+    /**
+     * @brief Adds the adders of the graph, reusing nodes of equal value
+     *
+     * The nodes are looked up by their odd part, so that a sum equal to an
+     * existing node up to a sign and a power of two reuses it.
+     */
+    class GraphBuilder {
+      public:
+        explicit GraphBuilder(AdderGraph &graph) : graph_(graph) {
+            nodes_.emplace(1, OddNode{0U, 0});
+        }
+
+        /**
+         * @brief Sum terms with a balanced tree of adders
+         *
+         * @return A term equal to the sum (a zero sum is not allowed)
+         */
+        auto sum(vector<Term> terms) -> Term {
+            while (terms.size() > 1U) {
+                vector<Term> next;
+                for (size_t i = 0U; i + 1U < terms.size(); i += 2U) {
+                    next.push_back(add(terms[i], terms[i + 1U]));
+                }
+                if (terms.size() % 2U != 0U) {
+                    next.push_back(terms.back());
+                }
+                terms.swap(next);
+            }
+            return terms.front();
+        }
+
+      private:
+        auto add(const Term &lhs, const Term &rhs) -> Term {
+            auto const base = std::min(lhs.shift, rhs.shift);
+            auto node = AdderNode{lhs.node,
+                                  unsigned(lhs.shift - base),
+                                  lhs.sign,
+                                  rhs.node,
+                                  unsigned(rhs.shift - base),
+                                  rhs.sign,
+                                  0};
+            node.value = lhs.sign * (csd::node_value(graph_, lhs.node) << node.lhs_shift)
+                         + rhs.sign * (csd::node_value(graph_, rhs.node) << node.rhs_shift);
+            auto sign = 1;
+            if (node.value < 0) {
+                node.value = -node.value;
+                node.lhs_sign = -node.lhs_sign;
+                node.rhs_sign = -node.rhs_sign;
+                sign = -1;
+            }
+            auto odd = node.value;
+            auto zeros = 0;
+            while (odd % 2 == 0) {
+                odd /= 2;
+                ++zeros;
+            }
+            auto const found = nodes_.find(odd);
+            if (found != nodes_.end()) {
+                return Term{found->second.node, base + zeros - found->second.zeros, sign};
+            }
+            graph_.adders.push_back(node);
+            nodes_.emplace(odd, OddNode{graph_.adders.size(), zeros});
+            return Term{graph_.adders.size(), base, sign};
+        }
+
+        /** A node whose value is its odd part shifted left by `zeros` */
+        struct OddNode {
+            size_t node;
+            int zeros;
+        };
+
+        AdderGraph &graph_;
+        std::unordered_map<std::int64_t, OddNode> nodes_;
+    };
+
+    /**
+     * @brief A coefficient as a signed, shifted odd fundamental
+     */
+    struct Fundamental {
+        size_t entry;
+        int shift;
+        int sign;
+    };
+}  // namespace
+
+namespace csd {
+    auto output_value(const AdderGraph &graph, size_t output) -> double {
+        auto const &out = graph.outputs[output];
+        return std::ldexp(double(out.sign) * double(node_value(graph, out.node)), out.shift);
+    }
+
+    /**
+     * @brief Multiple constant multiplication of CSD coefficients
+     *
+     * Patterns are extracted into new pool entries, and an entry only ever
+     * refers to entries created after it, so building the entries from the
+     * newest to the oldest visits every pattern before its users.
+     */
+    auto mcm_adder_graph(const vector<string> &csds) -> AdderGraph {
+        vector<Entry> pool;
+        vector<Fundamental> fundamentals;
+        std::map<string, size_t> unique;
+        for (auto const &csd : csds) {
+            auto const program = to_shift_add(csd.c_str());
+            if (program.terms.empty()) {
+                fundamentals.push_back(Fundamental{0U, 0, 0});
+                continue;
+            }
+            auto const top = program.terms.front().shift;
+            auto const bottom = program.terms.back().shift;
+            if (top - bottom + 1U > max_span) {
+                CSD_THROW(std::length_error("CSD coefficient spans more than 62 digits"));
+            }
+            auto const sign = program.terms.front().sign;
+            auto digits = string(top - bottom + 1U, '0');
+            for (auto const &term : program.terms) {
+                digits[top - term.shift] = term.sign == sign ? '+' : '-';
+            }
+            auto const found = unique.emplace(digits, pool.size());
+            if (found.second) {
+                pool.push_back(Entry{digits, {}});
+            }
+            fundamentals.push_back(
+                Fundamental{found.first->second, int(bottom) - int(program.frac), sign});
+        }
+
+        extract_long_patterns(pool);
+        extract_pairs(pool);
+
+        AdderGraph graph;
+        GraphBuilder builder(graph);
+        auto built = vector<Term>(pool.size());
+        for (auto e = pool.size(); e != 0U; --e) {
+            auto const &entry = pool[e - 1U];
+            vector<Term> terms;
+            for (size_t i = 0U; i != entry.digits.size(); ++i) {
+                if (entry.digits[i] != '0') {
+                    terms.push_back(
+                        Term{0U, int(entry.digits.size() - 1U - i), entry.digits[i] == '+' ? 1 : -1});
+                }
+            }
+            for (auto const &ref : entry.refs) {
+                auto const &pattern = built[ref.entry];
+                terms.push_back(Term{pattern.node, pattern.shift + ref.shift, pattern.sign * ref.sign});
+            }
+            std::sort(terms.begin(), terms.end(),
+                      [](const Term &a, const Term &b) { return a.shift > b.shift; });
+            built[e - 1U] = builder.sum(terms);
+        }
+
+        for (auto const &fundamental : fundamentals) {
+            if (fundamental.sign == 0) {
+                graph.outputs.push_back(McmOutput{0U, 0, 0});
+                continue;
+            }
+            auto const &term = built[fundamental.entry];
+            graph.outputs.push_back(
+                McmOutput{term.node, term.shift + fundamental.shift, term.sign * fundamental.sign});
+        }
+        return graph;
+    }
+
+    auto mcm_adder_graph(const vector<double> &coefficients, unsigned int nnz) -> AdderGraph {
+        vector<string> csds;
+        csds.reserve(coefficients.size());
+        for (auto coefficient : coefficients) {
+            csds.push_back(to_csdfixed(coefficient, nnz));
+        }
+        return mcm_adder_graph(csds);
+    }
+}  // namespace csd
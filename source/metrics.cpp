@@ -0,0 +1,245 @@
+/// @file metrics.cpp
+#include <algorithm>        // for find, max
+#include <atomic>           // for atomic, memory_order_relaxed, memory_order_acquire
+#include <csd/metrics.hpp>  // for MetricsSnapshot, FunctionMetrics, MetricFunction
+#include <cstddef>          // for size_t
+#include <cstdint>          // for uint64_t
+#include <mutex>            // for mutex, lock_guard
+#include <string>           // for basic_string, to_string
+#include <vector>           // for vector
+
+using std::size_t;
+using std::uint64_t;
+
+namespace {
+    using csd::FunctionMetrics;
+    using csd::metric_buckets;
+    using csd::metric_functions;
+    using csd::MetricsSnapshot;
+
+    using Counter = std::atomic<uint64_t>;
+
+    /**
+     * @brief Add to a counter only its own thread writes
+     *
+     * A relaxed load and store, without the locked read-modify-write of
+     * `fetch_add`, is enough for a snapshot to read it without a data race.
+     */
+    inline auto bump(Counter &counter, uint64_t value) -> void {
+        counter.store(counter.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+    }
+
+    inline auto bucket(uint64_t value) -> size_t {
+        auto b = size_t{0U};
+        for (; value != 0U && b != metric_buckets - 1U; value >>= 1U) {
+            ++b;
+        }
+        return b;
+    }
+
+    struct FunctionCounters {
+        Counter calls;
+        Counter nanoseconds;
+        Counter max_nanoseconds;
+        Counter table_bytes;
+        Counter sizes[metric_buckets];
+        Counter latencies[metric_buckets];
+
+        auto reset() -> void {
+            calls.store(0U, std::memory_order_relaxed);
+            nanoseconds.store(0U, std::memory_order_relaxed);
+            max_nanoseconds.store(0U, std::memory_order_relaxed);
+            table_bytes.store(0U, std::memory_order_relaxed);
+            for (size_t b = 0U; b != metric_buckets; ++b) {
+                sizes[b].store(0U, std::memory_order_relaxed);
+                latencies[b].store(0U, std::memory_order_relaxed);
+            }
+        }
+
+        auto collect(FunctionMetrics &metrics) const -> void {
+            metrics.calls += calls.load(std::memory_order_relaxed);
+            metrics.nanoseconds += nanoseconds.load(std::memory_order_relaxed);
+            metrics.max_nanoseconds
+                = std::max(metrics.max_nanoseconds, max_nanoseconds.load(std::memory_order_relaxed));
+            metrics.table_bytes += table_bytes.load(std::memory_order_relaxed);
+            for (size_t b = 0U; b != metric_buckets; ++b) {
+                metrics.sizes[b] += sizes[b].load(std::memory_order_relaxed);
+                metrics.latencies[b] += latencies[b].load(std::memory_order_relaxed);
+            }
+        }
+    };
+
+    struct ThreadCounters;
+
+    /**
+     * @brief Number of resets so far, only changed under the registry mutex
+     *
+     * Resetting never writes the counters of another thread, whose own
+     * load-then-store could undo it: each thread zeroes its counters on its
+     * next call after a reset, and until then snapshots leave them out.
+     */
+    std::atomic<uint64_t> reset_epoch{0U};
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<ThreadCounters *> threads;
+        MetricsSnapshot retired{};  ///< what the finished threads counted
+    };
+
+    /** Never destroyed, as threads may still finish after `main` returns */
+    auto registry() -> Registry & {
+        static auto *const instance = new Registry();
+        return *instance;
+    }
+
+    /**
+     * @brief The counters of one thread, registered for its lifetime
+     */
+    struct ThreadCounters {
+        FunctionCounters functions[metric_functions];
+        Counter epoch;  ///< the reset the counters were last zeroed for
+
+        ThreadCounters() {
+            for (auto &function : functions) {
+                function.reset();
+            }
+            auto &reg = registry();
+            std::lock_guard<std::mutex> const lock(reg.mutex);
+            epoch.store(reset_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            reg.threads.push_back(this);
+        }
+
+        ThreadCounters(const ThreadCounters &) = delete;
+        auto operator=(const ThreadCounters &) -> ThreadCounters & = delete;
+
+        ~ThreadCounters() {
+            auto &reg = registry();
+            std::lock_guard<std::mutex> const lock(reg.mutex);
+            collect(reg.retired);
+            reg.threads.erase(std::find(reg.threads.begin(), reg.threads.end(), this));
+        }
+
+        /** Called by the owning thread before counting */
+        auto catch_up() -> void {
+            auto const current = reset_epoch.load(std::memory_order_relaxed);
+            if (epoch.load(std::memory_order_relaxed) != current) {
+                for (auto &function : functions) {
+                    function.reset();
+                }
+                epoch.store(current, std::memory_order_release);
+            }
+        }
+
+        /** Called under the registry mutex; stale counters count as zero */
+        auto collect(MetricsSnapshot &snapshot) const -> void {
+            if (epoch.load(std::memory_order_acquire)
+                != reset_epoch.load(std::memory_order_relaxed)) {
+                return;
+            }
+            for (size_t f = 0U; f != metric_functions; ++f) {
+                functions[f].collect(snapshot.functions[f]);
+            }
+        }
+    };
+
+    auto local_counters() -> ThreadCounters & {
+        thread_local ThreadCounters counters;
+        return counters;
+    }
+}  // namespace
+
+namespace csd {
+    auto metrics_available() -> bool { return CSD_ENABLE_METRICS != 0; }
+
+    auto metric_name(MetricFunction function) -> const char * {
+        switch (function) {
+            case MetricFunction::ToCsd:
+                return "to_csd";
+            case MetricFunction::ToCsdFixed:
+                return "to_csdfixed";
+            case MetricFunction::ToDecimalBatch:
+                return "to_decimal_batch";
+            case MetricFunction::Lcsre:
+                return "longest_repeated_substring";
+        }
+        return "unknown";
+    }
+
+    auto metrics_snapshot() -> MetricsSnapshot {
+        MetricsSnapshot snapshot{};
+        auto &reg = registry();
+        std::lock_guard<std::mutex> const lock(reg.mutex);
+        for (size_t f = 0U; f != metric_functions; ++f) {
+            snapshot.functions[f] = reg.retired.functions[f];
+        }
+        for (auto const *const thread : reg.threads) {
+            thread->collect(snapshot);
+        }
+        return snapshot;
+    }
+
+    auto reset_metrics() -> void {
+        auto &reg = registry();
+        std::lock_guard<std::mutex> const lock(reg.mutex);
+        reg.retired = MetricsSnapshot{};
+        reset_epoch.fetch_add(1U, std::memory_order_relaxed);
+    }
+
+    auto latency_percentile(const FunctionMetrics &metrics, double q) -> uint64_t {
+        if (metrics.calls == 0U) {
+            return 0U;
+        }
+        auto const rank = q * double(metrics.calls);
+        auto seen = uint64_t{0U};
+        for (size_t b = 0U; b != metric_buckets - 1U; ++b) {
+            seen += metrics.latencies[b];
+            if (double(seen) >= rank) {
+                return b == 0U ? 0U : (uint64_t{1U} << b) - 1U;
+            }
+        }
+        return metrics.max_nanoseconds;
+    }
+
+    auto format_metrics(const MetricsSnapshot &snapshot) -> std::string {
+        std::string out;
+        for (size_t f = 0U; f != metric_functions; ++f) {
+            auto const function = static_cast<MetricFunction>(f);
+            auto const &metrics = snapshot[function];
+            out += metric_name(function);
+            out += " calls=" + std::to_string(metrics.calls);
+            out += " ns=" + std::to_string(metrics.nanoseconds);
+            out += " max_ns=" + std::to_string(metrics.max_nanoseconds);
+            out += " p50_ns=" + std::to_string(latency_percentile(metrics, 0.5));
+            out += " p99_ns=" + std::to_string(latency_percentile(metrics, 0.99));
+            out += " table_bytes=" + std::to_string(metrics.table_bytes);
+            // The size histogram, up to its last non-empty bucket
+            auto used = metric_buckets;
+            while (used != 0U && metrics.sizes[used - 1U] == 0U) {
+                --used;
+            }
+            out += " sizes=";
+            for (size_t b = 0U; b != used; ++b) {
+                out += (b == 0U ? "" : ",") + std::to_string(metrics.sizes[b]);
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
+    namespace detail {
+        auto record_metric(MetricFunction function, uint64_t nanoseconds, size_t size,
+                           size_t table_bytes) -> void {
+            auto &thread = local_counters();
+            thread.catch_up();
+            auto &counters = thread.functions[static_cast<size_t>(function)];
+            bump(counters.calls, 1U);
+            bump(counters.nanoseconds, nanoseconds);
+            if (nanoseconds > counters.max_nanoseconds.load(std::memory_order_relaxed)) {
+                counters.max_nanoseconds.store(nanoseconds, std::memory_order_relaxed);
+            }
+            bump(counters.table_bytes, table_bytes);
+            bump(counters.sizes[bucket(size)], 1U);
+            bump(counters.latencies[bucket(nanoseconds)], 1U);
+        }
+    }  // namespace detail
+}  // namespace csd
@@ -0,0 +1,141 @@
+/// @file msd.cpp
+#include <csd/msd.hpp>     // for MsdEnumerator, msd_weight, msd_count, to_msd_all
+#include <csd/packed.hpp>  // for PackedCsd, to_csd_packed
+#include <cstdint>         // for int64_t, uint64_t
+#include <stdexcept>       // for length_error
+#include <vector>          // for vector
+
+using std::int64_t;
+using std::uint64_t;
+using std::vector;
+
+namespace {
+    using csd::msd_max_magnitude;
+
+    auto check_magnitude(int64_t value) -> int64_t {
+        if (value > msd_max_magnitude || value < -msd_max_magnitude) {
+            CSD_THROW(std::length_error("MSD forms are limited to magnitudes up to 2^62"));
+        }
+        return value;
+    }
+
+    /** The value of the digits of a packed number, as an integer */
+    auto scaled_value(const csd::PackedCsd &csd) -> int64_t {
+        if (csd.length > 62U) {
+            CSD_THROW(std::length_error("MSD forms are limited to magnitudes up to 2^62"));
+        }
+        return static_cast<int64_t>(csd.pos) - static_cast<int64_t>(csd.neg);
+    }
+}  // namespace
+
+namespace csd {
+    MsdEnumerator::MsdEnumerator(int64_t value)
+        : pending_(1U, Branch{check_magnitude(value), 0U, 0U, 0U}),
+          weight_(msd_weight(value)),
+          frac_(0U),
+          has_point_(false) {}
+
+    MsdEnumerator::MsdEnumerator(double decimal_value, int places)
+        : pending_(), weight_(0U), frac_(places > 0 ? unsigned(places) : 0U), has_point_(true) {
+        auto const value = scaled_value(to_csd_packed(decimal_value, places));
+        pending_.push_back(Branch{value, 0U, 0U, 0U});
+        weight_ = msd_weight(value);
+    }
+
+    auto MsdEnumerator::next(PackedCsd &msd) -> bool {
+        if (pending_.empty()) {
+            return false;
+        }
+        auto branch = pending_.back();
+        pending_.pop_back();
+        for (; branch.rest != 0; ++branch.position) {
+            auto const n = branch.rest;
+            if (n % 2 == 0) {
+                branch.rest = n / 2;
+                continue;
+            }
+            auto const plus = (n - 1) / 2;
+            auto const minus = (n + 1) / 2;
+            auto const left = msd_weight(n) - 1U;
+            auto const can_plus = msd_weight(plus) == left;
+            auto const can_minus = msd_weight(minus) == left;
+            // The CSD digit first: '+' when n is 1 modulo 4
+            auto const take_plus = can_plus && ((n & 3) == 1 || !can_minus);
+            auto const bit = uint64_t{1U} << branch.position;
+            if (can_plus && can_minus) {
+                auto other = branch;
+                other.rest = take_plus ? minus : plus;
+                (take_plus ? other.neg : other.pos) |= bit;
+                ++other.position;
+                pending_.push_back(other);
+            }
+            branch.rest = take_plus ? plus : minus;
+            (take_plus ? branch.pos : branch.neg) |= bit;
+        }
+        auto length = branch.position;
+        if (has_point_ && length < frac_ + 1U) {
+            length = frac_ + 1U;
+        }
+        msd = PackedCsd(branch.pos, branch.neg, length == 0U ? 1U : length, frac_, has_point_);
+        return true;
+    }
+
+    /**
+     * The count of a rest is that of its children, which are the two rests
+     * one digit up; the levels are gone through from the top (where the
+     * rest is 0 or -1, both with a single form) down to the value.
+     */
+    auto msd_count(int64_t value) -> uint64_t {
+        check_magnitude(value);
+        vector<int64_t> floors(1U, value);
+        while (floors.back() != 0 && floors.back() != -1) {
+            floors.push_back(floors.back() >> 1);  // floor(value / 2^k)
+        }
+        // The counts of floors[k] and floors[k] + 1
+        uint64_t counts[2] = {1U, 1U};
+        for (auto k = floors.size() - 1U; k-- != 0U;) {
+            auto const base = floors[k + 1U];
+            auto count_of = [&](int64_t rest) -> uint64_t {
+                return rest == 0 ? 1U : counts[rest - base];
+            };
+            uint64_t next[2] = {0U, 0U};
+            for (auto i = 0; i != 2; ++i) {
+                auto const n = floors[k] + i;
+                if (n % 2 == 0) {
+                    next[i] = n == 0 ? 1U : count_of(n / 2);
+                    continue;
+                }
+                auto const left = msd_weight(n) - 1U;
+                if (msd_weight((n - 1) / 2) == left) {
+                    next[i] += count_of((n - 1) / 2);
+                }
+                if (msd_weight((n + 1) / 2) == left) {
+                    next[i] += count_of((n + 1) / 2);
+                }
+            }
+            counts[0] = next[0];
+            counts[1] = next[1];
+        }
+        return counts[0];
+    }
+
+    auto to_msd_all(int64_t value) -> vector<PackedCsd> {
+        vector<PackedCsd> forms;
+        MsdEnumerator msds(value);
+        PackedCsd msd;
+        while (msds.next(msd)) {
+            forms.push_back(msd);
+        }
+        return forms;
+    }
+
+    auto to_msd_all(double decimal_value, int places) -> vector<PackedCsd> {
+        vector<PackedCsd> forms;
+        MsdEnumerator msds(decimal_value, places);
+        PackedCsd msd;
+        while (msds.next(msd)) {
+            forms.push_back(msd);
+        }
+        return forms;
+    }
+}  // namespace csd
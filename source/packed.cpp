@@ -0,0 +1,2 @@
+/// @file packed.cpp
+#include <csd/packed_impl.hpp>  // for to_packed, to_string
@@ -0,0 +1,260 @@
+/// @file parallel.cpp
+#include <algorithm>             // for find, min
+#include <condition_variable>    // for condition_variable
+#include <csd/batch.hpp>         // for to_decimal_batch
+#include <csd/csd.hpp>           // for to_csd_into, to_csd_length, to_csdfixed_into
+#include <csd/parallel.hpp>      // for to_csd_parallel, to_decimal_parallel
+#include <csd/string_table.hpp>  // for CsdStringTable
+#include <cstddef>               // for size_t
+#include <cstring>               // for memcpy
+#include <deque>                 // for deque
+#include <exception>             // for exception_ptr, current_exception, rethrow_exception
+#include <mutex>                 // for mutex, unique_lock
+#include <string>                // for basic_string
+#include <thread>                // for thread
+#include <utility>               // for move
+#include <vector>                // for vector
+
+using std::size_t;
+using std::vector;
+
+namespace {
+    using csd::CsdStringTable;
+
+    /** Fewest elements worth a thread of their own */
+    constexpr size_t min_grain = 4096U;
+
+    /** Strings decoded per `to_decimal_batch` call on a table */
+    constexpr size_t decode_block = 256U;
+
+    /**
+     * @brief Number of ranges to split `n` elements into
+     */
+    auto partitions(size_t n, unsigned int threads) -> size_t {
+        if (threads == 0U) {
+            threads = std::thread::hardware_concurrency();
+        }
+        auto const by_size = (n + min_grain - 1U) / min_grain;
+        return std::max(size_t{1U}, std::min(size_t(threads), by_size));
+    }
+
+    /**
+     * @brief Worker threads shared by every parallel call
+     *
+     * The workers are started on first use and never stopped, so a call does
+     * not pay for creating threads. A job is split into parts, which the
+     * workers and the calling thread claim one at a time: a job completes
+     * even when every worker is busy with other jobs, or when no worker
+     * could be started at all.
+     */
+    class ThreadPool {
+      public:
+        /** A job of `parts` calls `call(context, part)` */
+        struct Job {
+            void (*call)(void *, size_t);
+            void *context;
+            size_t parts;
+            size_t next;      ///< First part not claimed yet
+            size_t finished;  ///< Number of parts done
+        };
+
+        ThreadPool() {
+            auto const hardware = std::thread::hardware_concurrency();
+            for (unsigned int i = 1U; i < hardware; ++i) {
+#ifdef CSD_HAS_EXCEPTIONS
+                try {
+                    std::thread(&ThreadPool::work, this).detach();
+                } catch (...) {
+                    break;  // fewer workers; the callers still run every part
+                }
+#else
+                std::thread(&ThreadPool::work, this).detach();
+#endif
+            }
+        }
+
+        /**
+         * @brief Run all the parts of `job`, returning once they are done
+         */
+        auto run(Job &job) -> void {
+            std::unique_lock<std::mutex> lock(mutex_);
+            queue_.push_back(&job);
+            ready_.notify_all();
+            while (job.next != job.parts) {
+                auto const part = job.next++;
+                if (job.next == job.parts) {
+                    queue_.erase(std::find(queue_.begin(), queue_.end(), &job));
+                }
+                lock.unlock();
+                job.call(job.context, part);
+                lock.lock();
+                ++job.finished;
+            }
+            done_.wait(lock, [&job] { return job.finished == job.parts; });
+        }
+
+      private:
+        auto work() -> void {
+            std::unique_lock<std::mutex> lock(mutex_);
+            for (;;) {
+                ready_.wait(lock, [this] { return !queue_.empty(); });
+                auto &job = *queue_.front();
+                auto const part = job.next++;
+                if (job.next == job.parts) {
+                    queue_.pop_front();
+                }
+                lock.unlock();
+                job.call(job.context, part);
+                lock.lock();
+                if (++job.finished == job.parts) {
+                    done_.notify_all();
+                }
+            }
+        }
+
+        std::mutex mutex_;
+        std::condition_variable ready_;  ///< A job has parts left to claim
+        std::condition_variable done_;   ///< A job has finished
+        std::deque<Job *> queue_;        ///< The jobs with parts left to claim
+    };
+
+    /** The pool, never destroyed so that no worker outlives it */
+    auto pool() -> ThreadPool & {
+        static auto *const instance = new ThreadPool();
+        return *instance;
+    }
+
+    template <typename Fn> auto call_part(void *fn, size_t part) -> void {
+        (*static_cast<Fn *>(fn))(part);
+    }
+
+    /**
+     * @brief Run `fn(part, first, last)` for `parts` contiguous ranges of [0, n)
+     *
+     * The ranges run on the shared pool, the calling thread taking its share.
+     * An exception escaping `fn` is rethrown once every range is done; if
+     * several ranges fail, the first one wins.
+     */
+    template <typename Fn> auto parallel_for(size_t n, size_t parts, Fn fn) -> void {
+        auto const first = [&](size_t part) { return n / parts * part + std::min(part, n % parts); };
+        if (parts == 1U) {
+            fn(size_t{0U}, size_t{0U}, n);
+            return;
+        }
+
+        auto errors = vector<std::exception_ptr>(parts);
+        auto run = [&](size_t part) {
+#ifdef CSD_HAS_EXCEPTIONS
+            try {
+                fn(part, first(part), first(part + 1U));
+            } catch (...) {
+                errors[part] = std::current_exception();
+            }
+#else
+            fn(part, first(part), first(part + 1U));
+#endif
+        };
+        auto job = ThreadPool::Job{&call_part<decltype(run)>, &run, parts, 0U, 0U};
+        pool().run(job);
+        for (auto const &error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+}  // namespace
+
+namespace csd {
+    auto to_csd_parallel(const double *values, size_t n, int places, unsigned int threads)
+        -> CsdStringTable {
+        auto const parts = partitions(n, threads);
+        // The length of every string, then its offset: only the per-range
+        // totals are summed serially, and each range fills its own offsets
+        auto offsets = CsdStringTable::offsets_type(n + 1U);
+        auto totals = vector<size_t>(parts + 1U, 0U);
+        parallel_for(n, parts, [&](size_t part, size_t first, size_t last) {
+            size_t total = 0U;
+            for (auto i = first; i != last; ++i) {
+                offsets[i + 1U] = to_csd_length(values[i], places) + 1U;
+                total += offsets[i + 1U];
+            }
+            totals[part + 1U] = total;
+        });
+        for (size_t part = 0U; part != parts; ++part) {
+            totals[part + 1U] += totals[part];
+        }
+
+        auto data = CsdStringTable::buffer_type(totals[parts]);
+        offsets[0] = 0U;
+        parallel_for(n, parts, [&](size_t part, size_t first, size_t last) {
+            auto offset = totals[part];
+            for (auto i = first; i != last; ++i) {
+                auto const size = offsets[i + 1U];
+                to_csd_into(values[i], places, data.data() + offset, size);
+                offset += size;
+                offsets[i + 1U] = offset;
+            }
+        });
+        return CsdStringTable(std::move(data), std::move(offsets));
+    }
+
+    auto to_csdfixed_parallel(const double *values, size_t n, unsigned int nnz,
+                              unsigned int threads) -> CsdStringTable {
+        auto const parts = partitions(n, threads);
+        auto offsets = CsdStringTable::offsets_type(n + 1U);
+        auto chunks = vector<std::string>(parts);
+        parallel_for(n, parts, [&](size_t part, size_t first, size_t last) {
+            auto &chunk = chunks[part];
+            std::string csd;
+            for (auto i = first; i != last; ++i) {
+                to_csdfixed_into(values[i], nnz, csd);
+                chunk.append(csd.c_str(), csd.size() + 1U);
+                offsets[i] = csd.size() + 1U;  // the length for now
+            }
+        });
+
+        // Where every chunk goes in the output
+        auto starts = vector<size_t>(parts + 1U, 0U);
+        for (size_t part = 0U; part != parts; ++part) {
+            starts[part + 1U] = starts[part] + chunks[part].size();
+        }
+
+        auto data = CsdStringTable::buffer_type(starts[parts]);
+        parallel_for(n, parts, [&](size_t part, size_t first, size_t last) {
+            std::memcpy(data.data() + starts[part], chunks[part].data(), chunks[part].size());
+            auto offset = starts[part];
+            for (auto i = first; i != last; ++i) {
+                auto const length = offsets[i];
+                offsets[i] = offset;
+                offset += length;
+            }
+            chunks[part] = std::string();
+        });
+        offsets[n] = data.size();
+        return CsdStringTable(std::move(data), std::move(offsets));
+    }
+
+    auto to_decimal_parallel(const char *const *csd, size_t n, double *out, unsigned int threads)
+        -> void {
+        parallel_for(n, partitions(n, threads), [&](size_t, size_t first, size_t last) {
+            to_decimal_batch(csd + first, last - first, out + first);
+        });
+    }
+
+    auto to_decimal_parallel(const CsdStringTable &csd, double *out, unsigned int threads)
+        -> void {
+        auto const n = csd.size();
+        parallel_for(n, partitions(n, threads), [&](size_t, size_t first, size_t last) {
+            const char *strings[decode_block];
+            size_t sizes[decode_block];
+            for (auto i = first; i < last; i += decode_block) {
+                auto const count = std::min(decode_block, last - i);
+                for (size_t k = 0U; k != count; ++k) {
+                    strings[k] = csd[i + k];
+                    sizes[k] = csd.length(i + k);
+                }
+                to_decimal_batch(strings, sizes, count, out + i);
+            }
+        });
+    }
+}  // namespace csd
@@ -0,0 +1,171 @@
+/// @file quantize.cpp
+#include <cmath>              // for fabs, ldexp, frexp, ilogb, isfinite
+#include <csd/generator.hpp>  // for CsdGenerator, CsdDigit
+#include <csd/quantize.hpp>   // for quantize, to_csd_optimal, csdfixed_sweep
+#include <csd/wide.hpp>       // for BigInt, to_csd_wide
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint64_t
+#include <cstring>            // for memcpy
+#include <stdexcept>          // for invalid_argument
+#include <string>             // for basic_string
+#include <utility>            // for move
+#include <vector>             // for vector
+
+using std::size_t;
+
+namespace {
+    /**
+     * @brief 2^exp, from its exponent bits when it is a normal double
+     *
+     * The search builds a few powers of two per node; `ldexp` takes its
+     * general path for every one of them.
+     */
+    inline auto power_of_two(int exp) -> double {
+        if (exp < -1022 || exp > 1023) {
+            return std::ldexp(1.0, exp);
+        }
+        auto const bits = std::uint64_t(exp + 1023) << 52U;
+        double res;
+        std::memcpy(&res, &bits, sizeof res);
+        return res;
+    }
+
+    /**
+     * @brief Depth-first branch and bound for the nearest integer with few CSD digits
+     *
+     * Works on the residual r = t - (digits chosen so far). Every step
+     * subtracts a power of two from a residual within a factor of two of it,
+     * so all the residuals are exact: they stay multiples of the granularity
+     * of t (or of 1) and below 2^53 times it.
+     */
+    struct Search {
+        double best_error;
+        double best_residual;
+        unsigned int best_left;  ///< digits left unused by the best approximation
+
+        /**
+         * @brief Try to approximate the residual with at most `left` more digits
+         *
+         * @param[in] residual - What is left to approximate
+         * @param[in] left - Number of non-zero digits still allowed
+         * @param[in] max_exp - Largest exponent allowed for the next digit
+         */
+        void run(double residual, unsigned int left, int max_exp) {
+            auto const error = std::fabs(residual);
+            if (error < best_error || (error == best_error && left > best_left)) {
+                best_error = error;
+                best_residual = residual;
+                best_left = left;
+            }
+            // Another digit moves the residual by at least 1
+            if (left == 0U || max_exp < 0 || error <= 0.5) {
+                return;
+            }
+            // Digits up to 2^max_exp, non-adjacent, sum to at most (2^(max_exp+2) - 1) / 3
+            auto const reach = (power_of_two(max_exp + 2) - 1.0) / 3.0;
+            if (error - reach > best_error) {
+                return;
+            }
+            auto const sign = residual > 0.0 ? 1.0 : -1.0;
+            auto const lead = error < 1.0 ? 0 : std::ilogb(error);
+            // The nearest power first, which tends to find good bounds early
+            int exps[3] = {lead, lead + 1, lead - 1};
+            if (error > 1.5 * power_of_two(lead)) {
+                exps[0] = lead + 1;
+                exps[1] = lead;
+            }
+            for (auto exp : exps) {
+                if (exp < 0 || exp > max_exp) {
+                    continue;
+                }
+                run(residual - sign * power_of_two(exp), left - 1U, exp - 2);
+            }
+        }
+    };
+}  // namespace
+
+namespace csd {
+    auto quantize(double decimal_value, unsigned int nnz, unsigned int places) -> double {
+        auto const target = std::ldexp(decimal_value, int(places));
+        if (!std::isfinite(target)) {
+            CSD_THROW(std::invalid_argument("Value to quantize must be finite"));
+        }
+        Search search{std::fabs(target), target, nnz};
+        auto const error = std::fabs(target);
+        auto const top = error < 1.0 ? 0 : std::ilogb(error) + 1;
+        search.run(target, nnz, top);
+        return std::ldexp(target - search.best_residual, -int(places));
+    }
+
+    auto quantize(const double *values, size_t n, unsigned int nnz, unsigned int places,
+                  double *out) -> void {
+        for (size_t i = 0U; i != n; ++i) {
+            out[i] = quantize(values[i], nnz, places);
+        }
+    }
+
+    /**
+     * @brief The CSD form of the best approximation
+     *
+     * The digits are the non-adjacent form of the integer `value * 2^places`,
+     * made exact as a `BigInt`, with the point inserted `places` digits from
+     * the end.
+     */
+    auto to_csd_optimal(double decimal_value, unsigned int nnz, unsigned int places)
+        -> std::string {
+        auto const scaled = std::ldexp(quantize(decimal_value, nnz, places), int(places));
+        auto exp = 0;
+        auto const mantissa = std::frexp(std::fabs(scaled), &exp);
+        std::vector<std::uint64_t> limbs;
+        if (scaled != 0.0) {
+            // 53-bit integral mantissa, shifted up by exp - 53 >= 0 when exp > 53
+            auto const shift = exp > 53 ? exp - 53 : 0;
+            auto const integer = std::uint64_t(std::ldexp(mantissa, exp - shift));
+            limbs.assign(size_t(shift) / 64U + 2U, 0U);
+            auto const bit = unsigned(shift) % 64U;
+            limbs[size_t(shift) / 64U] = integer << bit;
+            limbs[size_t(shift) / 64U + 1U] = bit == 0U ? 0U : integer >> (64U - bit);
+        }
+        auto digits = to_csd_wide(BigInt(scaled < 0.0, std::move(limbs)));
+        if (digits == "0") {
+            digits.clear();
+        }
+        if (digits.size() <= places) {
+            digits.insert(0U, places + 1U - digits.size(), '0');
+        }
+        digits.insert(digits.size() - places, 1U, '.');
+        return digits;
+    }
+
+    /**
+     * @brief All the `to_csdfixed` approximations from one greedy expansion
+     *
+     * Like the `to_csdfixed` loop, the expansion stops below the binary
+     * point once the residual is at most 1e-100.
+     */
+    auto csdfixed_sweep(double decimal_value, unsigned int max_nnz, double *quantized,
+                        double *errors) -> void {
+        CsdGenerator gen(decimal_value);
+        CsdDigit digit{0, 0};
+        auto exhausted = false;
+        for (auto k = 0U; k != max_nnz; ++k) {
+            if (!exhausted) {
+                // Below every subnormal, where the residual is necessarily zero
+                auto const lowest = std::fabs(gen.residual()) > 1e-100 ? -1100 : 0;
+                exhausted = !gen.next_nonzero(lowest, digit);
+            }
+            quantized[k] = gen.approximation();
+            if (errors != nullptr) {
+                errors[k] = quantized[k] - decimal_value;
+            }
+        }
+    }
+
+    auto csdfixed_sweep(const double *values, size_t n, unsigned int max_nnz, double *quantized,
+                        double *errors) -> void {
+        for (size_t i = 0U; i != n; ++i) {
+            csdfixed_sweep(values[i], max_nnz, quantized + i * max_nnz,
+                           errors == nullptr ? nullptr : errors + i * max_nnz);
+        }
+    }
+}  // namespace csd
@@ -0,0 +1,336 @@
+/// @file reader.cpp
+#include <csd/batch.hpp>   // for to_decimal_batch
+#include <csd/reader.hpp>  // for MappedFile, decode_csd_text, read_csd_file
+#include <cstddef>         // for size_t
+#include <cstdio>          // for fopen, fread, ferror, fclose
+#include <cstring>         // for memchr
+#include <stdexcept>       // for invalid_argument, runtime_error
+#include <string>          // for basic_string, to_string
+#include <utility>         // for move
+#include <vector>          // for vector
+
+#if defined(_WIN32)
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+#    define CSD_READER_WIN32 1
+#elif defined(__unix__) || defined(__APPLE__)
+#    include <fcntl.h>     // for open, O_RDONLY
+#    include <sys/mman.h>  // for mmap, munmap, madvise
+#    include <sys/stat.h>  // for fstat
+#    include <unistd.h>    // for close
+#    define CSD_READER_POSIX 1
+#endif
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+namespace {
+    /** Fields handed to `to_decimal_batch` at a time */
+    constexpr size_t batch_fields = 4096U;
+
+    /**
+     * @brief Map the whole file read-only
+     *
+     * @return Whether the file could be mapped; an empty file counts as mapped
+     */
+    auto map_file(const string &path, const char *&data, size_t &size) -> bool {
+#if defined(CSD_READER_POSIX)
+        auto const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat info;
+        if (::fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+            ::close(fd);
+            return false;
+        }
+        size = size_t(info.st_size);
+        if (size == 0U) {
+            ::close(fd);
+            data = nullptr;
+            return true;
+        }
+        auto *const view = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // the mapping keeps the file open
+        if (view == MAP_FAILED) {
+            return false;
+        }
+#    ifdef MADV_SEQUENTIAL
+        ::madvise(view, size, MADV_SEQUENTIAL);
+#    endif
+        data = static_cast<const char *>(view);
+        return true;
+#elif defined(CSD_READER_WIN32)
+        auto const file = ::CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER length;
+        if (::GetFileSizeEx(file, &length) == 0) {
+            ::CloseHandle(file);
+            return false;
+        }
+        size = size_t(length.QuadPart);
+        if (size == 0U) {
+            ::CloseHandle(file);
+            data = nullptr;
+            return true;
+        }
+        auto const mapping = ::CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        ::CloseHandle(file);
+        if (mapping == nullptr) {
+            return false;
+        }
+        auto const view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(mapping);  // the view keeps the mapping alive
+        if (view == nullptr) {
+            return false;
+        }
+        data = static_cast<const char *>(view);
+        return true;
+#else
+        (void)path;
+        (void)data;
+        (void)size;
+        return false;
+#endif
+    }
+
+    auto unmap_file(const char *data, size_t size) -> void {
+        if (data == nullptr) {
+            return;
+        }
+#if defined(CSD_READER_POSIX)
+        ::munmap(const_cast<char *>(data), size);
+#elif defined(CSD_READER_WIN32)
+        (void)size;
+        ::UnmapViewOfFile(data);
+#else
+        (void)size;
+#endif
+    }
+
+    /**
+     * @brief Read the whole file into a buffer, for when it cannot be mapped
+     */
+    auto read_file(const string &path) -> vector<char> {
+        auto *const file = std::fopen(path.c_str(), "rb");
+        if (file == nullptr) {
+            CSD_THROW(std::runtime_error("Cannot open " + path));
+        }
+        vector<char> buffer(size_t{1U} << 16U);
+        auto size = size_t{0U};
+        for (;;) {
+            size += std::fread(buffer.data() + size, 1U, buffer.size() - size, file);
+            if (size != buffer.size()) {
+                break;
+            }
+            buffer.resize(2U * buffer.size());
+        }
+        auto const failed = std::ferror(file) != 0;
+        std::fclose(file);
+        if (failed) {
+            CSD_THROW(std::runtime_error("Error reading " + path));
+        }
+        buffer.resize(size);
+        return buffer;
+    }
+
+    auto is_blank(char c) -> bool { return c == ' ' || c == '\t'; }
+
+    /**
+     * @brief The message `to_decimal` throws for a field, or nullptr if it is valid
+     *
+     * Unlike `to_decimal`, a '\0' does not end the field: it is an invalid
+     * character like any other.
+     */
+    auto invalid_field(const char *begin, const char *end) -> const char * {
+        auto point = false;
+        for (; begin != end; ++begin) {
+            auto const c = *begin;
+            if (c == '0' || c == '+' || c == '-') {
+                continue;
+            }
+            if (c == '.' && !point) {
+                point = true;
+                continue;
+            }
+            return point ? "Fractional part work with 0, +, and - only"
+                         : "Work with 0, +, -, and . only";
+        }
+        return nullptr;
+    }
+
+    /**
+     * @brief Fields of a text collected for `to_decimal_batch`
+     */
+    struct Fields {
+        vector<const char *> starts;
+        vector<size_t> sizes;
+        vector<double> &out;
+        const char *text;   ///< start of the text, to number the lines
+        size_t first_line;  ///< number of the line at `text`
+        bool validate;      ///< whether to check every field, as `to_decimal_batch` stops at '\0'
+
+        auto add(const char *begin, const char *end) -> void {
+            while (begin != end && is_blank(*begin)) {
+                ++begin;
+            }
+            while (end != begin && is_blank(end[-1])) {
+                --end;
+            }
+            if (begin == end) {
+                return;
+            }
+            if (validate) {
+                check(begin, end);
+            }
+            starts.push_back(begin);
+            sizes.push_back(size_t(end - begin));
+            if (starts.size() == batch_fields) {
+                flush();
+            }
+        }
+
+        auto check(const char *begin, const char *end) const -> void {
+            auto const *const message = invalid_field(begin, end);
+            if (message == nullptr) {
+                return;
+            }
+            auto line = first_line;
+            for (auto const *c = text; c != begin; ++c) {
+                line += *c == '\n' ? 1U : 0U;
+            }
+            CSD_THROW(std::invalid_argument("line " + std::to_string(line) + ": " + message));
+        }
+
+        auto flush() -> void {
+            auto const done = out.size();
+            out.resize(done + starts.size());
+#ifdef CSD_HAS_EXCEPTIONS
+            try {
+                csd::to_decimal_batch(starts.data(), sizes.data(), starts.size(),
+                                      out.data() + done);
+            } catch (const std::invalid_argument &) {
+                // Find the first invalid field again, to tell its line
+                for (size_t i = 0U; i != starts.size(); ++i) {
+                    check(starts[i], starts[i] + sizes[i]);
+                }
+                throw;
+            }
+#else
+            csd::to_decimal_batch(starts.data(), sizes.data(), starts.size(), out.data() + done);
+#endif
+            starts.clear();
+            sizes.clear();
+        }
+    };
+
+    /**
+     * @brief Truncates the values back to their size on construction, unless kept
+     */
+    struct Rollback {
+        vector<double> &values;
+        size_t size;
+        bool keep;
+
+        ~Rollback() {
+            if (!keep) {
+                values.resize(size);
+            }
+        }
+    };
+}  // namespace
+
+namespace csd {
+    MappedFile::MappedFile(const string &path)
+        : data_(nullptr), size_(0U), mapped_(false), buffer_() {
+        if (map_file(path, data_, size_)) {
+            mapped_ = true;
+            return;
+        }
+        buffer_ = read_file(path);
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    MappedFile::~MappedFile() { release(); }
+
+    MappedFile::MappedFile(MappedFile &&other) noexcept
+        : data_(other.data_),
+          size_(other.size_),
+          mapped_(other.mapped_),
+          buffer_(std::move(other.buffer_)) {
+        other.data_ = nullptr;
+        other.size_ = 0U;
+        other.mapped_ = false;
+    }
+
+    auto MappedFile::operator=(MappedFile &&other) noexcept -> MappedFile & {
+        if (this != &other) {
+            release();
+            data_ = other.data_;
+            size_ = other.size_;
+            mapped_ = other.mapped_;
+            buffer_ = std::move(other.buffer_);
+            other.data_ = nullptr;
+            other.size_ = 0U;
+            other.mapped_ = false;
+        }
+        return *this;
+    }
+
+    auto MappedFile::release() -> void {
+        if (mapped_) {
+            unmap_file(data_, size_);
+        }
+        data_ = nullptr;
+        size_ = 0U;
+        mapped_ = false;
+        buffer_.clear();
+    }
+
+    auto decode_csd_text(const char *first, const char *last, char delimiter, vector<double> &out,
+                         size_t first_line) -> size_t {
+        Rollback rollback{out, out.size(), false};
+        auto const validate
+            = first != last && std::memchr(first, '\0', size_t(last - first)) != nullptr;
+        Fields fields{vector<const char *>(), vector<size_t>(), out, first, first_line, validate};
+        fields.starts.reserve(batch_fields);
+        fields.sizes.reserve(batch_fields);
+        for (auto *line = first; line != last;) {
+            auto const *newline
+                = static_cast<const char *>(std::memchr(line, '\n', size_t(last - line)));
+            auto const *const next = newline == nullptr ? last : newline + 1;
+            auto const *line_end = newline == nullptr ? last : newline;
+            if (line_end != line && line_end[-1] == '\r') {
+                --line_end;
+            }
+            for (auto *field = line;;) {
+                auto const *comma = static_cast<const char *>(
+                    std::memchr(field, delimiter, size_t(line_end - field)));
+                if (comma == nullptr) {
+                    fields.add(field, line_end);
+                    break;
+                }
+                fields.add(field, comma);
+                field = comma + 1;
+            }
+            line = next;
+        }
+        fields.flush();
+        rollback.keep = true;
+        return out.size() - rollback.size;
+    }
+
+    auto read_csd_file(const string &path, char delimiter) -> vector<double> {
+        MappedFile const file(path);
+        vector<double> values;
+        decode_csd_text(file.data(), file.data() + file.size(), delimiter, values);
+        return values;
+    }
+}  // namespace csd
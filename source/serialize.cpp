@@ -0,0 +1,179 @@
+/// @file serialize.cpp
+#include <csd/packed.hpp>     // for PackedCsd, packed_max_digits, num_nonzeros
+#include <csd/reader.hpp>     // for MappedFile
+#include <csd/serialize.hpp>  // for serialize, deserialize, CsdEncoding
+#include <cstddef>            // for size_t
+#include <cstdint>            // for uint64_t
+#include <cstdio>             // for fopen, fwrite, fclose
+#include <cstring>            // for memcpy, memcmp
+#include <stdexcept>          // for runtime_error
+#include <string>             // for basic_string
+#include <vector>             // for vector
+
+#if (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__) || defined(_WIN32)
+#    define CSD_LITTLE_ENDIAN 1
+#endif
+
+using std::size_t;
+using std::uint64_t;
+using std::vector;
+
+namespace {
+    constexpr unsigned char magic[4] = {'C', 'S', 'D', 'T'};
+    constexpr size_t header_size = 16U;
+    constexpr unsigned int point_flag = 0x80U;
+
+    /** Sign bit of a sparse digit; the low six bits are its position */
+    constexpr unsigned int minus_flag = 0x80U;
+
+    auto mask_bytes(unsigned int length) -> unsigned int { return (length + 7U) / 8U; }
+
+    auto store_le(uint64_t value, unsigned int bytes, vector<unsigned char> &out) -> void {
+        for (auto i = 0U; i != bytes; ++i) {
+            out.push_back(static_cast<unsigned char>(value >> (8U * i)));
+        }
+    }
+
+    auto load_le(const unsigned char *data, unsigned int bytes) -> uint64_t {
+        auto value = uint64_t{0U};
+#ifdef CSD_LITTLE_ENDIAN
+        std::memcpy(&value, data, bytes);
+#else
+        for (auto i = 0U; i != bytes; ++i) {
+            value |= uint64_t(data[i]) << (8U * i);
+        }
+#endif
+        return value;
+    }
+
+    auto low_mask(unsigned int length) -> uint64_t {
+        return length >= 64U ? ~uint64_t{0U} : (uint64_t{1U} << length) - 1U;
+    }
+
+    /**
+     * @brief Bounds-checked cursor over a serialized table
+     */
+    struct Cursor {
+        const unsigned char *data;
+        const unsigned char *end;
+
+        auto take(size_t bytes) -> const unsigned char * {
+            if (size_t(end - data) < bytes) {
+                CSD_THROW(std::runtime_error("Truncated CSD table"));
+            }
+            auto const *const res = data;
+            data += bytes;
+            return res;
+        }
+
+        auto byte() -> unsigned int { return *take(1U); }
+    };
+
+    [[noreturn]] auto malformed() -> void {
+        CSD_THROW(std::runtime_error("Malformed CSD table record"));
+    }
+}  // namespace
+
+namespace csd {
+    auto serialize(const PackedCsd *csds, size_t n, CsdEncoding encoding)
+        -> vector<unsigned char> {
+        vector<unsigned char> out(magic, magic + sizeof magic);
+        out.push_back(csd_format_version);
+        out.push_back(static_cast<unsigned char>(encoding));
+        out.push_back(0U);
+        out.push_back(0U);
+        store_le(uint64_t(n), 8U, out);
+        out.reserve(header_size + n * (encoding == CsdEncoding::Dense ? 18U : 8U));
+        for (size_t i = 0U; i != n; ++i) {
+            auto const &csd = csds[i];
+            out.push_back(static_cast<unsigned char>(csd.length));
+            out.push_back(static_cast<unsigned char>(csd.frac | (csd.has_point ? point_flag : 0U)));
+            if (encoding == CsdEncoding::Dense) {
+                store_le(csd.pos, mask_bytes(csd.length), out);
+                store_le(csd.neg, mask_bytes(csd.length), out);
+                continue;
+            }
+            out.push_back(static_cast<unsigned char>(num_nonzeros(csd)));
+            for (auto mask = csd.pos | csd.neg; mask != 0U; mask &= mask - 1U) {
+                auto const bit = mask & (0U - mask);
+                auto const sign = (csd.neg & bit) != 0U ? minus_flag : 0U;
+                out.push_back(static_cast<unsigned char>((bit_length(bit) - 1U) | sign));
+            }
+        }
+        return out;
+    }
+
+    auto deserialize(const unsigned char *data, size_t size) -> vector<PackedCsd> {
+        Cursor cursor{data, data + size};
+        auto const *const header = cursor.take(header_size);
+        if (std::memcmp(header, magic, sizeof magic) != 0) {
+            CSD_THROW(std::runtime_error("Not a CSD table"));
+        }
+        if (header[4] != csd_format_version) {
+            CSD_THROW(std::runtime_error("Unsupported CSD table version"));
+        }
+        if (header[5] > static_cast<unsigned char>(CsdEncoding::Sparse)) {
+            CSD_THROW(std::runtime_error("Unknown CSD table encoding"));
+        }
+        auto const encoding = static_cast<CsdEncoding>(header[5]);
+        auto const count = load_le(header + 8U, 8U);
+        // Every record takes at least two bytes
+        if (count > (size - header_size) / 2U) {
+            CSD_THROW(std::runtime_error("Truncated CSD table"));
+        }
+
+        vector<PackedCsd> csds(static_cast<size_t>(count));
+        for (auto &csd : csds) {
+            csd.length = cursor.byte();
+            auto const flags = cursor.byte();
+            csd.frac = flags & ~point_flag;
+            csd.has_point = (flags & point_flag) != 0U;
+            if (csd.length > packed_max_digits || csd.frac > csd.length
+                || (!csd.has_point && csd.frac != 0U)) {
+                malformed();
+            }
+            if (encoding == CsdEncoding::Dense) {
+                auto const bytes = mask_bytes(csd.length);
+                csd.pos = load_le(cursor.take(bytes), bytes);
+                csd.neg = load_le(cursor.take(bytes), bytes);
+            } else {
+                auto const nnz = cursor.byte();
+                auto const *const digits = cursor.take(nnz);
+                for (auto i = 0U; i != nnz; ++i) {
+                    auto const bit = uint64_t{1U} << (digits[i] & (packed_max_digits - 1U));
+                    if ((digits[i] & ~(minus_flag | (packed_max_digits - 1U))) != 0U
+                        || ((csd.pos | csd.neg) & bit) != 0U) {
+                        malformed();
+                    }
+                    ((digits[i] & minus_flag) != 0U ? csd.neg : csd.pos) |= bit;
+                }
+            }
+            auto const digits = csd.pos | csd.neg;
+            if ((csd.pos & csd.neg) != 0U || (digits & ~low_mask(csd.length)) != 0U) {
+                malformed();
+            }
+        }
+        if (cursor.data != cursor.end) {
+            malformed();
+        }
+        return csds;
+    }
+
+    auto write_csd_table(const std::string &path, const vector<PackedCsd> &csds,
+                         CsdEncoding encoding) -> void {
+        auto const table = serialize(csds.data(), csds.size(), encoding);
+        auto *const file = std::fopen(path.c_str(), "wb");
+        if (file == nullptr) {
+            CSD_THROW(std::runtime_error("Cannot open " + path));
+        }
+        auto const written = std::fwrite(table.data(), 1U, table.size(), file);
+        if (std::fclose(file) != 0 || written != table.size()) {
+            CSD_THROW(std::runtime_error("Error writing " + path));
+        }
+    }
+
+    auto read_csd_table(const std::string &path) -> vector<PackedCsd> {
+        MappedFile const file(path);
+        return deserialize(reinterpret_cast<const unsigned char *>(file.data()), file.size());
+    }
+}  // namespace csd
@@ -0,0 +1,302 @@
+/// @file service.cpp
+#include <algorithm>             // for min
+#include <chrono>                // for steady_clock
+#include <condition_variable>    // for condition_variable
+#include <csd/csd.hpp>           // for to_decimal
+#include <csd/parallel.hpp>      // for to_csd_parallel, to_csdfixed_parallel, to_decimal_parallel
+#include <csd/service.hpp>       // for ConversionService, ServiceOptions, Completion
+#include <csd/string_table.hpp>  // for CsdStringTable
+#include <cstddef>               // for size_t
+#include <exception>             // for exception_ptr, current_exception, rethrow_exception
+#include <future>                // for promise, future
+#include <map>                   // for map
+#include <memory>                // for shared_ptr, make_shared
+#include <mutex>                 // for mutex, unique_lock, lock_guard
+#include <string>                // for basic_string
+#include <thread>                // for thread
+#include <utility>               // for move, pair
+#include <vector>                // for vector
+
+using std::size_t;
+using std::string;
+using std::vector;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+    using csd::Completion;
+
+    enum class Operation { Csd, CsdFixed, Decimal };
+
+    /** Requests that can share a kernel call: the operation and its `places` or `nnz` */
+    using BatchKey = std::pair<Operation, long long>;
+
+    struct Batch {
+        Clock::time_point deadline;
+        vector<double> values;
+        vector<string> csds;
+        vector<Completion<string>> string_done;
+        vector<Completion<double>> decimal_done;
+
+        auto size() const -> size_t { return string_done.size() + decimal_done.size(); }
+    };
+
+    template <typename T> auto complete_promise(std::shared_ptr<std::promise<T>> promise)
+        -> Completion<T> {
+        return [promise](T value, std::exception_ptr error) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value(std::move(value));
+            }
+        };
+    }
+
+    /**
+     * @brief Run a completion once, with the value of `get` or the exception it throws
+     *
+     * An exception escaping the completion itself has nobody to go to, and
+     * is dropped so that the other completions of the batch still run.
+     */
+    template <typename T, typename Get> auto complete(const Completion<T> &done, Get get)
+        -> void {
+#ifdef CSD_HAS_EXCEPTIONS
+        T value{};
+        std::exception_ptr error;
+        try {
+            value = get();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        try {
+            done(std::move(value), error);
+        } catch (...) {
+        }
+#else
+        done(get(), nullptr);
+#endif
+    }
+
+    auto convert_csd(const BatchKey &key, const Batch &batch, unsigned int threads)
+        -> csd::CsdStringTable {
+        if (key.first == Operation::Csd) {
+            return csd::to_csd_parallel(batch.values.data(), batch.values.size(),
+                                        static_cast<int>(key.second), threads);
+        }
+        return csd::to_csdfixed_parallel(batch.values.data(), batch.values.size(),
+                                         static_cast<unsigned int>(key.second), threads);
+    }
+
+    auto convert_decimal(const Batch &batch, unsigned int threads) -> vector<double> {
+        auto const n = batch.csds.size();
+        vector<const char *> pointers(n);
+        for (size_t i = 0U; i != n; ++i) {
+            pointers[i] = batch.csds[i].c_str();
+        }
+        vector<double> decimals(n);
+        csd::to_decimal_parallel(pointers.data(), n, decimals.data(), threads);
+        return decimals;
+    }
+
+    auto run_batch(const BatchKey &key, Batch &batch, unsigned int threads) -> void {
+        if (key.first != Operation::Decimal) {
+            csd::CsdStringTable table;
+            std::exception_ptr error;
+#ifdef CSD_HAS_EXCEPTIONS
+            try {
+                table = convert_csd(key, batch, threads);
+            } catch (...) {
+                error = std::current_exception();
+            }
+#else
+            table = convert_csd(key, batch, threads);
+#endif
+            for (size_t i = 0U; i != batch.string_done.size(); ++i) {
+                complete(batch.string_done[i], [&]() -> string {
+                    if (error) {
+                        std::rethrow_exception(error);
+                    }
+                    return table.str(i);
+                });
+            }
+            return;
+        }
+
+        vector<double> decimals;
+#ifdef CSD_HAS_EXCEPTIONS
+        try {
+            decimals = convert_decimal(batch, threads);
+        } catch (...) {
+            // Find the failing strings one by one, so that the others still succeed
+            for (size_t i = 0U; i != batch.csds.size(); ++i) {
+                complete(batch.decimal_done[i],
+                         [&] { return csd::to_decimal(batch.csds[i].c_str()); });
+            }
+            return;
+        }
+#else
+        decimals = convert_decimal(batch, threads);
+#endif
+        for (size_t i = 0U; i != decimals.size(); ++i) {
+            complete(batch.decimal_done[i], [&] { return decimals[i]; });
+        }
+    }
+}  // namespace
+
+namespace csd {
+    struct ConversionService::Impl {
+        ServiceOptions options;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::map<BatchKey, Batch> queues;
+        size_t batches = 0U;
+        bool stopping = false;
+        std::thread worker;
+
+        explicit Impl(const ServiceOptions &opts) : options(opts) {
+            if (options.max_batch == 0U) {
+                options.max_batch = 1U;
+            }
+            worker = std::thread([this] { run(); });
+        }
+
+        /**
+         * @brief Queue one request, creating its batch and deadline if needed
+         *
+         * The worker is woken when a batch starts (its deadline may be
+         * earlier than the one it sleeps until) or fills up.
+         */
+        template <typename Add> auto submit(const BatchKey &key, Add add) -> void {
+            auto notify = false;
+            {
+                std::lock_guard<std::mutex> const lock(mutex);
+                auto &batch = queues[key];
+                if (batch.size() == 0U) {
+                    batch.deadline = Clock::now() + options.max_delay;
+                    notify = true;
+                }
+                add(batch);
+                notify = notify || batch.size() >= options.max_batch;
+            }
+            if (notify) {
+                wake.notify_one();
+            }
+        }
+
+        auto run() -> void {
+            std::unique_lock<std::mutex> lock(mutex);
+            for (;;) {
+                if (queues.empty()) {
+                    if (stopping) {
+                        return;
+                    }
+                    wake.wait(lock);
+                    continue;
+                }
+                // The full or overdue batch, or else the next deadline
+                auto const now = Clock::now();
+                auto ready = queues.end();
+                auto next = Clock::time_point::max();
+                for (auto it = queues.begin(); it != queues.end(); ++it) {
+                    auto const &batch = it->second;
+                    if (stopping || batch.size() >= options.max_batch || batch.deadline <= now) {
+                        ready = it;
+                        break;
+                    }
+                    next = std::min(next, batch.deadline);
+                }
+                if (ready == queues.end()) {
+                    wake.wait_until(lock, next);
+                    continue;
+                }
+                auto const key = ready->first;
+                auto batch = std::move(ready->second);
+                queues.erase(ready);
+                ++batches;
+                lock.unlock();
+#ifdef CSD_HAS_EXCEPTIONS
+                try {
+                    run_batch(key, batch, options.threads);
+                } catch (...) {
+                    // Whatever else fails (e.g. out of memory) must not end the worker
+                }
+#else
+                run_batch(key, batch, options.threads);
+#endif
+                lock.lock();
+            }
+        }
+    };
+
+    ConversionService::ConversionService(const ServiceOptions &options)
+        : impl_(new Impl(options)) {}
+
+    ConversionService::~ConversionService() {
+        {
+            std::lock_guard<std::mutex> const lock(impl_->mutex);
+            impl_->stopping = true;
+        }
+        impl_->wake.notify_one();
+        impl_->worker.join();
+    }
+
+    auto ConversionService::to_csd(double decimal_value, int places, Completion<string> done)
+        -> void {
+        impl_->submit(BatchKey(Operation::Csd, places), [&](Batch &batch) {
+            batch.values.push_back(decimal_value);
+            batch.string_done.push_back(std::move(done));
+        });
+    }
+
+    auto ConversionService::to_csdfixed(double decimal_value, unsigned int nnz,
+                                        Completion<string> done) -> void {
+        impl_->submit(BatchKey(Operation::CsdFixed, nnz), [&](Batch &batch) {
+            batch.values.push_back(decimal_value);
+            batch.string_done.push_back(std::move(done));
+        });
+    }
+
+    auto ConversionService::to_decimal(string csd, Completion<double> done) -> void {
+        impl_->submit(BatchKey(Operation::Decimal, 0), [&](Batch &batch) {
+            batch.csds.push_back(std::move(csd));
+            batch.decimal_done.push_back(std::move(done));
+        });
+    }
+
+    auto ConversionService::to_csd(double decimal_value, int places) -> std::future<string> {
+        auto promise = std::make_shared<std::promise<string>>();
+        auto result = promise->get_future();
+        to_csd(decimal_value, places, complete_promise(std::move(promise)));
+        return result;
+    }
+
+    auto ConversionService::to_csdfixed(double decimal_value, unsigned int nnz)
+        -> std::future<string> {
+        auto promise = std::make_shared<std::promise<string>>();
+        auto result = promise->get_future();
+        to_csdfixed(decimal_value, nnz, complete_promise(std::move(promise)));
+        return result;
+    }
+
+    auto ConversionService::to_decimal(string csd) -> std::future<double> {
+        auto promise = std::make_shared<std::promise<double>>();
+        auto result = promise->get_future();
+        to_decimal(std::move(csd), complete_promise(std::move(promise)));
+        return result;
+    }
+
+    auto ConversionService::flush() -> void {
+        {
+            std::lock_guard<std::mutex> const lock(impl_->mutex);
+            auto const now = Clock::now();
+            for (auto &queue : impl_->queues) {
+                queue.second.deadline = now;
+            }
+        }
+        impl_->wake.notify_one();
+    }
+
+    auto ConversionService::batches() const -> size_t {
+        std::lock_guard<std::mutex> const lock(impl_->mutex);
+        return impl_->batches;
+    }
+}  // namespace csd
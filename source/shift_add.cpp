@@ -0,0 +1,149 @@
+/// @file shift_add.cpp
+#include <csd/packed.hpp>     // for PackedCsd
+#include <csd/shift_add.hpp>  // for ShiftAddProgram, ShiftAddTerm
+#include <cstdint>            // for uint64_t
+#include <stdexcept>          // for invalid_argument
+#include <string>             // for basic_string, to_string
+#include <vector>             // for vector
+
+using std::string;
+
+namespace {
+    using csd::ShiftAddProgram;
+
+    /**
+     * @brief Drop the common trailing zeros of the terms and the final shift
+     */
+    auto normalize(ShiftAddProgram &program) -> void {
+        auto common = program.frac;
+        for (auto const &term : program.terms) {
+            common = term.shift < common ? term.shift : common;
+        }
+        for (auto &term : program.terms) {
+            term.shift -= common;
+        }
+        program.frac -= common;
+    }
+
+    /**
+     * @brief The shifted input `x << shift` as an operand, in C or Verilog syntax
+     */
+    auto shifted(const string &input, unsigned int shift, const char *op) -> string {
+        if (shift == 0U) {
+            return input;
+        }
+        return "(" + input + " " + op + " " + std::to_string(shift) + ")";
+    }
+
+    /**
+     * @brief The sum of the shifted terms, e.g. "(x << 6) - (x << 3) + x"
+     */
+    auto sum_of_terms(const ShiftAddProgram &program, const string &input, const char *op)
+        -> string {
+        string res;
+        for (auto const &term : program.terms) {
+            if (res.empty()) {
+                res = term.sign > 0 ? "" : "-";
+            } else {
+                res += term.sign > 0 ? " + " : " - ";
+            }
+            res += shifted(input, term.shift, op);
+        }
+        return res;
+    }
+}  // namespace
+
+namespace csd {
+    /**
+     * @brief Build the shift-and-add program of a CSD string
+     *
+     * The digits are scanned once; a digit `k` places before the end of the
+     * string gets the shift `k`, and the number of fractional digits becomes
+     * the final right shift.
+     *
+     * @param[in] csd - Pointer to the null-terminated CSD string
+     * @return The shift-and-add program
+     */
+    auto to_shift_add(const char *csd) -> ShiftAddProgram {
+        ShiftAddProgram program{{}, 0U};
+        auto has_point = false;
+        auto length = 0U;
+        for (; *csd != '\0'; ++csd) {
+            auto const digit = *csd;
+            if (digit == '.' && !has_point) {
+                has_point = true;
+                continue;
+            }
+            if (digit == '+' || digit == '-') {
+                program.terms.push_back(ShiftAddTerm{length, digit == '+' ? 1 : -1});
+            } else if (digit != '0') {
+                if (has_point) {
+                    CSD_THROW(std::invalid_argument("Fractional part work with 0, +, and - only"));
+                }
+                CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
+            }
+            ++length;
+            if (has_point) {
+                ++program.frac;
+            }
+        }
+        // The digit index counts from the front, the shift from the back
+        for (auto &term : program.terms) {
+            term.shift = length - 1U - term.shift;
+        }
+        normalize(program);
+        return program;
+    }
+
+    auto to_shift_add(const PackedCsd &csd) -> ShiftAddProgram {
+        ShiftAddProgram program{{}, csd.frac};
+        for (auto i = csd.length; i != 0U; --i) {
+            auto const bit = std::uint64_t{1U} << (i - 1U);
+            if ((csd.pos & bit) != 0U) {
+                program.terms.push_back(ShiftAddTerm{i - 1U, 1});
+            } else if ((csd.neg & bit) != 0U) {
+                program.terms.push_back(ShiftAddTerm{i - 1U, -1});
+            }
+        }
+        normalize(program);
+        return program;
+    }
+
+    auto to_c_expression(const ShiftAddProgram &program, const string &input) -> string {
+        if (program.terms.empty()) {
+            return "0";
+        }
+        auto res = sum_of_terms(program, input, "<<");
+        if (program.frac == 0U) {
+            return program.terms.size() == 1U ? res : "(" + res + ")";
+        }
+        return "((" + res + ") >> " + std::to_string(program.frac) + ")";
+    }
+
+    /**
+     * @brief Emit a program as a Verilog module
+     *
+     * The output has `WIDTH + shift + 1` bits for the largest shift, enough
+     * for the worst-case sum of the shifted inputs. All operands are signed,
+     * so the context-determined width of the assignment sign-extends `x`
+     * before shifting.
+     */
+    auto to_verilog(const ShiftAddProgram &program, const string &module_name,
+                    unsigned int width) -> string {
+        auto const growth = program.terms.empty() ? 1U : program.terms.front().shift + 1U;
+        auto res = "module " + module_name + " #(\n" + "    parameter WIDTH = "
+                   + std::to_string(width) + "\n" + ") (\n"
+                   + "    input  wire signed [WIDTH-1:0] x,\n" + "    output wire signed [WIDTH+"
+                   + std::to_string(growth) + "-1:0] y\n" + ");\n";
+        if (program.terms.empty()) {
+            res += "    assign y = 0;\n";
+        } else if (program.frac == 0U) {
+            res += "    assign y = " + sum_of_terms(program, "x", "<<<") + ";\n";
+        } else {
+            res += "    assign y = (" + sum_of_terms(program, "x", "<<<") + ") >>> "
+                   + std::to_string(program.frac) + ";\n";
+        }
+        res += "endmodule\n";
+        return res;
+    }
+}  // namespace csd
@@ -0,0 +1,163 @@
+/// @file wide.cpp
+#include <algorithm>     // for reverse
+#include <csd/wide.hpp>  // for BigInt, to_csd_wide, to_decimal_wide
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint64_t
+#include <stdexcept>     // for invalid_argument
+#include <string>        // for basic_string
+#include <utility>       // for move
+#include <vector>        // for vector
+
+using std::size_t;
+using std::string;
+using std::uint64_t;
+
+namespace {
+    /** Largest power of ten in a limb */
+    constexpr uint64_t ten_pow_19 = 10000000000000000000U;
+
+    /**
+     * @brief Divide a magnitude in place by a limb-sized divisor
+     *
+     * @return The remainder
+     */
+    auto divide(std::vector<uint64_t> &limbs, uint64_t divisor) -> uint64_t {
+        auto rem = uint64_t{0U};
+        for (auto i = limbs.size(); i != 0U; --i) {
+            auto const limb = limbs[i - 1U];
+#if defined(__SIZEOF_INT128__)
+            auto const dividend = (csd::uint128_t{rem} << 64U) | limb;
+            limbs[i - 1U] = uint64_t(dividend / divisor);
+            rem = uint64_t(dividend % divisor);
+#else
+            // Long division of (rem, limb) one bit at a time, rem < divisor
+            auto quotient = uint64_t{0U};
+            for (auto bit = 64U; bit != 0U; --bit) {
+                auto const overflow = (rem >> 63U) != 0U;
+                rem = (rem << 1U) | ((limb >> (bit - 1U)) & 1U);
+                quotient <<= 1U;
+                if (overflow || rem >= divisor) {
+                    rem -= divisor;
+                    quotient |= 1U;
+                }
+            }
+            limbs[i - 1U] = quotient;
+#endif
+        }
+        while (!limbs.empty() && limbs.back() == 0U) {
+            limbs.pop_back();
+        }
+        return rem;
+    }
+}  // namespace
+
+namespace csd {
+    auto to_string(const BigInt &value) -> string {
+        if (value.limbs().empty()) {
+            return "0";
+        }
+        auto limbs = value.limbs();
+        string res;
+        while (!limbs.empty()) {
+            auto chunk = divide(limbs, ten_pow_19);
+            // Every chunk but the most significant one has all its 19 digits
+            for (auto i = 0U; i != 19U && (chunk != 0U || !limbs.empty()); ++i) {
+                res += char('0' + chunk % 10U);
+                chunk /= 10U;
+            }
+        }
+        if (value.negative()) {
+            res += '-';
+        }
+        std::reverse(res.begin(), res.end());
+        return res;
+    }
+
+    /**
+     * @brief Convert a big integer to CSD format
+     *
+     * For limb i, `x >> 1` takes its top bit from the low bit of limb i + 1,
+     * and `x + (x >> 1)` carries into limb i + 1; one extra limb holds the
+     * final carry, the top digit of the largest magnitudes.
+     */
+    auto to_csd_wide(const BigInt &decimal_value) -> string {
+        auto const &x = decimal_value.limbs();
+        if (x.empty()) {
+            return "0";
+        }
+        auto const n = x.size();
+        std::vector<uint64_t> pos(n + 1U);
+        std::vector<uint64_t> neg(n + 1U);
+        auto carry = uint64_t{0U};
+        for (size_t i = 0U; i != n; ++i) {
+            auto const next = i + 1U < n ? x[i + 1U] : uint64_t{0U};
+            auto const half = (x[i] >> 1U) | (next << 63U);
+            auto const partial = x[i] + half;
+            auto const triple = partial + carry;
+            carry = uint64_t{partial < x[i]} | uint64_t{triple < partial};
+            auto const nonzero = half ^ triple;
+            pos[i] = triple & nonzero;
+            neg[i] = half & nonzero;
+        }
+        // The top limb of x >> 1 is zero, so the carry is a lone '+' digit
+        pos[n] = carry;
+        if (decimal_value.negative()) {
+            pos.swap(neg);
+        }
+
+        auto top = n + 1U;
+        while ((pos[top - 1U] | neg[top - 1U]) == 0U) {
+            --top;
+        }
+        auto const leading = detail::bit_width(pos[top - 1U] | neg[top - 1U]);
+        string csd;
+        csd.reserve(leading + 64U * (top - 1U));
+        detail::append_digits(csd, pos[top - 1U], neg[top - 1U], leading);
+        for (auto i = top - 1U; i != 0U; --i) {
+            detail::append_digits(csd, pos[i - 1U], neg[i - 1U], 64U);
+        }
+        return csd;
+    }
+
+    template <> auto to_decimal_wide<BigInt>(const char *csd) -> BigInt {
+        auto const *last = csd;
+        for (; *last != '.' && *last != '\0'; ++last) {
+            if (*last != '0' && *last != '+' && *last != '-') {
+                CSD_THROW(std::invalid_argument("Work with 0, +, -, and . only"));
+            }
+        }
+        // Gather the masks from the last digit, one limb of 64 digits per step
+        auto const digits = size_t(last - csd);
+        std::vector<uint64_t> pos((digits + 63U) / 64U);
+        std::vector<uint64_t> neg(pos.size());
+        for (size_t limb = 0U; limb != pos.size(); ++limb) {
+            auto const count = digits - 64U * limb < 64U ? digits - 64U * limb : size_t{64U};
+            auto const *const first = last - 64U * limb - count;
+            auto p = uint64_t{0U};
+            auto m = uint64_t{0U};
+            for (size_t i = 0U; i != count; ++i) {
+                p = (p << 1U) | uint64_t{first[i] == '+'};
+                m = (m << 1U) | uint64_t{first[i] == '-'};
+            }
+            pos[limb] = p;
+            neg[limb] = m;
+        }
+
+        // The leading non-zero digit outweighs all the others, so it gives the sign
+        auto const *lead = csd;
+        while (lead != last && *lead == '0') {
+            ++lead;
+        }
+        auto const negative = lead != last && *lead == '-';
+        auto const &big = negative ? neg : pos;
+        auto const &small = negative ? pos : neg;
+        std::vector<uint64_t> magnitude(big.size());
+        auto borrow = uint64_t{0U};
+        for (size_t i = 0U; i != big.size(); ++i) {
+            auto const partial = big[i] - small[i];
+            magnitude[i] = partial - borrow;
+            borrow = uint64_t{big[i] < small[i]} | uint64_t{partial < borrow};
+        }
+        return BigInt(negative, std::move(magnitude));
+    }
+}  // namespace csd
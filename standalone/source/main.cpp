@@ -1,8 +1,65 @@
 #include <csd/csd.hpp>  // for to_decimal, to_csd, and to_csdfixed
+#include <cstdio>        // for fopen, fclose, stdin, stdout
 #include <cxxopts.hpp>
+#include <exception>  // for exception
 #include <iostream>
 #include <string>
 
+#include "stream.hpp"  // for convert_stream, StreamMode
+
+namespace {
+    /**
+     * @brief Run the streaming mode, one conversion per input line
+     *
+     * @return The exit code
+     */
+    auto run_stream(const std::string &input, const std::string &output, const std::string &mode,
+                    int places, int nnz) -> int {
+        auto stream_mode = csd_cli::StreamMode::ToDecimal;
+        if (mode == "to_csd") {
+            stream_mode = csd_cli::StreamMode::ToCsd;
+        } else if (mode == "to_csdfixed") {
+            stream_mode = csd_cli::StreamMode::ToCsdFixed;
+        } else if (mode != "to_decimal") {
+            std::cerr << "Unknown mode: " << mode << std::endl;
+            return 1;
+        }
+
+        auto *in = input.empty() ? stdin : std::fopen(input.c_str(), "rb");
+        if (in == nullptr) {
+            std::cerr << "Cannot open " << input << std::endl;
+            return 1;
+        }
+        auto *out = output.empty() ? stdout : std::fopen(output.c_str(), "wb");
+        if (out == nullptr) {
+            std::cerr << "Cannot open " << output << std::endl;
+            if (in != stdin) {
+                std::fclose(in);
+            }
+            return 1;
+        }
+
+        auto status = 0;
+        try {
+            if (stream_mode == csd_cli::StreamMode::ToDecimal && in != stdin) {
+                csd_cli::convert_file(input, out);  // mapped, decoded in place
+            } else {
+                csd_cli::convert_stream(in, out, stream_mode, places, (unsigned int)(nnz));
+            }
+        } catch (const std::exception &e) {
+            std::cerr << e.what() << std::endl;
+            status = 1;
+        }
+        if (in != stdin) {
+            std::fclose(in);
+        }
+        if (out != stdout && std::fclose(out) != 0) {
+            status = 1;
+        }
+        return status;
+    }
+}  // namespace
+
 // #include <unordered_map>
 
 auto main(int argc, char **argv) -> int {
@@ -13,6 +70,9 @@ auto main(int argc, char **argv) -> int {
     std::string csdstr;
     int nnz;
     int places;
+    std::string input;
+    std::string output;
+    std::string mode;
     const double INFTY = -1.0e100;
 
     // clang-format off
@@ -24,6 +84,10 @@ auto main(int argc, char **argv) -> int {
     ("f,to_csdfixed", "Convert to CSD with number of non-zeros", cxxopts::value(decimal2)->default_value("-1.0e100"))
     ("p,place", "Number of places", cxxopts::value(places)->default_value("4"))
     ("z,nnz", "Number of non-zeros", cxxopts::value(nnz)->default_value("3"))
+    ("s,stream", "Convert one value per line (from stdin or --input)")
+    ("i,input", "Input file for the streaming mode (memory-mapped for to_decimal)", cxxopts::value(input)->default_value(""))
+    ("o,output", "Output file for the streaming mode", cxxopts::value(output)->default_value(""))
+    ("m,mode", "Streaming conversion: to_decimal, to_csd or to_csdfixed", cxxopts::value(mode)->default_value("to_decimal"))
   ;
     // clang-format on
 
@@ -40,6 +104,10 @@ auto main(int argc, char **argv) -> int {
         return 0;
     }
 
+    if (result["stream"].as<bool>() || !input.empty() || !output.empty()) {
+        return run_stream(input, output, mode, places, nnz);
+    }
+
     if (decimal != INFTY) {
         std::cout << csd::to_csd(decimal, places) << std::endl;
     }
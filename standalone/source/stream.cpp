@@ -0,0 +1,200 @@
+/// @file stream.cpp
+#include "stream.hpp"
+
+#include <algorithm>       // for count
+#include <csd/csd.hpp>     // for to_csd_into, to_csdfixed_into, to_csd_length
+#include <csd/reader.hpp>  // for decode_csd_text, read_csd_file
+#include <cstddef>         // for size_t
+#include <cstdio>          // for fread, fwrite, snprintf, ferror
+#include <cstdlib>         // for strtod
+#include <cstring>         // for memchr, memmove
+#include <stdexcept>       // for invalid_argument, runtime_error
+#include <string>          // for basic_string, to_string
+#include <vector>          // for vector
+
+#if defined(__has_include)
+#    if __has_include(<charconv>)
+#        include <charconv>  // for to_chars
+#    endif
+#endif
+
+using std::size_t;
+using std::string;
+using std::vector;
+
+namespace {
+    /** Bytes read per chunk (a longer line grows the buffer) */
+    constexpr size_t chunk_size = size_t{1U} << 20U;
+
+    /**
+     * @brief Terminate every complete line of [first, last) in place
+     *
+     * The '\n' (and a '\r' before it) become '\0', so that every line is a
+     * null-terminated string, and the non-empty lines are collected with
+     * their numbers.
+     *
+     * @param[in,out] line_number - The number of the line at `first`, then past the last one
+     * @return Past the last complete line
+     */
+    auto split_lines(char *first, char *last, vector<const char *> &lines,
+                     vector<size_t> &numbers, size_t &line_number) -> char * {
+        lines.clear();
+        numbers.clear();
+        auto *line = first;
+        while (line != last) {
+            auto *const newline
+                = static_cast<char *>(std::memchr(line, '\n', size_t(last - line)));
+            if (newline == nullptr) {
+                break;
+            }
+            *newline = '\0';
+            if (newline != line && newline[-1] == '\r') {
+                newline[-1] = '\0';
+            }
+            if (*line != '\0') {
+                lines.push_back(line);
+                numbers.push_back(line_number);
+            }
+            ++line_number;
+            line = newline + 1;
+        }
+        return line;
+    }
+
+    /**
+     * @brief Past the last '\n' of [first, last), or `first` if there is none
+     */
+    auto past_last_line(char *first, char *last) -> char * {
+        while (last != first && last[-1] != '\n') {
+            --last;
+        }
+        return last;
+    }
+
+    auto parse_decimal(const char *line, size_t line_number) -> double {
+        char *end = nullptr;
+        auto const value = std::strtod(line, &end);
+        if (end == line || *end != '\0') {
+            throw std::invalid_argument("line " + std::to_string(line_number)
+                                        + ": Not a decimal number: " + string(line));
+        }
+        return value;
+    }
+
+    /**
+     * @brief Append a double in the shortest form that reads back exactly
+     */
+    auto append_decimal(string &output, double value) -> void {
+        char text[32];
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+        auto const length = size_t(std::to_chars(text, text + sizeof text, value).ptr - text);
+#else
+        auto const length = size_t(std::snprintf(text, sizeof text, "%.17g", value));
+#endif
+        output.append(text, length);
+        output += '\n';
+    }
+
+    /**
+     * @brief Convert a group of decimal lines to CSD, appending one result line each
+     */
+    auto convert_lines(const vector<const char *> &lines, const vector<size_t> &numbers,
+                       csd_cli::StreamMode mode, int places, unsigned int nnz, string &output)
+        -> void {
+        for (size_t i = 0U; i != lines.size(); ++i) {
+            auto const value = parse_decimal(lines[i], numbers[i]);
+            auto const start = output.size();
+            if (mode == csd_cli::StreamMode::ToCsd) {
+                auto const length = csd::to_csd_length(value, places);
+                output.resize(start + length + 1U);
+                csd::to_csd_into(value, places, &output[start], length + 1U);
+                output.back() = '\n';
+                continue;
+            }
+            // Most results fit in 64 characters; retry once with the exact size
+            output.resize(start + 64U);
+            auto length = csd::to_csdfixed_into(value, nnz, &output[start], 64U);
+            if (length >= 64U) {
+                output.resize(start + length + 1U);
+                csd::to_csdfixed_into(value, nnz, &output[start], length + 1U);
+            }
+            output.resize(start + length);
+            output += '\n';
+        }
+    }
+
+    /**
+     * @brief Write the output, or throw
+     */
+    auto write_output(const string &output, std::FILE *out) -> void {
+        if (!output.empty() && std::fwrite(output.data(), 1U, output.size(), out) != output.size()) {
+            throw std::runtime_error("Error writing the output");
+        }
+    }
+}  // namespace
+
+namespace csd_cli {
+    auto convert_stream(std::FILE *in, std::FILE *out, StreamMode mode, int places,
+                        unsigned int nnz) -> unsigned long long {
+        auto buffer = vector<char>(chunk_size + 1U);
+        auto kept = size_t{0U};
+        vector<const char *> lines;
+        vector<size_t> numbers;
+        vector<double> values;
+        string output;
+        auto line_number = size_t{1U};
+        auto count = 0ULL;
+        for (;;) {
+            if (kept == buffer.size() - 1U) {
+                buffer.resize(2U * buffer.size() - 1U);  // a line longer than the buffer
+            }
+            auto const read = std::fread(buffer.data() + kept, 1U, buffer.size() - 1U - kept, in);
+            if (read == 0U && std::ferror(in) != 0) {
+                throw std::runtime_error("Error reading the input");
+            }
+            auto const eof = read == 0U;
+            auto end = kept + read;
+            if (eof && kept != 0U) {
+                buffer[end++] = '\n';  // the last line has no newline
+            }
+
+            auto *const first = buffer.data();
+            auto *rest = first;
+            output.clear();
+            if (mode == StreamMode::ToDecimal) {
+                // The same fields, and errors, as `convert_file`
+                rest = past_last_line(first, first + end);
+                values.clear();
+                count += csd::decode_csd_text(first, rest, ',', values, line_number);
+                line_number += size_t(std::count(first, rest, '\n'));
+                for (auto value : values) {
+                    append_decimal(output, value);
+                }
+            } else {
+                rest = split_lines(first, first + end, lines, numbers, line_number);
+                convert_lines(lines, numbers, mode, places, nnz, output);
+                count += lines.size();
+            }
+            write_output(output, out);
+
+            kept = size_t(first + end - rest);
+            std::memmove(first, rest, kept);
+            if (eof) {
+                return count;
+            }
+        }
+    }
+
+    auto convert_file(const std::string &path, std::FILE *out) -> unsigned long long {
+        auto const values = csd::read_csd_file(path);
+        string output;
+        for (size_t i = 0U; i != values.size(); ++i) {
+            append_decimal(output, values[i]);
+            if (output.size() >= chunk_size || i + 1U == values.size()) {
+                write_output(output, out);
+                output.clear();
+            }
+        }
+        return values.size();
+    }
+}  // namespace csd_cli
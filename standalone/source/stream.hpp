@@ -0,0 +1,55 @@
+/// @file stream.hpp
+#pragma once
+
+#include <cstdio>  // for FILE
+#include <string>  // for basic_string
+
+namespace csd_cli {
+
+    /** What the streaming mode converts each line with */
+    enum class StreamMode {
+        ToDecimal,   ///< CSD string to decimal, with `to_decimal_batch`
+        ToCsd,       ///< decimal to CSD with `places`, with `to_csd_into`
+        ToCsdFixed,  ///< decimal to CSD with `nnz` non-zeros, with `to_csdfixed_into`
+    };
+
+    /**
+     * @brief Convert newline-separated values from one stream to another
+     *
+     * The input is read in large chunks; all the complete lines of a chunk
+     * are converted together and their results are written with a single
+     * `fwrite`. Empty lines (and a trailing '\r') are ignored. For
+     * `StreamMode::ToDecimal`, the lines go through `csd::decode_csd_text`
+     * like the file in `convert_file`, so they may hold several fields
+     * separated by ','.
+     *
+     * @param[in] in - The input stream
+     * @param[in] out - The output stream
+     * @param[in] mode - The conversion to apply
+     * @param[in] places - The number of places for `StreamMode::ToCsd`
+     * @param[in] nnz - The number of non-zeros for `StreamMode::ToCsdFixed`
+     * @return The number of converted values
+     * @throw std::invalid_argument for a value that cannot be converted,
+     *        with a message starting with "line <n>: "
+     * @throw std::runtime_error if reading or writing fails
+     */
+    auto convert_stream(std::FILE *in, std::FILE *out, StreamMode mode, int places,
+                        unsigned int nnz) -> unsigned long long;
+
+    /**
+     * @brief Decode the CSD fields of a file, writing one decimal per line
+     *
+     * The file is memory-mapped and its fields (separated by ',' or line
+     * breaks) are decoded in place with `csd::read_csd_file`, which avoids
+     * the copies of `convert_stream`.
+     *
+     * @param[in] path - The input file
+     * @param[in] out - The output stream
+     * @return The number of converted fields
+     * @throw std::invalid_argument for a field that is not a CSD number,
+     *        with a message starting with "line <n>: "
+     * @throw std::runtime_error if reading or writing fails
+     */
+    auto convert_file(const std::string &path, std::FILE *out) -> unsigned long long;
+
+}  // namespace csd_cli
@@ -0,0 +1,270 @@
+/// @file differential.hpp
+#pragma once
+
+#include <cinttypes>     // for PRIx64
+#include <cstddef>       // for size_t
+#include <cstdint>       // for uint8_t, uint64_t
+#include <cstdio>        // for snprintf
+#include <cstring>       // for memcpy
+#include <stdexcept>     // for invalid_argument, length_error
+#include <string>        // for basic_string
+#include <system_error>  // for errc
+#include <vector>        // for vector
+
+#include <csd/batch.hpp>   // for to_decimal_batch
+#include <csd/csd.hpp>     // for to_csd, to_csd_reference, to_decimal, ...
+#include <csd/lcsre.hpp>   // for longest_repeated_substring, LcsreEngine
+#include <csd/packed.hpp>  // for to_csd_packed, to_csdfixed_packed, to_csd_i_packed, to_string
+
+/**
+ * Checks that the optimized paths give exactly the results of the
+ * reference implementations they replace, shared by the randomized test
+ * driver (test/source/test_differential.cpp) and the fuzzer (fuzz/).
+ *
+ * Every check returns an empty string when all the paths agree, and else
+ * a description of the first difference, with the input to reproduce it.
+ * The encoders of doubles take magnitudes below 2^1023, and below 2^1022
+ * for `to_csdfixed`: from there, the power of two that the references
+ * start from, 2^ceil(log2(1.5 |x|)), overflows.
+ */
+namespace differential {
+
+    /** A double with its bits, so that the inputs of a failure can be copied back */
+    inline auto describe(double value) -> std::string {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof bits);
+        char buffer[64];
+        std::snprintf(buffer, sizeof buffer, "%.17g (0x%016" PRIx64 ")", value, bits);
+        return buffer;
+    }
+
+    inline auto same_bits(double a, double b) -> bool {
+        return std::memcmp(&a, &b, sizeof a) == 0;
+    }
+
+    /** Digits of a CSD string, which must be at most 64 for the packed form */
+    inline auto digit_count(const std::string &csd) -> std::size_t {
+        return csd.size() - (csd.find('.') != std::string::npos ? 1U : 0U);
+    }
+
+    inline auto mismatch(const char *path, const std::string &input, const std::string &expected,
+                         const std::string &actual) -> std::string {
+        return std::string(path) + "(" + input + ") gave \"" + actual + "\" instead of \""
+               + expected + "\"";
+    }
+
+    /**
+     * @brief `to_csd` and the other encoders against `to_csd_reference`
+     *
+     * @param[in] value - A number, |value| < 2^1023
+     * @param[in] places - Any number of places, negative ones included
+     */
+    inline auto check_to_csd(double value, int places) -> std::string {
+        auto const input = describe(value) + ", " + std::to_string(places);
+        auto const expected = csd::to_csd_reference(value, places);
+        auto const fast = csd::to_csd(value, places);
+        if (fast != expected) {
+            return mismatch("to_csd", input, expected, fast);
+        }
+        if (csd::to_csd_length(value, places) != expected.size()) {
+            return "to_csd_length(" + input + ") differs from the length "
+                   + std::to_string(expected.size());
+        }
+        std::vector<char> buffer(expected.size() + 1U);
+        auto const length = csd::to_csd_into(value, places, buffer.data(), buffer.size());
+        auto const into = std::string(buffer.data(), length);
+        if (into != expected) {
+            return mismatch("to_csd_into", input, expected, into);
+        }
+        if (digit_count(expected) <= 64U) {
+            auto const packed = csd::to_string(csd::to_csd_packed(value, places));
+            if (packed != expected) {
+                return mismatch("to_csd_packed", input, expected, packed);
+            }
+        }
+        return std::string();
+    }
+
+    /**
+     * @brief `to_csdfixed` and `to_csdfixed_packed` against `to_csdfixed_reference`
+     *
+     * @param[in] value - A number, |value| < 2^1022
+     * @param[in] nnz - Any number of non-zero digits
+     */
+    inline auto check_to_csdfixed(double value, unsigned int nnz) -> std::string {
+        auto const input = describe(value) + ", " + std::to_string(nnz);
+        auto const expected = csd::to_csdfixed_reference(value, nnz);
+        auto const fast = csd::to_csdfixed(value, nnz);
+        if (fast != expected) {
+            return mismatch("to_csdfixed", input, expected, fast);
+        }
+        if (digit_count(expected) <= 64U) {
+            auto const packed = csd::to_string(csd::to_csdfixed_packed(value, nnz));
+            if (packed != expected) {
+                return mismatch("to_csdfixed_packed", input, expected, packed);
+            }
+        }
+        return std::string();
+    }
+
+    /** Largest magnitude of `to_csd_i_reference`, which works on 3 * value */
+    constexpr int max_csd_i_reference = 715827882;
+
+    /** No two adjacent non-zero digits, and no leading zero but for "0" */
+    inline auto is_canonical(const std::string &csd) -> bool {
+        for (std::size_t i = 1U; i < csd.size(); ++i) {
+            if (csd[i] != '0' && csd[i - 1U] != '0') {
+                return false;
+            }
+        }
+        return csd == "0" || (!csd.empty() && csd[0] != '0');
+    }
+
+    /**
+     * @brief `to_csd_i` and `to_csd_i_packed` against `to_csd_i_reference`
+     *
+     * Past the range of the reference, the result must be canonical and
+     * decode back to the value.
+     *
+     * @param[in] value - Any int, INT_MIN included
+     */
+    inline auto check_to_csd_i(int value) -> std::string {
+        auto const input = std::to_string(value);
+        auto const fast = csd::to_csd_i(value);
+        if (value >= -max_csd_i_reference && value <= max_csd_i_reference) {
+            auto const expected = csd::to_csd_i_reference(value);
+            if (fast != expected) {
+                return mismatch("to_csd_i", input, expected, fast);
+            }
+        } else {
+            auto decoded = 0;
+            auto const result = csd::to_decimal_i(fast.data(), fast.data() + fast.size(), decoded);
+            if (!is_canonical(fast) || result.ec != std::errc() || decoded != value) {
+                return "to_csd_i(" + input + ") gave \"" + fast + "\", not its CSD";
+            }
+        }
+        auto const packed = csd::to_string(csd::to_csd_i_packed(value));
+        if (packed != fast) {
+            return mismatch("to_csd_i_packed", input, fast, packed);
+        }
+        return std::string();
+    }
+
+    /**
+     * @brief Decode with `decode`, which must throw `std::invalid_argument`
+     *        exactly when the reference does, or else give the same bits
+     */
+    template <typename Decode>
+    auto check_decoder(const char *path, const std::string &csd, bool invalid, double expected,
+                       Decode decode) -> std::string {
+        double value = 0.0;
+        try {
+            value = decode();
+        } catch (const std::invalid_argument &) {
+            return invalid ? std::string() : std::string(path) + "(\"" + csd + "\") threw";
+        }
+        if (invalid) {
+            return std::string(path) + "(\"" + csd + "\") did not throw";
+        }
+        if (!same_bits(value, expected)) {
+            return mismatch(path, "\"" + csd + "\"", describe(expected), describe(value));
+        }
+        return std::string();
+    }
+
+    /**
+     * @brief The table and batch decoders against `to_decimal`
+     *
+     * @param[in] csd - Any characters, with at most 31 before the first
+     *            '.', the integral digits that `to_decimal` holds in an int
+     */
+    inline auto check_to_decimal(const std::string &csd) -> std::string {
+        auto const *const str = csd.c_str();
+        auto expected = 0.0;
+        auto invalid = false;
+        try {
+            expected = csd::to_decimal(str);
+        } catch (const std::invalid_argument &) {
+            invalid = true;
+        }
+        auto error = check_decoder("to_decimal_using_lut", csd, invalid, expected,
+                                   [&] { return csd::to_decimal_using_lut(str); });
+        if (error.empty()) {
+            error = check_decoder("to_decimal_batch", csd, invalid, expected, [&] {
+                double out;
+                csd::to_decimal_batch(&str, 1U, &out);
+                return out;
+            });
+        }
+        if (error.empty()) {
+            error = check_decoder("to_decimal_batch (ranges)", csd, invalid, expected, [&] {
+                auto const size = csd.size();
+                double out;
+                csd::to_decimal_batch(&str, &size, 1U, &out);
+                return out;
+            });
+        }
+        if (error.empty() && !invalid && csd.find_first_of("0+-") != std::string::npos) {
+            // The parser that does not throw wants at least one digit
+            auto value = 0.0;
+            auto const result = csd::to_decimal(str, str + csd.size(), value);
+            if (result.ec != std::errc() || result.ptr != str + csd.size()) {
+                error = "to_decimal(first, last) rejected \"" + csd + "\"";
+            } else if (!same_bits(value, expected)) {
+                error = mismatch("to_decimal(first, last)", "\"" + csd + "\"", describe(expected),
+                                 describe(value));
+            }
+        }
+        return error;
+    }
+
+    /**
+     * @brief The rolling-row and suffix-array engines against the O(n^2) table
+     *
+     * @param[in] csd - Any characters; the table makes long strings slow
+     */
+    inline auto check_lcsre(const std::string &csd) -> std::string {
+        auto const expected = csd::longest_repeated_substring(csd.c_str(), csd.size(),
+                                                              csd::LcsreEngine::DynamicProgramming);
+        struct Engine {
+            const char *path;
+            csd::LcsreEngine engine;
+        };
+        Engine const engines[] = {{"RollingRow", csd::LcsreEngine::RollingRow},
+                                  {"SuffixArray", csd::LcsreEngine::SuffixArray},
+                                  {"Auto", csd::LcsreEngine::Auto}};
+        for (auto const &engine : engines) {
+            auto const fast =
+                csd::longest_repeated_substring(csd.c_str(), csd.size(), engine.engine);
+            if (fast != expected) {
+                return mismatch(engine.path, "\"" + csd + "\"", expected, fast);
+            }
+        }
+        return std::string();
+    }
+
+    /**
+     * @brief Map fuzzer bytes to a mostly valid CSD string for `check_to_decimal`
+     *
+     * The two low bits of a byte pick '0', '+', '-' or '.', except that
+     * bytes from 0xF8 are kept as they are, to reach the error paths. A
+     * '.' is forced after 31 integral digits.
+     */
+    inline auto csd_from_bytes(const std::uint8_t *data, std::size_t size) -> std::string {
+        static const char digits[4] = {'0', '+', '-', '.'};
+        std::string csd;
+        csd.reserve(size);
+        auto integral = 0U;
+        auto point = false;
+        for (std::size_t i = 0U; i != size; ++i) {
+            auto c = data[i] >= 0xF8U ? static_cast<char>(data[i]) : digits[data[i] & 3U];
+            if (!point && c != '.' && ++integral > 31U) {
+                c = '.';
+            }
+            point = point || c == '.';
+            csd.push_back(c);
+        }
+        return csd;
+    }
+
+}  // namespace differential
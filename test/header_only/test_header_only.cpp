@@ -0,0 +1,31 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#ifndef CSD_HEADER_ONLY
+#    define CSD_HEADER_ONLY
+#endif
+
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>     // for to_csd, to_csd_i, to_csdfixed, to_decimal
+#include <csd/packed.hpp>  // for to_csd_packed, to_string
+#include <string>          // for basic_string
+
+using namespace csd;
+
+// Built without the compiled library: everything used here must come from the headers
+
+TEST_CASE("test header-only encoders") {
+    CHECK_EQ(to_csd(28.5, 2), "+00-00.+0");
+    CHECK_EQ(to_csd(-0.5, 2), "0.-0");
+    CHECK_EQ(to_csd_i(28), "+00-00");
+    CHECK_EQ(to_csdfixed(28.5, 2U), "+00-00");
+    CHECK_EQ(to_string(to_csd_packed(28.5, 2)), "+00-00.+0");
+    CHECK_EQ(to_decimal(to_csd(0.1, 20).c_str()), doctest::Approx(0.1).epsilon(1e-6));
+
+    char buffer[16];
+    CHECK_EQ(to_csd_into(28.5, 2, buffer, sizeof buffer), 9U);
+    CHECK_EQ(std::string(buffer), "+00-00.+0");
+#ifdef CSD_HAS_SPAN
+    CHECK_EQ(to_csdfixed_into(28.5, 2U, std::span<char>(buffer)), 6U);
+    CHECK_EQ(std::string(buffer), "+00-00");
+#endif
+}
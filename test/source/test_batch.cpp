@@ -0,0 +1,95 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/batch.hpp>  // for to_decimal_batch
+#include <csd/csd.hpp>    // for to_decimal, to_csd
+#include <cstddef>        // for size_t
+#include <cstdint>        // for uintptr_t
+#include <cstring>        // for memcpy, strlen
+#include <stdexcept>      // for length_error
+#include <string>         // for basic_string
+#include <vector>         // for vector
+
+using namespace csd;
+
+TEST_CASE("test to_decimal_batch") {
+    std::vector<std::string> csds{"+00-00.+", "0.-",  "0",  "0.0", "0.+", "",
+                                  "-0+0-.0-", ".+0-", "0.", "+00-00"};
+    csds.push_back(to_csd(-1234.5678, 40));  // longer than 64 characters
+    csds.push_back(to_csd(0.1, 60));          // more than 53 fractional digits
+    csds.push_back("+" + std::string(40, '0') + "-");
+    auto values = std::vector<double>(csds.size());
+    to_decimal_batch(csds.data(), csds.size(), values.data());
+    for (size_t i = 0U; i != csds.size(); ++i) {
+        CHECK_EQ(values[i], to_decimal(csds[i].c_str()));
+    }
+
+    std::vector<const char *> ptrs;
+    std::vector<size_t> sizes;
+    auto const line = std::string("+00-00.+ 0.- -0+0-.0-");
+    for (auto const pos : {0U, 9U, 13U}) {
+        ptrs.push_back(line.c_str() + pos);
+    }
+    sizes.assign({8U, 3U, 8U});
+    to_decimal_batch(ptrs.data(), sizes.data(), ptrs.size(), values.data());
+    CHECK_EQ(values[0], 28.5);
+    CHECK_EQ(values[1], -0.5);
+    CHECK_EQ(values[2], to_decimal("-0+0-.0-"));
+
+    ptrs.assign({"+00-00.+", "0.-"});
+    to_decimal_batch(ptrs.data(), ptrs.size(), values.data());
+    CHECK_EQ(values[0], 28.5);
+    CHECK_EQ(values[1], -0.5);
+
+#ifdef CSD_HAS_SPAN
+    to_decimal_batch(std::span<const std::string>(csds.data(), 2U), values);
+    CHECK_EQ(values[0], 28.5);
+    CHECK_EQ(values[1], -0.5);
+    CHECK_THROWS_AS(to_decimal_batch(ptrs, std::span<double>(values.data(), 1U)),
+                    std::length_error);
+#endif
+}
+
+TEST_CASE("test to_decimal_batch (invalid characters)") {
+    double value = 0.0;
+    auto const *const integral = "Work with 0, +, -, and . only";
+    auto const *const fractional = "Fractional part work with 0, +, and - only";
+    for (auto const *str : {"+00XX-00.+", "X", "+0 0", "+0-0+0-0+0-0+0-0+0-0+0-0+0-0+0-0+0-0X0"}) {
+        auto const csd = std::string(str);
+        auto const size = csd.size();
+        CHECK_THROWS_WITH_AS(to_decimal(str), integral, std::invalid_argument);
+        CHECK_THROWS_WITH_AS(to_decimal_batch(&str, 1U, &value), integral, std::invalid_argument);
+        CHECK_THROWS_WITH_AS(to_decimal_batch(&csd, 1U, &value), integral, std::invalid_argument);
+        CHECK_THROWS_WITH_AS(to_decimal_batch(&str, &size, 1U, &value), integral,
+                             std::invalid_argument);
+    }
+    for (auto const *str :
+         {"+00-00.+XXX", "+0.+.0", "0.+-.", ".0.", "0.000000000000000000000000000+X"}) {
+        auto const csd = std::string(str);
+        auto const size = csd.size();
+        CHECK_THROWS_WITH_AS(to_decimal(str), fractional, std::invalid_argument);
+        CHECK_THROWS_WITH_AS(to_decimal_batch(&str, 1U, &value), fractional,
+                             std::invalid_argument);
+        CHECK_THROWS_WITH_AS(to_decimal_batch(&csd, 1U, &value), fractional,
+                             std::invalid_argument);
+        CHECK_THROWS_WITH_AS(to_decimal_batch(&str, &size, 1U, &value), fractional,
+                             std::invalid_argument);
+    }
+}
+
+TEST_CASE("test to_decimal_batch (strings at the end of a page)") {
+    // The strings are read in place, except the ones too close to the end of their page
+    std::vector<char> buffer(3U * 4096U);
+    auto const *const csd = "+00-00.+0-";
+    auto const length = std::strlen(csd);
+    for (std::size_t end = 4096U - 70U; end != 4096U; ++end) {
+        auto const address = reinterpret_cast<std::uintptr_t>(buffer.data());
+        auto *const last = buffer.data() + (4096U - address % 4096U) + end;
+        std::memcpy(last - length, csd, length + 1U);
+        const char *const first = last - length;
+        double value = 0.0;
+        to_decimal_batch(&first, 1U, &value);
+        CHECK_EQ(value, to_decimal(csd));
+        to_decimal_batch(&first, &length, 1U, &value);
+        CHECK_EQ(value, to_decimal(csd));
+    }
+}
@@ -0,0 +1,84 @@
+#define DOCTEST_CONFIG_NO_EXCEPTIONS_BUT_WITH_ALL_ASSERTS
+
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/cache.hpp>  // for CsdCache
+#include <csd/csd.hpp>    // for to_csd, to_csdfixed
+#include <string>         // for basic_string
+#include <thread>         // for thread
+#include <vector>         // for vector
+
+using namespace csd;
+
+TEST_CASE("test CsdCache") {
+    CsdCache cache;
+    CHECK_EQ(cache.size(), 0U);
+    CHECK_EQ(cache.to_csd(28.5, 2), "+00-00.+0");
+    CHECK_EQ(cache.to_csd(28.5, 2), "+00-00.+0");
+    CHECK_EQ(cache.to_csdfixed(28.5, 2U), "+00-00");
+    CHECK_EQ(cache.to_csd(28.5, 4), to_csd(28.5, 4));
+    CHECK_EQ(cache.hits(), 1U);
+    CHECK_EQ(cache.misses(), 3U);
+    CHECK_EQ(cache.size(), 3U);
+
+    // The key is the bit pattern, so -0.0 is not 0.0
+    CHECK_EQ(cache.to_csd(-0.0, 2), to_csd(-0.0, 2));
+    CHECK_EQ(cache.misses(), 4U);
+
+    std::string csd;
+    for (auto round = 0; round != 3; ++round) {
+        for (auto i = -100; i <= 100; ++i) {
+            auto const value = i / 7.0;
+            CHECK_EQ(cache.to_csd_into(value, 12, csd), csd.size());
+            CHECK_EQ(csd, to_csd(value, 12));
+            CHECK_EQ(cache.to_csdfixed_into(value, 4U, csd), csd.size());
+            CHECK_EQ(csd, to_csdfixed(value, 4U));
+        }
+    }
+    CHECK_EQ(cache.misses(), 4U + 2U * 201U);
+    CHECK_EQ(cache.hits(), 1U + 2U * 2U * 201U);
+
+    cache.clear();
+    CHECK_EQ(cache.size(), 0U);
+    CHECK_EQ(cache.hits(), 0U);
+}
+
+TEST_CASE("test CsdCache (memory cap)") {
+    CsdCache cache(16U * 1024U);
+    for (auto i = 0; i != 10000; ++i) {
+        CHECK_EQ(cache.to_csd(i * 0.375, 40), to_csd(i * 0.375, 40));
+    }
+    CHECK(cache.size() <= cache.capacity());
+    CHECK(cache.capacity() < 10000U);
+    CHECK_EQ(cache.hits() + cache.misses(), 10000U);
+}
+
+TEST_CASE("test CsdCache (threads)") {
+    CsdCache cache;
+    auto const values = [] {
+        std::vector<double> res;
+        for (auto i = 0; i != 500; ++i) {
+            res.push_back(i * 0.01 - 2.5);
+        }
+        return res;
+    }();
+    std::vector<int> failures(4U, 0);
+    std::vector<std::thread> workers;
+    for (auto t = 0U; t != failures.size(); ++t) {
+        workers.emplace_back([&, t] {
+            for (auto round = 0; round != 5; ++round) {
+                for (auto value : values) {
+                    failures[t] += cache.to_csdfixed(value, 6U) != to_csdfixed(value, 6U);
+                }
+            }
+        });
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    for (auto failed : failures) {
+        CHECK_EQ(failed, 0);
+    }
+    CHECK_EQ(cache.hits() + cache.misses(), 4U * 5U * values.size());
+    CHECK(cache.hits() >= 4U * 4U * values.size());
+}
@@ -2,8 +2,13 @@
 
 #include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
 
-#include <csd/csd.hpp>  // for to_csd, to_decimal, to_csdfixed, to_decimal_using_switch
+#include <cmath>         // for ldexp, nextafter
+#include <csd/csd.hpp>   // for to_csd, to_decimal, to_csdfixed, to_decimal_using_switch
 #include <exception>
+#include <limits>        // for numeric_limits
+#include <string>        // for basic_string
+#include <system_error>  // for errc
+#include <vector>        // for vector
 
 using namespace csd;
 
@@ -18,6 +23,11 @@ TEST_CASE("test to_csd_i") {
     CHECK_EQ(to_csd_i(28), "+00-00");
     CHECK_EQ(to_csd_i(-0), "0");
     CHECK_EQ(to_csd_i(-0), "0");
+    CHECK_EQ(to_csd_i(3), "+0-");
+    CHECK_EQ(to_csd_i(-5), "-0-");
+    for (auto i = -1000; i <= 1000; ++i) {
+        CHECK_EQ(to_csd_i(i), to_csd_i_reference(i));
+    }
 }
 
 TEST_CASE("test to_decimal") {
@@ -42,6 +52,28 @@ TEST_CASE("test to_decimal_using_switch") {
     CHECK_THROWS(to_decimal_using_switch("+00-00.+XXX"));
 }
 
+TEST_CASE("test to_decimal_using_lut") {
+    CHECK_EQ(to_decimal_using_lut("+00-00.+"), 28.5);
+    CHECK_EQ(to_decimal_using_lut("0.-"), -0.5);
+    CHECK_EQ(to_decimal_using_lut("0"), 0.0);
+    CHECK_EQ(to_decimal_using_lut("0.0"), 0.0);
+    CHECK_EQ(to_decimal_using_lut("0.+"), 0.5);
+    CHECK_EQ(to_decimal_using_lut(""), 0.0);
+    CHECK_EQ(to_decimal_using_lut("."), 0.0);
+    CHECK_THROWS(to_decimal_using_lut("+00XX-00.+"));
+    CHECK_THROWS(to_decimal_using_lut("+00-00.+XXX"));
+    CHECK_THROWS(to_decimal_using_lut("+00-00.+0.0"));
+    CHECK_EQ(to_decimal_using_lut("+00-00+00+00-00+00+0-0+0+.+00+00-0++"),
+             to_decimal("+00-00+00+00-00+00+0-0+0+.+00+00-0++"));
+    // Every chunk offset and tail length, up to the table's limits and past them
+    for (auto value : {0.0, 1.0, -3.75, 28.5, 1234.5678, -98765.4321, 1e9 / 7.0}) {
+        for (auto places : {0, 1, 7, 8, 9, 23, 53, 60}) {
+            auto const csd = to_csd(value, places);
+            CHECK_EQ(to_decimal_using_lut(csd.c_str()), to_decimal(csd.c_str()));
+        }
+    }
+}
+
 TEST_CASE("test to_csdfixed") {
     CHECK_EQ(to_csdfixed(28.5, 4), "+00-00.+");
     CHECK_EQ(to_csdfixed(-0.5, 4), "0.-");
@@ -52,9 +84,173 @@ TEST_CASE("test to_csdfixed") {
     CHECK_EQ(to_csdfixed(28.5, 1), "+00000");
 }
 
+TEST_CASE("test to_csd against the reference loop") {
+    // Values near (2/3) 2^k and (4/3) 2^k sit on the rounding boundaries of 1.5 x
+    auto values = std::vector<double>{0.0,          -0.0,         1.0 / 3.0,   2.0 / 3.0,
+                                      4.0 / 3.0,    -8.0 / 3.0,   0.1,         -0.7,
+                                      28.5,         -1234.5678,   1e6 / 3.0,   3.14159265358979,
+                                      1e-30,        -1e-200,      1e30,        -9007199254740991.0};
+    for (auto k = -60; k <= 60; k += 7) {
+        for (auto base : {2.0 / 3.0, 4.0 / 3.0}) {
+            auto const value = std::ldexp(base, k);
+            values.push_back(value);
+            values.push_back(-std::nextafter(value, 0.0));
+            values.push_back(std::nextafter(value, 1e300));
+        }
+    }
+    for (auto value : values) {
+        for (auto places : {-1, 0, 3, 20, 64, 80, 140}) {
+            CHECK_EQ(to_csd(value, places), to_csd_reference(value, places));
+            CHECK_EQ(to_csd_length(value, places), to_csd(value, places).size());
+        }
+        for (auto nnz : {0U, 1U, 2U, 5U, 20U, 60U}) {
+            CHECK_EQ(to_csdfixed(value, nnz), to_csdfixed_reference(value, nnz));
+        }
+    }
+    // Down to the subnormals, where the reference loop rounds 1.5 x
+    auto const subnormals = std::vector<double>{std::ldexp(-double(0x018fe88ef243dLL), -1074),
+                                                std::ldexp(double(0x2aab), -1074),
+                                                std::numeric_limits<double>::denorm_min(),
+                                                std::numeric_limits<double>::min(),
+                                                std::ldexp(4.0 / 3.0, -1022),
+                                                -std::ldexp(2.0 / 3.0, -1000),
+                                                0.1};
+    for (auto value : subnormals) {
+        for (auto places : {1021, 1022, 1074, 1080, 1100}) {
+            CHECK_EQ(to_csd(value, places), to_csd_reference(value, places));
+        }
+    }
+}
+
+TEST_CASE("test to_csd_into") {
+    char buf[16];
+    CHECK_EQ(to_csd_length(28.5, 2), 9U);
+    CHECK_EQ(to_csd_into(28.5, 2, buf, sizeof buf), 9U);
+    CHECK_EQ(std::string(buf), "+00-00.+0");
+    CHECK_EQ(to_csd_into(28.5, 2, buf, 5U), 9U);
+    CHECK_EQ(std::string(buf), "+00-");
+    CHECK_EQ(to_csd_into(28.5, 2, buf, 0U), 9U);
+    CHECK_EQ(to_csdfixed_into(28.5, 4, buf, sizeof buf), 8U);
+    CHECK_EQ(std::string(buf), "+00-00.+");
+
+    std::string csd;
+    for (auto value : {0.0, -0.5, 0.75, 1.0, 28.5, -1234.5678, 1e6}) {
+        for (auto places : {0, 2, 8}) {
+            CHECK_EQ(to_csd_into(value, places, csd), to_csd_length(value, places));
+            CHECK_EQ(csd, to_csd(value, places));
+        }
+        CHECK_EQ(to_csdfixed_into(value, 3U, csd), csd.size());
+        CHECK_EQ(csd, to_csdfixed(value, 3U));
+    }
+}
+
 TEST_CASE("test to_decimal_i") {
     CHECK_EQ(to_decimal_i("+00-00"), 28);
     CHECK_EQ(to_decimal_i("0"), 0);
     CHECK_EQ(to_decimal_i("+00-00.00+"), 28);
+    // Negative prefixes keep doubling, without shifting a negative int
+    CHECK_EQ(to_decimal_i("-0"), -2);
+    CHECK_EQ(to_decimal_i("-0+"), -3);
+    CHECK_EQ(to_decimal_i("-0-"), -5);
+    CHECK_EQ(to_decimal_i(("-" + std::string(30, '0')).c_str()), -1073741824);
+    CHECK_EQ(to_decimal("-00.+"), -3.5);
+    // Past 31 digits, modulo 2^32
+    CHECK_EQ(to_decimal_i(("+" + std::string(31, '0')).c_str()), -2147483647 - 1);
+    CHECK_EQ(to_decimal_i(("+" + std::string(32, '0') + "+").c_str()), 1);
     // CHECK_THROWS(to_decimal_i("+00-00.00+"));
 }
+
+TEST_CASE("test to_decimal over a character range") {
+    const char *const csds[]
+        = {"+00-00.+", "0", "-", "+0+0-", ".+0-", "+00-00.", "0.000+", "-0+0-0-0+0+0-0+0.0-+"};
+    for (auto csd : csds) {
+        auto value = 0.0;
+        auto const end = csd + std::string(csd).size();
+        auto const result = to_decimal(csd, end, value);
+        CHECK(result.ec == std::errc());
+        CHECK_EQ(result.ptr, end);
+        CHECK_EQ(value, to_decimal(csd));
+    }
+
+    // No null terminator: the field ends where the range does
+    const char field[] = {'+', '0', '-', '.', '+', '+', '0'};
+    auto value = 0.0;
+    auto result = to_decimal(field, field + 5, value);
+    CHECK(result.ec == std::errc());
+    CHECK_EQ(result.ptr, field + 5);
+    CHECK_EQ(value, doctest::Approx(3.5));
+
+    // Parsing stops at the first character that does not belong to the number
+    const char row[] = "+0-.+,-0+";
+    result = to_decimal(row, row + sizeof row - 1, value);
+    CHECK(result.ec == std::errc());
+    CHECK_EQ(*result.ptr, ',');
+    CHECK_EQ(value, doctest::Approx(3.5));
+    result = to_decimal(result.ptr + 1, row + sizeof row - 1, value);
+    CHECK(result.ec == std::errc());
+    CHECK_EQ(value, doctest::Approx(-3.0));
+    result = to_decimal("+.+.+", "+.+.+" + 5, value);
+    CHECK_EQ(value, doctest::Approx(1.5));
+
+    // Errors leave the value alone
+    value = 42.0;
+    const char *const invalid[] = {"", ".", "x+0", ".x"};
+    for (auto csd : invalid) {
+        auto const end = csd + std::string(csd).size();
+        result = to_decimal(csd, end, value);
+        CHECK(result.ec == std::errc::invalid_argument);
+        CHECK_EQ(result.ptr, csd);
+        CHECK_EQ(value, 42.0);
+    }
+}
+
+TEST_CASE("test to_decimal_i over a character range") {
+    const char row[] = "+00-00.00+";
+    auto value = 0;
+    auto result = to_decimal_i(row, row + sizeof row - 1, value);
+    CHECK(result.ec == std::errc());
+    CHECK_EQ(*result.ptr, '.');
+    CHECK_EQ(value, 28);
+
+    result = to_decimal_i(row + 7, row + 7, value);
+    CHECK(result.ec == std::errc::invalid_argument);
+    CHECK_EQ(value, 28);
+
+    // INT_MIN and INT_MAX, and the values one past them
+    std::string const int_min = "-" + std::string(31, '0');
+    std::string const int_max = "+" + std::string(30, '0') + "-";
+    std::string const past_min = "-" + std::string(30, '0') + "-";
+    std::string const past_max = "+" + std::string(31, '0');
+    result = to_decimal_i(int_min.data(), int_min.data() + int_min.size(), value);
+    CHECK(result.ec == std::errc());
+    CHECK_EQ(value, -2147483647 - 1);
+    result = to_decimal_i(int_max.data(), int_max.data() + int_max.size(), value);
+    CHECK(result.ec == std::errc());
+    CHECK_EQ(value, 2147483647);
+    for (auto const &csd : {past_min, past_max, std::string(80, '+')}) {
+        result = to_decimal_i(csd.data(), csd.data() + csd.size(), value);
+        CHECK(result.ec == std::errc::result_out_of_range);
+        CHECK_EQ(result.ptr, csd.data() + csd.size());
+        CHECK_EQ(value, 2147483647);
+    }
+
+    // Trailing digits cannot bring an out-of-range prefix back
+    std::string const back = "+" + std::string(31, '0') + std::string(31, '-');
+    result = to_decimal_i(back.data(), back.data() + back.size(), value);
+    CHECK(result.ec == std::errc::result_out_of_range);
+}
+
+#ifdef CSD_HAS_STRING_VIEW
+TEST_CASE("test to_decimal over a string view") {
+    std::string_view const csd{"+00-00.+0-|spare"};
+    auto value = 0.0;
+    auto const result = to_decimal(csd.substr(0, 10), value);
+    CHECK(result.ec == std::errc());
+    CHECK_EQ(result.ptr, csd.data() + 10);
+    CHECK_EQ(value, doctest::Approx(28.375));
+
+    auto integer = 0;
+    CHECK(to_decimal_i(csd, integer).ec == std::errc());
+    CHECK_EQ(integer, 28);
+}
+#endif
@@ -0,0 +1,78 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>        // for to_csd, to_csd_i
+#include <csd/csd_const.hpp>  // for csd_const, to_fixed_csd, operator""_csd
+#include <cmath>              // for ldexp, nextafter
+#include <cstdint>            // for int64_t
+#include <string>             // for basic_string
+
+using namespace csd;
+
+TEST_CASE("test csd_const") {
+    static_assert(csd_const<28>::pos == 0x20U, "'+' digits of 28");
+    static_assert(csd_const<28>::neg == 0x04U, "'-' digits of 28");
+    static_assert(csd_const<28>::length == 6U, "digits of 28");
+    static_assert(csd_const<28>::nnz == 2U, "non-zero digits of 28");
+    static_assert(csd_const<-5>::neg == 0x05U, "'-' digits of -5");
+    static_assert(csd_const<0>::length == 1U, "digits of 0");
+    CHECK_EQ(csd_const<28>::value, to_csd_i_packed(28));
+    CHECK_EQ(csd_const<-123456>::value, to_csd_i_packed(-123456));
+}
+
+TEST_CASE("test to_fixed_csd") {
+#if __cpp_constexpr >= 201304
+    static_assert(to_fixed_csd_i(28) == "+00-00", "constexpr to_csd_i");
+    static_assert(to_fixed_csd(28.5, 2) == "+00-00.+0", "constexpr to_csd");
+    static_assert(to_fixed_csd(-0.5, 2) == "0.-0", "constexpr to_csd");
+    static_assert(to_fixed_csd(3.0, 0) == "+0-.", "constexpr to_csd at 2^2 - 1");
+    static_assert(to_fixed_csd(4.0, 0) == "+00.", "constexpr to_csd at 2^2");
+    static_assert(to_fixed_csd(5.0, 0) == "+0+.", "constexpr to_csd at 2^2 + 1");
+    static_assert(to_fixed_csd(1023.0, 0) == "+000000000-.", "constexpr to_csd at 2^10 - 1");
+    static_assert(to_fixed_csd(1024.0, 0) == "+0000000000.", "constexpr to_csd at 2^10");
+    static_assert(to_fixed_csd(-1025.0, 0) == "-000000000-.", "constexpr to_csd at -2^10 - 1");
+#endif
+    for (auto value : {0, 1, -1, 3, -5, 28, 1000, -123456}) {
+        CHECK_EQ(to_fixed_csd_i(value).str(), to_csd_i(value));
+    }
+    for (auto value : {0.0, -0.5, 0.1, 1.0, 3.75, 28.5, -1234.5678, 1e6}) {
+        for (auto places : {0, 2, 8}) {
+            CHECK_EQ(to_fixed_csd(value, places).str(), to_csd(value, places));
+        }
+    }
+    CHECK_THROWS(to_fixed_csd<8U>(28.5, 4));
+}
+
+TEST_CASE("test to_fixed_csd near powers of two") {
+    // Where 1.5 |x| is just above 2^m, log2 may round down onto m
+    for (auto m = 1; m != 1024; ++m) {
+        auto const power = std::ldexp(1.0, m);
+        for (auto base : {power, power / 1.5}) {
+            auto value = base;
+            for (auto i = 0; i != 8; ++i) {
+                value = std::nextafter(value, 0.0);
+            }
+            for (auto i = 0; i != 16; ++i, value = std::nextafter(value, power * 2.0)) {
+                CHECK_EQ(to_fixed_csd<1100U>(value, 0).str(), to_csd(value, 0));
+                CHECK_EQ(to_fixed_csd<1100U>(-value, 0).str(), to_csd(-value, 0));
+            }
+        }
+    }
+    for (auto k = 1; k != 53; ++k) {
+        auto const power = std::ldexp(1.0, k);
+        for (auto value : {power - 1.0, power, power + 1.0}) {
+            CHECK_EQ(to_fixed_csd(value, 2).str(), to_csd(value, 2));
+        }
+    }
+}
+
+TEST_CASE("test _csd literal") {
+#if __cpp_constexpr >= 201304
+    static_assert("+00-00.+"_csd.frac == 1U, "constexpr literal");
+    static_assert("+00-00"_csd == to_csd_i_packed(28), "constexpr literal");
+    static_assert(to_decimal_i("+00-00") == 28, "constexpr decoder");
+#endif
+    CHECK_EQ("+00-00.+0"_csd, to_packed("+00-00.+0"));
+    CHECK_EQ(to_string(".+"_csd), ".+");
+    CHECK_THROWS("+00XX-00.+"_csd);
+    CHECK_THROWS("+00-00.+XXX"_csd);
+}
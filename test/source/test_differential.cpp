@@ -0,0 +1,280 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <algorithm>  // for min
+#include <chrono>     // for steady_clock, duration
+#include <cmath>      // for fabs, ldexp, nextafter
+#include <cstddef>    // for size_t
+#include <cstdint>    // for uint8_t, uint64_t
+#include <cstdlib>    // for getenv, strtoul
+#include <cstring>    // for memcpy
+#include <limits>     // for numeric_limits
+#include <random>     // for mt19937_64, uniform_int_distribution
+#include <string>     // for basic_string
+#include <vector>     // for vector
+
+#include "../differential/differential.hpp"  // for check_to_csd, check_to_decimal, ...
+
+using namespace differential;
+
+/** Random inputs per check, `CSD_DIFFERENTIAL_ITERATIONS` to run longer */
+static auto iterations() -> unsigned long {
+    auto const *const env = std::getenv("CSD_DIFFERENTIAL_ITERATIONS");
+    return env != nullptr ? std::strtoul(env, nullptr, 10) : 2000UL;
+}
+
+/** The seed of the random inputs, `CSD_DIFFERENTIAL_SEED` to vary them */
+static auto seed() -> std::uint64_t {
+    auto const *const env = std::getenv("CSD_DIFFERENTIAL_SEED");
+    return env != nullptr ? std::strtoull(env, nullptr, 10) : 20240229U;
+}
+
+/** Bounds of the magnitudes given to the encoders, see differential.hpp */
+static const double max_csd = std::ldexp(1.0, 1023);
+static const double max_csdfixed = std::ldexp(1.0, 1022);
+
+/** Any double below `bound`, with every exponent as likely, subnormals included */
+static auto random_double(std::mt19937_64 &gen, double bound) -> double {
+    for (;;) {
+        auto const bits = gen();
+        double value;
+        std::memcpy(&value, &bits, sizeof value);
+        if (std::fabs(value) < bound) {
+            return value;
+        }
+    }
+}
+
+/**
+ * Powers of two and their neighbours, the boundaries of 2/3 and 4/3, and
+ * the extremes, up to `bound`
+ */
+static auto adversarial_doubles(double bound) -> std::vector<double> {
+    std::vector<double> values = {0.0,
+                                  -0.0,
+                                  std::numeric_limits<double>::denorm_min(),
+                                  -std::numeric_limits<double>::denorm_min(),
+                                  std::numeric_limits<double>::min(),
+                                  std::nextafter(std::numeric_limits<double>::min(), 0.0),
+                                  std::nextafter(bound, 0.0),
+                                  -std::nextafter(bound, 0.0),
+                                  std::numeric_limits<double>::epsilon(),
+                                  9007199254740991.0,
+                                  9007199254740993.0,
+                                  -2147483648.0,
+                                  2147483647.5};
+    for (auto k = -1074; k <= 1022; k += 13) {
+        for (auto base : {1.0, 2.0 / 3.0, 4.0 / 3.0}) {
+            auto const value = std::ldexp(base, k);
+            if (std::nextafter(value, 1e300) < bound) {
+                values.push_back(value);
+                values.push_back(-std::nextafter(value, 0.0));
+                values.push_back(std::nextafter(value, 1e300));
+            }
+        }
+    }
+    return values;
+}
+
+TEST_CASE("differential to_csd") {
+    for (auto value : adversarial_doubles(max_csd)) {
+        for (auto places : {-5, 0, 1, 52, 53, 64, 65, 1074, 1100}) {
+            CHECK_EQ(check_to_csd(value, places), "");
+        }
+    }
+    std::mt19937_64 gen(seed());
+    std::uniform_int_distribution<int> places(-2, 80);
+    std::uniform_int_distribution<int> huge_places(80, 1200);
+    for (auto i = iterations(); i != 0U; --i) {
+        auto const value = random_double(gen, max_csd);
+        CHECK_EQ(check_to_csd(value, places(gen)), "");
+        if (i % 16U == 0U) {
+            CHECK_EQ(check_to_csd(value, huge_places(gen)), "");
+        }
+    }
+}
+
+TEST_CASE("differential to_csdfixed") {
+    for (auto value : adversarial_doubles(max_csdfixed)) {
+        for (auto nnz : {0U, 1U, 2U, 32U, 53U, 64U, 65U, 200U}) {
+            CHECK_EQ(check_to_csdfixed(value, nnz), "");
+        }
+    }
+    std::mt19937_64 gen(seed());
+    std::uniform_int_distribution<unsigned int> nnz(0U, 70U);
+    for (auto i = iterations(); i != 0U; --i) {
+        CHECK_EQ(check_to_csdfixed(random_double(gen, max_csdfixed), nnz(gen)), "");
+    }
+}
+
+TEST_CASE("differential to_csd_i") {
+    auto const min = std::numeric_limits<int>::min();
+    auto const max = std::numeric_limits<int>::max();
+    auto const edge = max_csd_i_reference;
+    for (auto value : {min, min + 1, max, max - 1, 0, 1, -1, edge, edge + 1, -edge, -edge - 1}) {
+        CHECK_EQ(check_to_csd_i(value), "");
+    }
+    for (auto k = 0; k != 31; ++k) {
+        auto const power = static_cast<int>(1U << k);
+        for (auto value : {power, power - 1, power + 1, power / 3 * 2, power / 3 * 4}) {
+            CHECK_EQ(check_to_csd_i(value), "");
+            CHECK_EQ(check_to_csd_i(-value), "");
+        }
+    }
+    std::mt19937_64 gen(seed());
+    std::uniform_int_distribution<int> values(min, max);
+    for (auto i = iterations(); i != 0U; --i) {
+        CHECK_EQ(check_to_csd_i(values(gen)), "");
+    }
+}
+
+TEST_CASE("differential to_decimal") {
+    std::vector<std::string> csds = {"", ".", "0", "+.", ".-", "0.0.0", "+" + std::string(30, '0'),
+                                     "-" + std::string(30, '0') + "." + std::string(1100, '-')};
+    // An invalid character at the edges of the 16-, 32- and 64-character blocks
+    for (auto length : {15U, 16U, 17U, 31U, 32U, 33U, 63U, 64U, 65U, 100U}) {
+        auto const digits = "+0-" + std::string(length, '+');
+        auto csd = digits.substr(0U, 10U) + "." + digits.substr(10U);
+        csds.push_back(csd);
+        csd[length - 1U] = 'x';
+        csds.push_back(csd);
+    }
+    for (auto const &csd : csds) {
+        CHECK_EQ(check_to_decimal(csd), "");
+    }
+    std::mt19937_64 gen(seed());
+    std::uniform_int_distribution<std::size_t> sizes(0U, 150U);
+    std::uniform_int_distribution<unsigned int> bytes(0U, 255U);
+    std::vector<std::uint8_t> data;
+    for (auto i = iterations(); i != 0U; --i) {
+        data.resize(sizes(gen));
+        for (auto &byte : data) {
+            // Mostly valid digits, so that most strings get past the first error
+            byte = static_cast<std::uint8_t>(bytes(gen) % (i % 4U == 0U ? 256U : 248U));
+        }
+        CHECK_EQ(check_to_decimal(csd_from_bytes(data.data(), data.size())), "");
+    }
+}
+
+TEST_CASE("differential lcsre") {
+    std::vector<std::string> csds = {"", "0", "++", "+0+", "+0-0+0-0"};
+    for (auto length : {31U, 64U, 65U, 1030U}) {
+        csds.push_back(std::string(length, '+'));
+        std::string periodic;
+        for (auto i = 0U; i != length; ++i) {
+            periodic.push_back("+0-00"[i % 5U]);
+        }
+        csds.push_back(periodic);
+    }
+    for (auto const &csd : csds) {
+        CHECK_EQ(check_lcsre(csd), "");
+    }
+    std::mt19937_64 gen(seed());
+    std::uniform_int_distribution<std::size_t> sizes(0U, 300U);
+    std::uniform_int_distribution<unsigned int> alphabets(1U, 3U);
+    for (auto i = iterations() / 8U; i != 0U; --i) {
+        std::uniform_int_distribution<unsigned int> chars(0U, alphabets(gen) - 1U);
+        std::string csd(sizes(gen), '0');
+        for (auto &c : csd) {
+            c = "0+-"[chars(gen)];
+        }
+        CHECK_EQ(check_lcsre(csd), "");
+    }
+}
+
+/**
+ * Seconds per call of `run`, the best of a few rounds of `n` calls
+ */
+template <typename Run> static auto seconds_per_call(std::size_t n, Run run) -> double {
+    auto best = std::numeric_limits<double>::max();
+    for (auto round = 0; round != 5; ++round) {
+        auto const start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0U; i != n; ++i) {
+            run(i);
+        }
+        std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+        best = std::min(best, elapsed.count() / double(n));
+    }
+    return best;
+}
+
+/**
+ * The speedups of the fast paths over their references, when the
+ * `CSD_PERF_CHECK` environment variable is set; each one must stay over
+ * its floor, about half of what an optimized x86-64 build measures, so
+ * that a change that loses a fast path fails rather than just slows down.
+ * `to_csdfixed` spends as much on building its string as on its digits,
+ * so it only has to beat its reference by a fifth; `to_csd_i` is measured
+ * by its packed form, which builds no string at all.
+ */
+TEST_CASE("differential throughput") {
+    if (std::getenv("CSD_PERF_CHECK") == nullptr) {
+        return;
+    }
+    std::mt19937_64 gen(seed());
+    std::uniform_real_distribution<double> uniform(-1000.0, 1000.0);
+    constexpr std::size_t n = 1024U;
+    std::vector<double> values(n);
+    std::vector<std::string> csds(n);
+    std::vector<const char *> pointers(n);
+    for (std::size_t i = 0U; i != n; ++i) {
+        values[i] = uniform(gen);
+        csds[i] = csd::to_csd(values[i], 20);
+        pointers[i] = csds[i].c_str();
+    }
+    std::size_t sink = 0U;
+    auto ratio = [&](const char *name, double floor, double reference, double fast) {
+        auto const speedup = reference / fast;
+        MESSAGE(name << " speedup " << speedup << " (floor " << floor << ")");
+        CHECK_GE(speedup, floor);
+    };
+
+    auto const csd_reference = [&](std::size_t i) {
+        sink += csd::to_csd_reference(values[i], 20).size();
+    };
+    auto const csd_fast = [&](std::size_t i) { sink += csd::to_csd(values[i], 20).size(); };
+    ratio("to_csd", 1.3, seconds_per_call(n, csd_reference), seconds_per_call(n, csd_fast));
+    auto const fixed_reference = [&](std::size_t i) {
+        sink += csd::to_csdfixed_reference(values[i], 16U).size();
+    };
+    auto const fixed_fast = [&](std::size_t i) { sink += csd::to_csdfixed(values[i], 16U).size(); };
+    ratio("to_csdfixed", 1.2, seconds_per_call(n, fixed_reference),
+          seconds_per_call(n, fixed_fast));
+    std::vector<int> integers(n);
+    for (std::size_t i = 0U; i != n; ++i) {
+        integers[i] = int(values[i] * 1e6);
+    }
+    auto const csd_i_reference = [&](std::size_t i) {
+        sink += csd::to_csd_i_reference(integers[i]).size();
+    };
+    auto const csd_i_packed = [&](std::size_t i) {
+        sink += csd::to_csd_i_packed(integers[i]).length;
+    };
+    ratio("to_csd_i_packed", 20.0, seconds_per_call(n, csd_i_reference),
+          seconds_per_call(n, csd_i_packed));
+    std::vector<double> decimals(n);
+    ratio("to_decimal_batch", 1.5,
+          seconds_per_call(1U, [&](std::size_t) {
+              for (std::size_t i = 0U; i != n; ++i) {
+                  decimals[i] = csd::to_decimal(pointers[i]);
+              }
+          }),
+          seconds_per_call(1U, [&](std::size_t) {
+              csd::to_decimal_batch(pointers.data(), n, decimals.data());
+          }));
+    std::string long_csd;
+    for (std::size_t i = 0U; i != 64U; ++i) {
+        long_csd += csds[i];
+    }
+    ratio("longest_repeated_substring", 20.0,
+          seconds_per_call(1U, [&](std::size_t) {
+              sink += csd::longest_repeated_substring(long_csd.c_str(), long_csd.size(),
+                                                      csd::LcsreEngine::DynamicProgramming)
+                          .size();
+          }),
+          seconds_per_call(1U, [&](std::size_t) {
+              sink += csd::longest_repeated_substring(long_csd.c_str(), long_csd.size(),
+                                                      csd::LcsreEngine::SuffixArray)
+                          .size();
+          }));
+    CHECK_NE(sink, 0U);
+}
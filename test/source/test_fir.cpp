@@ -0,0 +1,134 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <algorithm>    // for max, min
+#include <cmath>        // for ldexp, llround
+#include <csd/csd.hpp>  // for to_csd, to_csdfixed, to_decimal
+#include <csd/fir.hpp>  // for CsdFir, FirFormat, FirOverflow
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int32_t, int64_t
+#include <random>       // for mt19937, uniform_int_distribution, uniform_real_distribution
+#include <stdexcept>    // for invalid_argument, length_error
+#include <string>       // for basic_string
+#include <vector>       // for vector
+
+using namespace csd;
+
+/**
+ * The filter with plain integer multiplications: each coefficient times
+ * 2^frac, from its decimal value, then the same rounding and overflow.
+ */
+static auto reference_filter(const std::vector<std::string> &csds, unsigned int frac,
+                             const FirFormat &format, const std::vector<std::int32_t> &in)
+    -> std::vector<std::int32_t> {
+    std::vector<std::int64_t> coefficients;
+    for (auto const &csd : csds) {
+        coefficients.push_back(std::llround(std::ldexp(to_decimal(csd.c_str()), int(frac))));
+    }
+    auto const shift = frac + format.output_shift;
+    auto const high = (std::int64_t{1} << (format.output_bits - 1U)) - 1;
+    auto const modulus = std::int64_t{1} << format.output_bits;
+    std::vector<std::int32_t> out(in.size());
+    for (std::size_t n = 0U; n != in.size(); ++n) {
+        std::int64_t sum = 0;
+        for (std::size_t k = 0U; k != coefficients.size() && k <= n; ++k) {
+            sum += coefficients[k] * in[n - k];
+        }
+        if (format.round && shift != 0U) {
+            sum += std::int64_t{1} << (shift - 1U);
+        }
+        auto value = sum >> shift;
+        if (format.overflow == FirOverflow::Saturate) {
+            value = std::min(std::max(value, -high - 1), high);
+        } else {
+            value = ((value + high + 1) % modulus + modulus) % modulus - high - 1;
+        }
+        out[n] = static_cast<std::int32_t>(value);
+    }
+    return out;
+}
+
+TEST_CASE("test CsdFir") {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> taps(-1.0, 1.0);
+    struct Case {
+        std::size_t num_taps;
+        int places;  ///< of `to_csd`, or 0 for `to_csdfixed` with 4 non-zero digits
+        FirFormat format;
+        unsigned int accumulator_bits;
+    };
+    FirFormat narrow;
+    narrow.output_bits = 12U;
+    narrow.overflow = FirOverflow::Wrap;
+    FirFormat rounded;
+    rounded.round = true;
+    rounded.output_shift = 2U;
+    FirFormat wide;
+    wide.input_bits = 24U;
+    wide.output_bits = 32U;
+    Case const cases[] = {{1U, 6, FirFormat(), 32U}, {15U, 6, FirFormat(), 32U},
+                          {31U, 6, narrow, 32U},     {31U, 6, rounded, 32U},
+                          {31U, 0, FirFormat(), 64U}, {64U, 20, wide, 64U}};
+    for (auto const &test : cases) {
+        std::vector<std::string> csds;
+        for (std::size_t k = 0U; k != test.num_taps; ++k) {
+            auto const tap = taps(gen);
+            csds.push_back(test.places == 0 ? to_csdfixed(tap, 4U) : to_csd(tap, test.places));
+        }
+        CsdFir fir(csds, test.format);
+        CHECK_EQ(fir.num_taps(), test.num_taps);
+        CHECK_EQ(fir.accumulator_bits(), test.accumulator_bits);
+
+        auto const limit = (std::int32_t{1} << (test.format.input_bits - 1U)) - 1;
+        std::uniform_int_distribution<std::int32_t> samples(-limit - 1, limit);
+        std::vector<std::int32_t> in(3000U);
+        for (auto &sample : in) {
+            sample = samples(gen);
+        }
+        in[100] = -limit - 1;
+        auto const expected = reference_filter(csds, fir.frac(), test.format, in);
+
+        // In one call, then in pieces that split the blocks anywhere
+        std::vector<std::int32_t> out(in.size());
+        fir.filter(in.data(), out.data(), in.size());
+        CHECK(out == expected);
+        fir.reset();
+        std::vector<std::int32_t> pieces(in);
+        for (std::size_t first = 0U, size = 1U; first < in.size(); size = size * 3U + 1U) {
+            auto const count = std::min(size, in.size() - first);
+            fir.filter(pieces.data() + first, pieces.data() + first, count);  // in place
+            first += count;
+        }
+        CHECK(pieces == expected);
+    }
+}
+
+TEST_CASE("test CsdFir overflow") {
+    FirFormat format;
+    format.output_bits = 8U;
+    std::vector<std::string> const csds = {"+0.0", "0.+"};  // 2 x[n] + x[n - 1] / 2
+    CsdFir saturate(csds, format);
+    CHECK_EQ(saturate.frac(), 1U);
+    std::int32_t const in[4] = {100, 100, -100, -30000};
+    std::int32_t out[4];
+    saturate.filter(in, out, 4U);
+    CHECK_EQ(out[0], 127);   // 200
+    CHECK_EQ(out[1], 127);   // 250
+    CHECK_EQ(out[2], -128);  // -150
+    CHECK_EQ(out[3], -128);
+
+    format.overflow = FirOverflow::Wrap;
+    CsdFir wrap(csds, format);
+    wrap.filter(in, out, 4U);
+    CHECK_EQ(out[0], -56);  // 200 - 256
+    CHECK_EQ(out[1], -6);   // 250 - 256
+    CHECK_EQ(out[2], 106);  // -150 + 256
+    CHECK_EQ(out[3], 110);  // -60050 + 235 * 256
+
+    CHECK_THROWS_AS(CsdFir(std::vector<std::string>{}), std::invalid_argument);
+    format.input_bits = 0U;
+    CHECK_THROWS_AS(CsdFir(std::vector<std::string>{"+"}, format), std::invalid_argument);
+    format.input_bits = 32U;
+    CHECK_THROWS_AS(CsdFir(std::vector<std::string>{"+000000000000000000000000000000000"}, format),
+                    std::length_error);
+    CHECK_THROWS_AS(CsdFir(std::vector<std::string>{"+X"}), std::invalid_argument);
+}
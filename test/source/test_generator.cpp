@@ -0,0 +1,101 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <cmath>              // for ldexp
+#include <csd/csd.hpp>        // for to_csd
+#include <csd/generator.hpp>  // for CsdGenerator, CsdDigit
+#include <random>             // for mt19937, uniform_real_distribution
+#include <string>             // for basic_string
+#include <vector>             // for vector
+
+using namespace csd;
+
+namespace {
+    /**
+     * @brief The `to_csd` string from the non-zero digits found down to `-places`
+     */
+    auto render(double value, int places, const std::vector<CsdDigit> &digits) -> std::string {
+        auto const top = CsdGenerator(value).position();
+        std::string csd(size_t(top + 1 + places), '0');
+        for (auto const &digit : digits) {
+            csd[size_t(top - digit.position)] = digit.sign > 0 ? '+' : '-';
+        }
+        csd.insert(size_t(top + 1), 1U, '.');
+        return top < 0 ? "0" + csd : csd;
+    }
+}  // namespace
+
+TEST_CASE("test CsdGenerator") {
+    CsdGenerator gen(28.5);
+    CHECK_EQ(gen.position(), 5);
+    std::string csd;
+    while (gen.position() >= -2) {
+        csd += "-0+"[gen.step() + 1];
+    }
+    CHECK_EQ(csd, "+00-00+0");
+    CHECK_EQ(gen.nonzeros(), 3U);
+    CHECK_EQ(gen.approximation(), 28.5);
+    CHECK_EQ(gen.residual(), 0.0);
+
+    CsdGenerator lazy(28.5);
+    CsdDigit digit{0, 0};
+    REQUIRE(lazy.next_nonzero(-10, digit));
+    CHECK_EQ(digit.position, 5);
+    CHECK_EQ(digit.sign, 1);
+    REQUIRE(lazy.next_nonzero(-10, digit));
+    CHECK_EQ(digit.position, 2);
+    CHECK_EQ(digit.sign, -1);
+    CHECK_EQ(lazy.approximation(), 28.0);
+    REQUIRE(lazy.next_nonzero(-10, digit));
+    CHECK_EQ(digit.position, -1);
+    CHECK_FALSE(lazy.next_nonzero(-10, digit));
+    CHECK_EQ(lazy.position(), -11);
+    CHECK_FALSE(lazy.next_nonzero(-5, digit));
+    CHECK_EQ(lazy.position(), -11);
+
+    // Nothing to look at above position()
+    CsdGenerator fresh(28.5);
+    REQUIRE_EQ(fresh.position(), 5);
+    CHECK_FALSE(fresh.next_nonzero(6, digit));
+    CHECK_EQ(fresh.position(), 5);
+    CHECK_EQ(fresh.nonzeros(), 0U);
+    REQUIRE(fresh.next_nonzero(5, digit));
+    CHECK_EQ(digit.position, 5);
+    CHECK_FALSE(fresh.next_nonzero(3, digit));
+    CHECK_EQ(fresh.position(), 2);
+}
+
+TEST_CASE("test CsdGenerator against to_csd") {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    for (auto i = 0; i != 3000; ++i) {
+        auto const value = std::ldexp(dist(gen), int(gen() % 40U) - 20);
+        auto const places = int(gen() % 60U);
+
+        // Digit by digit
+        CsdGenerator stepper(value);
+        std::vector<CsdDigit> digits;
+        while (stepper.position() >= -places) {
+            auto const position = stepper.position();
+            auto const sign = stepper.step();
+            if (sign != 0) {
+                digits.push_back(CsdDigit{position, sign});
+            }
+        }
+        auto const expected = to_csd(value, places);
+        REQUIRE_EQ(render(value, places, digits), expected);
+
+        // Skipping the zeros, refining the precision in two goes
+        CsdGenerator lazy(value);
+        std::vector<CsdDigit> skipped;
+        CsdDigit digit{0, 0};
+        for (auto lowest : {-places / 2, -places}) {
+            while (lazy.next_nonzero(lowest, digit)) {
+                skipped.push_back(digit);
+            }
+            CHECK_EQ(lazy.position(), lowest - 1);
+        }
+        CHECK_EQ(render(value, places, skipped), expected);
+        CHECK_EQ(lazy.residual(), stepper.residual());
+        CHECK_EQ(lazy.nonzeros(), stepper.nonzeros());
+    }
+}
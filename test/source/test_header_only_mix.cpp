@@ -0,0 +1,19 @@
+// A CSD_HEADER_ONLY translation unit in the same program as the compiled library
+#define CSD_HEADER_ONLY
+
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>     // for to_csd, to_csdfixed, to_csd_into
+#include <csd/packed.hpp>  // for to_csd_packed, to_string
+#include <string>          // for basic_string
+
+TEST_CASE("test header-only encoders next to the library") {
+    // The inline encoders live in their own namespace, apart from the library's
+    CHECK_EQ(csd::header_only::to_csd(28.5, 2), "+00-00.+0");
+    CHECK_EQ(csd::to_csd(28.5, 2), "+00-00.+0");
+    CHECK_EQ(csd::to_csdfixed(28.5, 2U), "+00-00");
+    CHECK_EQ(csd::to_string(csd::header_only::to_csd_packed(28.5, 2)), "+00-00.+0");
+    std::string out;
+    CHECK_EQ(csd::to_csd_into(0.5, 2, out), 4U);
+    CHECK_EQ(out, "0.+0");
+}
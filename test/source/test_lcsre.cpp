@@ -1,6 +1,13 @@
 #include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
 
-#include <csd/lcsre.hpp>  // for longest_repeated_substring
+#include <algorithm>      // for count, max
+#include <cstddef>        // for size_t
+#include <csd/lcsre.hpp>  // for longest_repeated_substring, shared_patterns
+#include <map>            // for map
+#include <random>         // for mt19937
+#include <set>            // for set
+#include <string>         // for basic_string
+#include <vector>         // for vector
 
 using namespace csd;
 
@@ -9,3 +16,175 @@ TEST_CASE("test lcsre") {  // Driver Code
     CHECK_EQ(longest_repeated_substring("abcdefghijklmno", 15U), "");
     CHECK_EQ(longest_repeated_substring("banana", 6U), "an");
 }
+
+TEST_CASE("test lcsre (rolling row)") {
+    auto const engine = LcsreEngine::RollingRow;
+    CHECK_EQ(longest_repeated_substring("+-00+-00+-00+-0", 15U, engine), "+-00+-0");
+    CHECK_EQ(longest_repeated_substring("abcdefghijklmno", 15U, engine), "");
+    CHECK_EQ(longest_repeated_substring("banana", 6U, engine), "an");
+    CHECK_EQ(longest_repeated_substring("", 0U, engine), "");
+
+    std::mt19937 gen(3);
+    for (auto trial = 0; trial != 200; ++trial) {
+        std::string csd;
+        for (auto i = gen() % 80U; i != 0U; --i) {
+            csd += "0+-"[gen() % 3U];
+        }
+        CHECK_EQ(longest_repeated_substring(csd.c_str(), csd.size(), engine),
+                 longest_repeated_substring(csd.c_str(), csd.size(),
+                                            LcsreEngine::DynamicProgramming));
+    }
+}
+
+TEST_CASE("test lcsre (suffix array)") {
+    auto const engine = LcsreEngine::SuffixArray;
+    CHECK_EQ(longest_repeated_substring("+-00+-00+-00+-0", 15U, engine), "+-00+-0");
+    CHECK_EQ(longest_repeated_substring("abcdefghijklmno", 15U, engine), "");
+    CHECK_EQ(longest_repeated_substring("banana", 6U, engine), "an");
+    CHECK_EQ(longest_repeated_substring("", 0U, engine), "");
+
+    std::mt19937 gen(5);
+    for (auto trial = 0; trial != 200; ++trial) {
+        std::string csd;
+        for (auto i = gen() % 80U; i != 0U; --i) {
+            csd += "0+-"[gen() % 3U];
+        }
+        CHECK_EQ(longest_repeated_substring(csd.c_str(), csd.size(), engine),
+                 longest_repeated_substring(csd.c_str(), csd.size(),
+                                            LcsreEngine::DynamicProgramming));
+    }
+
+    auto const big = std::string(100000U, '0');
+    CHECK_EQ(longest_repeated_substring(big.c_str(), big.size()).size(), 50000U);
+}
+
+namespace {
+    auto negate(std::string csd) -> std::string {
+        for (auto &c : csd) {
+            c = c == '+' ? '-' : c == '-' ? '+' : c;
+        }
+        return csd;
+    }
+
+    /**
+     * Occurrences of every pattern (and its negation) of at least `min_length`
+     * digits that begins and ends with a non-zero and has `min_nonzeros` of
+     * them, or has only zeros if `min_nonzeros` is 0
+     */
+    auto all_patterns(const std::vector<std::string> &csds, size_t min_length,
+                      size_t min_nonzeros) -> std::map<std::string, size_t> {
+        std::map<std::string, size_t> counts;
+        for (auto const &csd : csds) {
+            for (size_t i = 0U; i != csd.size(); ++i) {
+                for (auto len = min_length; i + len <= csd.size(); ++len) {
+                    auto const pattern = csd.substr(i, len);
+                    if (pattern.find('.') != std::string::npos) {
+                        break;
+                    }
+                    auto const nonzeros
+                        = size_t(std::count(pattern.begin(), pattern.end(), '+'))
+                          + size_t(std::count(pattern.begin(), pattern.end(), '-'));
+                    auto const trimmed = pattern.front() != '0' && pattern.back() != '0';
+                    if (nonzeros == 0U ? min_nonzeros != 0U
+                                       : !trimmed || nonzeros < min_nonzeros) {
+                        continue;
+                    }
+                    auto const flipped = negate(pattern);
+                    ++counts[pattern < flipped ? pattern : flipped];
+                }
+            }
+        }
+        return counts;
+    }
+}  // namespace
+
+TEST_CASE("test shared_patterns") {
+    SharedPatternOptions options;
+    options.top_k = 0U;
+    auto const patterns = shared_patterns({"+0-00+0-", "-0+0.+0-", "000"}, options);
+    REQUIRE_EQ(patterns.size(), 1U);
+    CHECK_EQ(patterns[0].pattern, "+0-");
+    auto const &occurrences = patterns[0].occurrences;
+    REQUIRE_EQ(occurrences.size(), 4U);
+    CHECK_EQ(occurrences[2].string, 1U);
+    CHECK_EQ(occurrences[2].position, 0U);
+    CHECK(occurrences[2].negated);
+
+    // Zeros at either end are trimmed, so shifted copies are one pattern
+    auto const shifted = shared_patterns({"0+0-", "+0-0", "00+0-00"}, options);
+    REQUIRE_EQ(shifted.size(), 1U);
+    CHECK_EQ(shifted[0].pattern, "+0-");
+    REQUIRE_EQ(shifted[0].occurrences.size(), 3U);
+    CHECK_EQ(shifted[0].occurrences[0].position, 1U);
+    CHECK_EQ(shifted[0].occurrences[2].position, 2U);
+
+    // Runs of zeros take `min_nonzeros` of 0
+    options.min_nonzeros = 0U;
+    auto const zeros = shared_patterns({"+0-00+0-", "-0+0.+0-", "000"}, options);
+    REQUIRE_EQ(zeros.size(), 2U);
+    CHECK_EQ(zeros[1].pattern, "00");
+    CHECK_EQ(zeros[1].occurrences.size(), 3U);
+    options.min_nonzeros = 3U;
+    CHECK(shared_patterns({"+0-00+0-", "-0+0.+0-", "000"}, options).empty());
+    options.min_nonzeros = 2U;
+
+    // Without sign flips "-0+" is a pattern of its own, and the strings never match across
+    options.sign_flips = false;
+    options.order = PatternOrder::Length;
+    auto const plain = shared_patterns({"+0-", "+0-", "-0+"}, options);
+    REQUIRE(!plain.empty());
+    CHECK_EQ(plain[0].pattern, "+0-");
+    CHECK_EQ(plain[0].occurrences.size(), 2U);
+    CHECK(shared_patterns({"+0", "-0+", ""}, options).empty());
+    CHECK(shared_patterns({}, options).empty());
+}
+
+TEST_CASE("test shared_patterns against brute force") {
+    std::mt19937 gen(9);
+    for (auto trial = 0; trial != 100; ++trial) {
+        std::vector<std::string> csds(1U + gen() % 6U);
+        for (auto &csd : csds) {
+            for (auto i = gen() % 30U; i != 0U; --i) {
+                csd += gen() % 10U == 0U ? '.' : "00+-"[gen() % 4U];
+            }
+        }
+        SharedPatternOptions options;
+        options.min_length = 1U + gen() % 3U;
+        options.min_nonzeros = gen() % 4U;
+        options.top_k = 0U;
+        auto const counts = all_patterns(csds, options.min_length, options.min_nonzeros);
+        auto const patterns = shared_patterns(csds, options);
+
+        auto most = size_t{0U};
+        auto longest = size_t{0U};
+        for (auto const &entry : counts) {
+            if (entry.second >= 2U) {
+                most = std::max(most, entry.second);
+                longest = std::max(longest, entry.first.size());
+            }
+        }
+        if (most == 0U) {
+            CHECK(patterns.empty());
+            continue;
+        }
+        REQUIRE(!patterns.empty());
+        CHECK_EQ(patterns[0].occurrences.size(), most);
+
+        auto max_length = size_t{0U};
+        std::set<std::string> seen;
+        for (auto const &pattern : patterns) {
+            CHECK(seen.insert(pattern.pattern).second);
+            auto const it = counts.find(pattern.pattern);
+            REQUIRE(it != counts.end());
+            CHECK_EQ(pattern.occurrences.size(), it->second);
+            for (auto const &occurrence : pattern.occurrences) {
+                auto const expected
+                    = occurrence.negated ? negate(pattern.pattern) : pattern.pattern;
+                CHECK_EQ(csds[occurrence.string].substr(occurrence.position, expected.size()),
+                         expected);
+            }
+            max_length = std::max(max_length, pattern.pattern.size());
+        }
+        CHECK_EQ(max_length, longest);
+    }
+}
@@ -0,0 +1,108 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <chrono>       // for steady_clock, duration
+#include <csd/csd.hpp>  // for to_csdfixed, to_decimal
+#include <csd/mcm.hpp>  // for mcm_adder_graph, AdderGraph, adder_count
+#include <cstddef>      // for size_t
+#include <cstdint>      // for int64_t
+#include <random>       // for mt19937
+#include <string>       // for basic_string
+#include <vector>       // for vector
+
+using namespace csd;
+
+namespace {
+    /** Checks that every adder computes its value from lower numbered nodes */
+    auto check_graph(const AdderGraph &graph) -> void {
+        for (std::size_t k = 0U; k != graph.adders.size(); ++k) {
+            auto const &adder = graph.adders[k];
+            REQUIRE(adder.lhs <= k);
+            REQUIRE(adder.rhs <= k);
+            CHECK_EQ(adder.value, adder.lhs_sign * (node_value(graph, adder.lhs) << adder.lhs_shift)
+                                      + adder.rhs_sign
+                                            * (node_value(graph, adder.rhs) << adder.rhs_shift));
+        }
+    }
+
+    /** The number of adders without any sharing */
+    auto naive_adders(const std::vector<std::string> &csds) -> std::size_t {
+        auto count = std::size_t{0U};
+        for (auto const &csd : csds) {
+            auto nnz = std::size_t{0U};
+            for (auto digit : csd) {
+                nnz += digit == '+' || digit == '-' ? 1U : 0U;
+            }
+            count += nnz > 0U ? nnz - 1U : 0U;
+        }
+        return count;
+    }
+}  // namespace
+
+TEST_CASE("test mcm_adder_graph") {
+    auto const csds = std::vector<std::string>{"+0-0+0-", "+0-0+", "-0+0-0+.0", "+00-00.+", "0", "+0-0+0-0+"};
+    auto const graph = mcm_adder_graph(csds);
+    check_graph(graph);
+    REQUIRE_EQ(graph.outputs.size(), csds.size());
+    for (std::size_t i = 0U; i != csds.size(); ++i) {
+        CHECK_EQ(output_value(graph, i), to_decimal(csds[i].c_str()));
+    }
+    CHECK_EQ(graph.outputs[4].sign, 0);
+    CHECK(adder_count(graph) < naive_adders(csds));
+
+    // Equal up to sign and power of two: a single fundamental
+    auto const shared = mcm_adder_graph(std::vector<std::string>{"+0-", "-0+0", "0.+0-"});
+    CHECK_EQ(adder_count(shared), 1U);
+    CHECK_EQ(output_value(shared, 1), -6.0);
+    CHECK_EQ(output_value(shared, 2), 0.375);
+    CHECK_THROWS(mcm_adder_graph(std::vector<std::string>{"+0X"}));
+}
+
+TEST_CASE("test mcm_adder_graph skips patterns without two separate occurrences") {
+    // "+0-0+0-" and its negation overlap in the first coefficient only, and
+    // rank before "+0-0+", which all three coefficients share
+    auto const csds = std::vector<std::string>{"+0-0+0-0+", "+0-0+000+", "+000+0-0+"};
+    auto const graph = mcm_adder_graph(csds);
+    check_graph(graph);
+    for (std::size_t i = 0U; i != csds.size(); ++i) {
+        CHECK_EQ(output_value(graph, i), to_decimal(csds[i].c_str()));
+    }
+    CHECK_EQ(adder_count(graph), 5U);
+}
+
+TEST_CASE("test mcm_adder_graph (filter bank)") {
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> coefficients(256);
+    for (auto &coefficient : coefficients) {
+        coefficient = dist(gen);
+    }
+    auto const graph = mcm_adder_graph(coefficients, 6U);
+    check_graph(graph);
+    std::vector<std::string> csds;
+    for (std::size_t i = 0U; i != coefficients.size(); ++i) {
+        csds.push_back(to_csdfixed(coefficients[i], 6U));
+        CHECK_EQ(output_value(graph, i), to_decimal(csds.back().c_str()));
+    }
+    MESSAGE("adders: " << adder_count(graph) << " (naive " << naive_adders(csds) << ")");
+    CHECK(adder_count(graph) < naive_adders(csds));
+}
+
+TEST_CASE("test mcm_adder_graph (thousands of coefficients)") {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    std::vector<double> coefficients(4000);
+    for (auto &coefficient : coefficients) {
+        coefficient = dist(gen);
+    }
+    // Well under a second when optimized; the bound leaves room for debug and sanitizer builds
+    auto const start = std::chrono::steady_clock::now();
+    auto const graph = mcm_adder_graph(coefficients, 6U);
+    std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+    MESSAGE("4000 coefficients: " << adder_count(graph) << " adders in " << elapsed.count()
+                                  << " s");
+    CHECK_LT(elapsed.count(), 10.0);
+    check_graph(graph);
+    for (std::size_t i = 0U; i != coefficients.size(); ++i) {
+        CHECK_EQ(output_value(graph, i), to_decimal(to_csdfixed(coefficients[i], 6U).c_str()));
+    }
+}
@@ -0,0 +1,87 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/batch.hpp>    // for to_decimal_batch
+#include <csd/csd.hpp>      // for to_csd, to_csdfixed
+#include <csd/lcsre.hpp>    // for longest_repeated_substring
+#include <csd/metrics.hpp>  // for metrics_snapshot, reset_metrics, MetricFunction
+#include <cstddef>          // for size_t
+#include <string>           // for basic_string
+#include <thread>           // for thread
+
+using namespace csd;
+
+TEST_CASE("test metrics") {
+    reset_metrics();
+    for (auto i = 0; i != 3; ++i) {
+        CHECK_EQ(to_csd(28.5, 2), "+00-00.+0");
+    }
+    CHECK_EQ(to_csdfixed(28.5, 2U), "+00-00");
+    std::string const csds[2] = {"+00-00.+0", "0.-"};
+    double decimals[2];
+    to_decimal_batch(csds, 2U, decimals);
+    auto const long_csd = std::string(2000U, '+');
+    CHECK_EQ(longest_repeated_substring(long_csd.c_str(), 10U).size(), 5U);
+    CHECK_EQ(longest_repeated_substring(long_csd.c_str(), long_csd.size()).size(), 1000U);
+    // Calls from a thread that has finished are kept
+    std::thread worker([] { to_csd(0.5, 4); });
+    worker.join();
+
+    auto const snapshot = metrics_snapshot();
+    auto const &csd = snapshot[MetricFunction::ToCsd];
+    auto const &lcsre = snapshot[MetricFunction::Lcsre];
+    if (!metrics_available()) {
+        CHECK_EQ(csd.calls, 0U);
+        CHECK_EQ(lcsre.calls, 0U);
+        return;
+    }
+    CHECK_EQ(csd.calls, 4U);
+    CHECK_EQ(csd.sizes[4], 3U);  // 9 characters
+    CHECK_EQ(csd.sizes[3], 1U);  // "0.+000"
+    CHECK_LE(csd.max_nanoseconds, csd.nanoseconds);
+    CHECK_EQ(snapshot[MetricFunction::ToCsdFixed].calls, 1U);
+    CHECK_EQ(snapshot[MetricFunction::ToDecimalBatch].calls, 1U);
+    CHECK_EQ(snapshot[MetricFunction::ToDecimalBatch].sizes[2], 1U);
+    CHECK_EQ(lcsre.calls, 2U);
+    CHECK_EQ(lcsre.table_bytes, 2U * 11U * sizeof(unsigned int) + 10001U * sizeof(std::size_t));
+
+    auto const text = format_metrics(snapshot);
+    CHECK_NE(text.find("to_csd calls=4 "), std::string::npos);
+    CHECK_NE(text.find("longest_repeated_substring calls=2 "), std::string::npos);
+
+    reset_metrics();
+    CHECK_EQ(metrics_snapshot()[MetricFunction::ToCsd].calls, 0U);
+}
+
+TEST_CASE("test reset_metrics while other threads count") {
+    std::thread workers[2];
+    for (auto &worker : workers) {
+        worker = std::thread([] {
+            for (auto i = 0; i != 2000; ++i) {
+                to_csd(28.5, 2);
+            }
+        });
+    }
+    for (auto i = 0; i != 200; ++i) {
+        reset_metrics();
+    }
+    for (auto &worker : workers) {
+        worker.join();
+    }
+    reset_metrics();
+    CHECK_EQ(metrics_snapshot()[MetricFunction::ToCsd].calls, 0U);
+    to_csd(28.5, 2);
+    CHECK_EQ(metrics_snapshot()[MetricFunction::ToCsd].calls, metrics_available() ? 1U : 0U);
+}
+
+TEST_CASE("test latency_percentile") {
+    FunctionMetrics metrics{};
+    CHECK_EQ(latency_percentile(metrics, 0.99), 0U);
+    metrics.calls = 100U;
+    metrics.latencies[7] = 98U;  // 64 to 127 ns
+    metrics.latencies[12] = 2U;  // 2048 to 4095 ns
+    metrics.max_nanoseconds = 3000U;
+    CHECK_EQ(latency_percentile(metrics, 0.5), 127U);
+    CHECK_EQ(latency_percentile(metrics, 0.98), 127U);
+    CHECK_EQ(latency_percentile(metrics, 0.99), 4095U);
+    CHECK_EQ(std::string(metric_name(MetricFunction::ToDecimalBatch)), "to_decimal_batch");
+}
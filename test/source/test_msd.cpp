@@ -0,0 +1,97 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>     // for to_csd, to_decimal
+#include <csd/msd.hpp>     // for MsdEnumerator, msd_count, msd_weight, to_msd_all
+#include <csd/packed.hpp>  // for PackedCsd, to_csd_i_packed, to_string
+#include <cstdint>         // for int64_t, uint64_t
+#include <map>             // for map
+#include <set>             // for set
+#include <stdexcept>       // for length_error
+#include <string>          // for basic_string
+#include <utility>         // for pair
+#include <vector>          // for vector
+
+using namespace csd;
+
+TEST_CASE("test to_msd_all") {
+    auto const three = to_msd_all(std::int64_t{3});
+    REQUIRE_EQ(three.size(), 2U);
+    CHECK_EQ(to_string(three[0]), "+0-");
+    CHECK_EQ(to_string(three[1]), "++");
+    CHECK_EQ(to_string(to_msd_all(std::int64_t{0})[0]), "0");
+    CHECK_EQ(msd_count(std::int64_t{0}), 1U);
+
+    // The CSD is always first
+    auto const forms = to_msd_all(std::int64_t{-45});
+    CHECK_EQ(forms[0], to_csd_i_packed(-45));
+    CHECK_EQ(forms.size(), msd_count(-45));
+    for (auto const &form : forms) {
+        CHECK_EQ(to_decimal_i(form), -45);
+        CHECK_EQ(num_nonzeros(form), msd_weight(-45));
+    }
+
+    // Fixed point, in the format of to_csd
+    auto const fixed = to_msd_all(0.75, 4);
+    REQUIRE_EQ(fixed.size(), 2U);
+    CHECK_EQ(to_string(fixed[0]), "+.0-00");
+    CHECK_EQ(to_string(fixed[1]), to_csd(0.75, 4));
+    CHECK_EQ(to_decimal(to_string(fixed[0]).c_str()), 0.75);
+    for (auto const &form : to_msd_all(-3.3, 8)) {
+        CHECK_EQ(to_decimal(to_string(form).c_str()), to_decimal(to_csd(-3.3, 8).c_str()));
+        CHECK_EQ(form.frac, 8U);
+    }
+
+    CHECK_THROWS_AS(MsdEnumerator(msd_max_magnitude + 1), std::length_error);
+    CHECK_EQ(msd_count(msd_max_magnitude), 1U);
+}
+
+TEST_CASE("test MsdEnumerator against brute force") {
+    // The minimal-weight forms among all the 3^12 signed-digit vectors
+    using Masks = std::set<std::pair<std::uint64_t, std::uint64_t>>;
+    std::map<std::int64_t, std::pair<unsigned int, Masks>> best;
+    constexpr auto digits = 12U;
+    std::vector<int> vec(digits, -1);
+    for (;;) {
+        auto value = std::int64_t{0};
+        auto pos = std::uint64_t{0U};
+        auto neg = std::uint64_t{0U};
+        auto weight = 0U;
+        for (auto i = 0U; i != digits; ++i) {
+            value += vec[i] * (std::int64_t{1} << i);
+            pos |= std::uint64_t(vec[i] > 0) << i;
+            neg |= std::uint64_t(vec[i] < 0) << i;
+            weight += vec[i] != 0 ? 1U : 0U;
+        }
+        auto const it = best.find(value);
+        if (it == best.end() || weight < it->second.first) {
+            best[value] = {weight, {{pos, neg}}};
+        } else if (weight == it->second.first) {
+            it->second.second.insert({pos, neg});
+        }
+        auto i = 0U;
+        for (; i != digits && vec[i] == 1; ++i) {
+            vec[i] = -1;
+        }
+        if (i == digits) {
+            break;
+        }
+        ++vec[i];
+    }
+
+    for (auto value = std::int64_t{-1000}; value <= 1000; ++value) {
+        auto const &expected = best[value];
+        MsdEnumerator msds(value);
+        CHECK_EQ(msds.weight(), expected.first);
+        Masks found;
+        auto count = std::uint64_t{0U};
+        PackedCsd msd;
+        while (msds.next(msd)) {
+            CHECK_EQ(msd.length, value == 0 ? 1U : bit_length(msd.pos | msd.neg));
+            found.insert({msd.pos, msd.neg});
+            ++count;
+        }
+        CHECK_EQ(count, found.size());
+        CHECK(found == expected.second);
+        CHECK_EQ(msd_count(value), count);
+    }
+}
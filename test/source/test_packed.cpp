@@ -0,0 +1,62 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>     // for to_csd, to_csd_i, to_csdfixed
+#include <csd/packed.hpp>  // for PackedCsd, to_packed, to_string
+#include <cstdint>         // for int64_t, uint64_t, INT64_MIN
+#include <string>          // for basic_string
+
+using namespace csd;
+
+TEST_CASE("test to_packed") {
+    auto const csd = to_packed("+00-00.+0");
+    CHECK_EQ(csd.pos, 0x82U);
+    CHECK_EQ(csd.neg, 0x10U);
+    CHECK_EQ(csd.length, 8U);
+    CHECK_EQ(csd.frac, 2U);
+    CHECK(csd.has_point);
+    CHECK_EQ(to_packed("+00-00"), PackedCsd(0x20U, 0x04U, 6U));
+    CHECK_THROWS(to_packed("+00XX-00.+"));
+    CHECK_THROWS(to_packed("+00-00.+XXX"));
+    CHECK_THROWS(to_packed("+0.+0.0"));
+    CHECK_THROWS(to_packed(std::string(65, '0').c_str()));
+}
+
+TEST_CASE("test to_string (packed)") {
+    for (auto const *str : {"+00-00.+0", "0.-0", "0.00", "0.", "+00-00", "0", ".+", ""}) {
+        CHECK_EQ(to_string(to_packed(str)), str);
+    }
+}
+
+TEST_CASE("test packed encoders") {
+    CHECK_EQ(to_csd_packed(28.5, 2), to_packed("+00-00.+0"));
+    CHECK_EQ(to_csd_i_packed(28), to_packed("+00-00"));
+    CHECK_EQ(to_csdfixed_packed(28.5, 4), to_packed("+00-00.+"));
+    for (auto value : {0.0, -0.5, 0.1, 3.75, -1234.5678, 1e6}) {
+        CHECK_EQ(to_string(to_csd_packed(value, 8)), to_csd(value, 8));
+        CHECK_EQ(to_string(to_csdfixed_packed(value, 5)), to_csdfixed(value, 5));
+    }
+    for (auto value : {0, 1, -1, 7, -28, 1000, -123456}) {
+        CHECK_EQ(to_string(to_csd_i_packed(value)), to_csd_i(value));
+    }
+    CHECK_THROWS(to_csd_packed(28.5, 60));
+}
+
+TEST_CASE("test to_csd_i_packed (64-bit)") {
+    static_assert(to_csd_i_packed(28) == PackedCsd(0x20U, 0x04U, 6U), "constexpr encoder");
+    CHECK_EQ(to_csd_i_packed(std::int64_t{0}), to_packed("0"));
+    CHECK_EQ(to_csd_i_packed(std::int64_t{-28}), to_packed("-00+00"));
+    CHECK_EQ(to_csd_i_packed(std::int64_t{1} << 40), to_csd_i_packed(std::uint64_t{1} << 40));
+    CHECK_EQ(to_string(to_csd_i_packed(std::int64_t{INT64_MIN})), "-" + std::string(63, '0'));
+    CHECK_EQ(to_csd_i_packed(std::uint64_t{0xAAAAAAAAAAAAAAAAU}).length, 64U);
+    CHECK_THROWS(to_csd_i_packed(~std::uint64_t{0U}));
+}
+
+TEST_CASE("test packed decoders") {
+    CHECK_EQ(to_decimal(to_packed("+00-00.+")), 28.5);
+    CHECK_EQ(to_decimal(to_packed("0.-")), -0.5);
+    CHECK_EQ(to_decimal(to_packed("0")), 0.0);
+    CHECK_EQ(to_decimal(to_packed("-0.+-")), -1.75);
+    CHECK_EQ(to_decimal_i(to_packed("+00-00.00+")), 28);
+    CHECK_EQ(to_decimal_i(to_packed("-0-")), -5);
+    CHECK_EQ(num_nonzeros(to_packed("+00-00.+0")), 3U);
+}
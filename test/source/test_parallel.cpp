@@ -0,0 +1,170 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>           // for to_csd, to_csdfixed, to_decimal
+#include <csd/parallel.hpp>      // for to_csd_parallel, to_decimal_parallel
+#include <csd/string_table.hpp>  // for CsdStringTable
+#include <cstddef>               // for size_t
+#include <memory>                // for allocator
+#include <random>                // for mt19937
+#include <stdexcept>             // for invalid_argument
+#include <string>                // for basic_string
+#include <thread>                // for thread
+#include <vector>                // for vector
+
+using namespace csd;
+
+TEST_CASE("test CsdStringTable") {
+    CsdStringTable table;
+    CHECK(table.empty());
+    table.push_back("+00-00.+", 8U);
+    table.push_back("0", 1U);
+    CHECK_EQ(table.size(), 2U);
+    CHECK_EQ(std::string(table[0]), "+00-00.+");
+    CHECK_EQ(table.length(1), 1U);
+    CHECK_EQ(table.str(1), "0");
+
+    table.push_back_csd(28.5, 2);
+    table.push_back_csdfixed(0.1, 40U);
+    table.push_back_csdfixed(28.5, 2U);
+    CHECK_EQ(table.size(), 5U);
+    CHECK_EQ(table.str(2), to_csd(28.5, 2));
+    CHECK_EQ(table.str(3), to_csdfixed(0.1, 40U));
+    CHECK_EQ(table.str(4), to_csdfixed(28.5, 2U));
+    CHECK_EQ(table.data().size(), table.offsets().back());
+    table.clear();
+    CHECK(table.empty());
+    CHECK(table.data().empty());
+}
+
+namespace {
+    /** Counts the bytes allocated through all its copies */
+    template <typename T> struct CountingAllocator {
+        using value_type = T;
+        std::size_t *bytes;
+
+        explicit CountingAllocator(std::size_t *bytes) : bytes(bytes) {}
+        template <typename U>
+        CountingAllocator(const CountingAllocator<U> &other) : bytes(other.bytes) {}
+
+        auto allocate(std::size_t n) -> T * {
+            *bytes += n * sizeof(T);
+            return std::allocator<T>().allocate(n);
+        }
+        auto deallocate(T *p, std::size_t n) -> void { std::allocator<T>().deallocate(p, n); }
+
+        template <typename U> auto operator==(const CountingAllocator<U> &other) const -> bool {
+            return bytes == other.bytes;
+        }
+        template <typename U> auto operator!=(const CountingAllocator<U> &other) const -> bool {
+            return bytes != other.bytes;
+        }
+    };
+}  // namespace
+
+TEST_CASE("test CsdStringTable with an allocator") {
+    auto bytes = std::size_t{0U};
+    CountingAllocator<char> const alloc(&bytes);
+    BasicCsdStringTable<CountingAllocator<char>> table(alloc);
+    table.reserve(1000U, 1000U * 16U);
+    auto const reserved = bytes;
+    CHECK_GE(reserved, 1000U * 16U + 1001U * sizeof(std::size_t));
+    for (auto i = 0; i != 1000; ++i) {
+        table.push_back_csd(i * 0.25, 2);
+    }
+    CHECK_EQ(bytes, reserved);  // no allocation per string
+    CHECK_EQ(table.str(999), to_csd(999 * 0.25, 2));
+
+    auto const csd = to_csd(28.5, 2, alloc);
+    CHECK_EQ(std::string(csd.c_str()), "+00-00.+0");
+    CHECK_EQ(csd.size(), 9U);
+    auto const fixed = to_csdfixed(1.0 / 3.0, 30U, alloc);
+    CHECK_EQ(std::string(fixed.c_str()), to_csdfixed(1.0 / 3.0, 30U));
+    CHECK_EQ(fixed.size(), to_csdfixed(1.0 / 3.0, 30U).size());
+}
+
+#ifdef CSD_HAS_PMR
+TEST_CASE("test pmr::CsdStringTable") {
+    char arena[4096];
+    std::pmr::monotonic_buffer_resource resource(arena, sizeof arena,
+                                                 std::pmr::null_memory_resource());
+    pmr::CsdStringTable table(&resource);
+    table.reserve(64U, 1024U);
+    for (auto i = 0; i != 64; ++i) {
+        table.push_back_csd(i - 32.0, 0);
+    }
+    CHECK_EQ(table.view(0), to_csd(-32.0, 0));
+    CHECK_EQ(table.view(63), to_csd(31.0, 0));
+    auto const csd = to_csd(28.5, 2, std::pmr::polymorphic_allocator<char>(&resource));
+    CHECK_EQ(csd, "+00-00.+0");
+}
+#endif
+
+TEST_CASE("test parallel conversions") {
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<double> dist(-1000.0, 1000.0);
+    auto values = std::vector<double>(20000U);
+    for (auto &value : values) {
+        value = dist(gen);
+    }
+    values[0] = 0.0;
+
+    // 64 ranges are more than the pool has threads
+    for (auto threads : {1U, 3U, 0U, 64U}) {
+        auto const csd = to_csd_parallel(values.data(), values.size(), 6, threads);
+        auto const fixed = to_csdfixed_parallel(values.data(), values.size(), 4U, threads);
+        REQUIRE_EQ(csd.size(), values.size());
+        REQUIRE_EQ(fixed.size(), values.size());
+        auto decimals = std::vector<double>(values.size());
+        to_decimal_parallel(csd, decimals.data(), threads);
+        auto pointers = std::vector<const char *>(values.size());
+        auto fixed_decimals = std::vector<double>(values.size());
+        for (std::size_t i = 0U; i != values.size(); ++i) {
+            pointers[i] = fixed[i];
+        }
+        to_decimal_parallel(pointers.data(), pointers.size(), fixed_decimals.data(), threads);
+
+        auto mismatches = 0U;
+        for (std::size_t i = 0U; i != values.size(); ++i) {
+            auto const expected = to_csd(values[i], 6);
+            auto const expected_fixed = to_csdfixed(values[i], 4U);
+            mismatches += csd.str(i) == expected ? 0U : 1U;
+            mismatches += fixed.str(i) == expected_fixed ? 0U : 1U;
+            mismatches += decimals[i] == to_decimal(expected.c_str()) ? 0U : 1U;
+            mismatches += fixed_decimals[i] == to_decimal(expected_fixed.c_str()) ? 0U : 1U;
+        }
+        CHECK_EQ(mismatches, 0U);
+    }
+
+    auto bad = std::vector<const char *>(10000U, "+0-");
+    bad[7000] = "+0X";
+    auto out = std::vector<double>(bad.size());
+    CHECK_THROWS_AS(to_decimal_parallel(bad.data(), bad.size(), out.data(), 2U),
+                    std::invalid_argument);
+}
+
+TEST_CASE("test parallel conversions from several threads") {
+    // Calls sharing the pool at once, each several times over
+    auto values = std::vector<double>(50000U);
+    for (std::size_t i = 0U; i != values.size(); ++i) {
+        values[i] = double(i) * 0.37 - 9000.0;
+    }
+    auto const expected = to_csd_parallel(values.data(), values.size(), 4, 1U);
+
+    auto mismatches = std::vector<unsigned int>(4U, 0U);
+    std::vector<std::thread> callers;
+    for (std::size_t caller = 0U; caller != mismatches.size(); ++caller) {
+        callers.emplace_back([&, caller] {
+            for (auto round = 0U; round != 5U; ++round) {
+                auto const csd = to_csd_parallel(values.data(), values.size(), 4, 8U);
+                mismatches[caller] += csd.data() == expected.data() ? 0U : 1U;
+                mismatches[caller] += csd.offsets() == expected.offsets() ? 0U : 1U;
+            }
+        });
+    }
+    for (auto &caller : callers) {
+        caller.join();
+    }
+    for (auto count : mismatches) {
+        CHECK_EQ(count, 0U);
+    }
+}
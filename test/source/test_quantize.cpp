@@ -0,0 +1,122 @@
+#define DOCTEST_CONFIG_NO_EXCEPTIONS_BUT_WITH_ALL_ASSERTS
+
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <cmath>             // for fabs, ldexp
+#include <csd/csd.hpp>       // for to_csdfixed, to_decimal
+#include <csd/quantize.hpp>  // for quantize, to_csd_optimal
+#include <cstddef>           // for size_t
+#include <limits>            // for numeric_limits
+#include <string>            // for basic_string
+#include <vector>            // for vector
+
+using namespace csd;
+
+/**
+ * Number of non-zero digits of the NAF of an integer.
+ */
+static auto naf_weight(long long m) -> int {
+    auto weight = 0;
+    auto x = m < 0 ? -m : m;
+    for (; x != 0; x >>= 1) {
+        if ((x & 1) != 0) {
+            ++weight;
+            x += (x & 3) == 3 ? 1 : -1;
+        }
+    }
+    return weight;
+}
+
+TEST_CASE("test quantize") {
+    CHECK_EQ(quantize(28.5, 3U, 2U), 28.5);
+    CHECK_EQ(quantize(0.0, 3U, 8U), 0.0);
+    CHECK_EQ(quantize(0.3, 0U, 8U), 0.0);
+    CHECK_EQ(quantize(0.3, 1U, 8U), 0.25);
+    CHECK_EQ(quantize(-0.3, 1U, 8U), -0.25);
+    CHECK_EQ(quantize(0.7, 1U, 0U), 1.0);
+    CHECK_EQ(quantize(0.2, 1U, 0U), 0.0);
+    CHECK_EQ(quantize(23.0, 2U, 0U), 24.0);
+    CHECK_EQ(to_csd_optimal(23.0, 2U, 2U), "+0-000.00");
+    CHECK_EQ(to_csd_optimal(-23.0, 2U, 0U), "-0+000.");
+    CHECK_EQ(to_csd_optimal(0.0, 2U, 2U), "0.00");
+    CHECK_EQ(to_csd_optimal(0.3, 1U, 3U), "0.0+0");
+    CHECK_EQ(to_csd_optimal(1e30, 1U, 0U), "+" + std::string(100, '0') + ".");
+    // Greedy truncation keeps the first digits: 2.6875 = +0-.-0+ becomes +0- (= 3)
+    CHECK_EQ(to_csdfixed(2.6875, 2U), "+0-");
+    CHECK_EQ(quantize(2.6875, 2U, 4U), 2.5);
+    CHECK_EQ(to_csd_optimal(2.6875, 2U, 4U), "+0.+000");
+    // Greedy gives 0.875 no integral digit: 0.++ (= 0.75), where +.00- is exact
+    CHECK_EQ(to_csdfixed(0.875, 2U), "0.++");
+    CHECK_EQ(to_csd_optimal(0.875, 2U, 4U), "+.00-0");
+    CHECK_THROWS(quantize(std::numeric_limits<double>::infinity(), 3U, 2U));
+    CHECK_THROWS(quantize(1e300, 3U, 100U));
+}
+
+TEST_CASE("test quantize (exhaustive small cases)") {
+    // All the integers of up to 12 digits, by CSD weight
+    std::vector<std::vector<long long>> by_weight(7U);
+    for (auto m = -4096LL; m <= 4096LL; ++m) {
+        for (auto k = size_t(naf_weight(m)); k < by_weight.size(); ++k) {
+            by_weight[k].push_back(m);
+        }
+    }
+    for (auto i = 0; i != 400; ++i) {
+        auto const value = (i - 200) * 0.0731 + 0.0001 * (i % 7);
+        for (auto places : {0U, 3U, 6U}) {
+            for (auto nnz = 0U; nnz != by_weight.size(); ++nnz) {
+                auto const target = std::ldexp(value, int(places));
+                auto best = std::fabs(target);
+                for (auto m : by_weight[nnz]) {
+                    best = std::fmin(best, std::fabs(double(m) - target));
+                }
+                auto const res = std::ldexp(quantize(value, nnz, places), int(places));
+                CHECK_EQ(std::fabs(res - target), best);
+                CHECK(naf_weight((long long)res) <= int(nnz));
+                auto const csd = to_csd_optimal(value, nnz, places);
+                CHECK_EQ(to_decimal(csd.c_str()), quantize(value, nnz, places));
+            }
+        }
+    }
+}
+
+TEST_CASE("test quantize (never worse than to_csdfixed)") {
+    std::vector<double> values;
+    for (auto i = 0; i != 300; ++i) {
+        values.push_back(std::ldexp(double(i) - 150.5, -7) * 1.37);
+    }
+    std::vector<double> out(values.size());
+    quantize(values.data(), values.size(), 4U, 60U, out.data());
+    auto improved = 0;
+    for (size_t i = 0U; i != values.size(); ++i) {
+        auto const greedy = to_decimal(to_csdfixed(values[i], 4U).c_str());
+        CHECK(std::fabs(out[i] - values[i]) <= std::fabs(greedy - values[i]));
+        improved += std::fabs(out[i] - values[i]) < std::fabs(greedy - values[i]);
+        CHECK_EQ(out[i], quantize(values[i], 4U, 60U));
+    }
+    CHECK(improved > 0);
+}
+
+TEST_CASE("test csdfixed_sweep") {
+    std::vector<double> values{28.5, -0.3, 1.0 / 3.0, 0.0, 1e-5, -1234.5678, 0.125};
+    for (auto i = 0; i != 200; ++i) {
+        values.push_back(std::ldexp(double(i * 7919 % 1000) - 500.0, i % 30 - 20));
+    }
+    constexpr unsigned int max_nnz = 12U;
+    std::vector<double> quantized(values.size() * max_nnz);
+    std::vector<double> errors(values.size() * max_nnz);
+    csdfixed_sweep(values.data(), values.size(), max_nnz, quantized.data(), errors.data());
+    for (size_t i = 0U; i != values.size(); ++i) {
+        for (auto k = 1U; k <= max_nnz; ++k) {
+            auto const expected = to_decimal(to_csdfixed(values[i], k).c_str());
+            REQUIRE_EQ(quantized[i * max_nnz + k - 1U], expected);
+            CHECK_EQ(errors[i * max_nnz + k - 1U], expected - values[i]);
+        }
+    }
+
+    double single[4];
+    csdfixed_sweep(28.5, 4U, single);
+    CHECK_EQ(single[0], 32.0);
+    CHECK_EQ(single[1], 28.0);
+    CHECK_EQ(single[2], 28.5);
+    CHECK_EQ(single[3], 28.5);
+}
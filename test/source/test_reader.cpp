@@ -0,0 +1,108 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>     // for to_decimal, to_csd
+#include <csd/reader.hpp>  // for MappedFile, decode_csd_text, read_csd_file
+#include <cstddef>         // for size_t
+#include <cstdio>          // for fopen, fwrite, fclose, remove
+#include <stdexcept>       // for invalid_argument, runtime_error
+#include <string>          // for basic_string
+#include <utility>         // for move
+#include <vector>          // for vector
+
+using namespace csd;
+
+namespace {
+    auto write_file(const char *path, const std::string &contents) -> void {
+        auto *const file = std::fopen(path, "wb");
+        REQUIRE(file != nullptr);
+        std::fwrite(contents.data(), 1U, contents.size(), file);
+        std::fclose(file);
+    }
+}  // namespace
+
+TEST_CASE("test decode_csd_text") {
+    // Not null-terminated: the last field ends with the range
+    const char text[] = {'+', '0', '-', ',', ' ', '.', '+', '\r', '\n', '\n', ',', '-', ',',
+                         '\t', '+', '0', '0', '-', '0', '0', '.', '+'};
+    std::vector<double> values{7.0};
+    CHECK_EQ(decode_csd_text(text, text + sizeof text, ',', values), 4U);
+    auto const expected = std::vector<double>{7.0, 3.0, 0.5, -1.0, 28.5};
+    CHECK(values == expected);
+
+    values.clear();
+    CHECK_EQ(decode_csd_text(text, text, ',', values), 0U);
+    CHECK(values.empty());
+
+    // More fields than one batch, some longer than the vectorized path
+    std::string many;
+    std::vector<double> reference;
+    for (auto i = 0; i != 10000; ++i) {
+        auto const csd = to_csd(i * 0.37 - 1000.0, i % 3 == 0 ? 50 : 4);
+        many += csd + (i % 7 == 0 ? "\n" : ";");
+        reference.push_back(to_decimal(csd.c_str()));
+    }
+    values.clear();
+    CHECK_EQ(decode_csd_text(many.data(), many.data() + many.size(), ';', values), 10000U);
+    CHECK(values == reference);
+
+    std::string const bad = "+0-\n+0X\n";
+    CHECK_THROWS_AS(decode_csd_text(bad.data(), bad.data() + bad.size(), ',', values),
+                    std::invalid_argument);
+}
+
+TEST_CASE("test decode_csd_text errors") {
+    auto decode = [](const std::string &text, std::size_t first_line) {
+        std::vector<double> values{7.0};
+        decode_csd_text(text.data(), text.data() + text.size(), ',', values, first_line);
+    };
+    CHECK_THROWS_WITH_AS(decode("+0-\n+0X\n", 1U), "line 2: Work with 0, +, -, and . only",
+                         std::invalid_argument);
+    CHECK_THROWS_WITH_AS(decode("\n\r\n+, 0.+X\n", 10U),
+                         "line 12: Fractional part work with 0, +, and - only",
+                         std::invalid_argument);
+    CHECK_THROWS_WITH_AS(decode("+0-,+\n+0+.0.\n-X\n", 1U),
+                         "line 2: Fractional part work with 0, +, and - only",
+                         std::invalid_argument);
+
+    // A '\0' is not the end of a field
+    CHECK_THROWS_WITH_AS(decode(std::string("+0-\n+0\0+\n", 8U), 1U),
+                         "line 2: Work with 0, +, -, and . only", std::invalid_argument);
+    CHECK_THROWS_WITH_AS(decode(std::string("0.+\0", 4U), 1U),
+                         "line 1: Fractional part work with 0, +, and - only",
+                         std::invalid_argument);
+    // ... even after an invalid field on an earlier line
+    CHECK_THROWS_WITH_AS(decode(std::string("+\n-X\n\0", 6U), 1U),
+                         "line 2: Work with 0, +, -, and . only", std::invalid_argument);
+
+    // The values already decoded are taken back, from earlier batches too
+    std::string many;
+    for (auto i = 0; i != 10000; ++i) {
+        many += "+0-\n";
+    }
+    many += "+X\n";
+    std::vector<double> values{7.0};
+    CHECK_THROWS_WITH_AS(decode_csd_text(many.data(), many.data() + many.size(), ',', values),
+                         "line 10001: Work with 0, +, -, and . only", std::invalid_argument);
+    CHECK(values == std::vector<double>{7.0});
+}
+
+TEST_CASE("test read_csd_file") {
+    const char *const path = "test_reader.csd.tmp";
+    write_file(path, "+00-00.+,0.-\n-0+0-.0-\n\n+");
+    auto const values = read_csd_file(path);
+    auto const expected = std::vector<double>{28.5, -0.5, -13.25, 1.0};
+    CHECK(values == expected);
+
+    MappedFile file(path);
+    CHECK_EQ(file.size(), 24U);
+    CHECK_EQ(std::string(file.data(), 3U), "+00");
+    MappedFile moved(std::move(file));
+    CHECK_EQ(moved.size(), 24U);
+    CHECK_EQ(file.size(), 0U);
+
+    write_file(path, "");
+    CHECK(read_csd_file(path).empty());
+    std::remove(path);
+
+    CHECK_THROWS_AS(MappedFile("no/such/file.csd"), std::runtime_error);
+}
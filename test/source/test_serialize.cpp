@@ -0,0 +1,94 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/packed.hpp>     // for PackedCsd, to_packed, to_csd_packed
+#include <csd/serialize.hpp>  // for serialize, deserialize, CsdEncoding
+#include <cstddef>            // for size_t
+#include <cstdio>             // for remove
+#include <stdexcept>          // for runtime_error
+#include <string>             // for basic_string
+#include <vector>             // for vector
+
+using namespace csd;
+
+namespace {
+    auto sample_csds() -> std::vector<PackedCsd> {
+        std::vector<PackedCsd> csds;
+        for (auto const *str : {"+00-00.+0", "0.-0", "0.00", "0.", "+00-00", "0", ".+", ""}) {
+            csds.push_back(to_packed(str));
+        }
+        csds.push_back(to_packed(("+" + std::string(62, '0') + "-").c_str()));
+        csds.push_back(to_packed(("-0" + std::string(40, '0') + "." + std::string(21, '+')).c_str()));
+        for (auto i = 0; i != 1000; ++i) {
+            csds.push_back(to_csd_packed(i * 0.731 - 365.0, i % 40));
+        }
+        return csds;
+    }
+}  // namespace
+
+TEST_CASE("test serialize and deserialize") {
+    auto const csds = sample_csds();
+    for (auto encoding : {CsdEncoding::Dense, CsdEncoding::Sparse}) {
+        auto const table = serialize(csds.data(), csds.size(), encoding);
+        CHECK_EQ(table[0], 'C');
+        CHECK_EQ(table[4], csd_format_version);
+        CHECK(deserialize(table.data(), table.size()) == csds);
+    }
+
+    // 28.5 as "+00-00.+0": two header bytes and one byte per mask
+    auto const one = to_packed("+00-00.+0");
+    auto const dense = serialize(&one, 1U, CsdEncoding::Dense);
+    CHECK_EQ(dense.size(), 16U + 4U);
+    CHECK_EQ(dense[16], 8U);
+    CHECK_EQ(dense[17], 0x82U);
+    CHECK_EQ(dense[18], 0x82U);
+    CHECK_EQ(dense[19], 0x10U);
+    auto const sparse = serialize(&one, 1U, CsdEncoding::Sparse);
+    CHECK_EQ(sparse.size(), 16U + 6U);
+    CHECK_EQ(sparse[18], 3U);
+
+    // The sparse form wins for long numbers with few non-zero digits
+    auto const wide = to_csd_packed(1024.0 + 1.0 / 1024.0, 20);
+    CHECK_LT(serialize(&wide, 1U, CsdEncoding::Sparse).size(),
+             serialize(&wide, 1U, CsdEncoding::Dense).size());
+
+    auto const empty = serialize(nullptr, 0U);
+    CHECK_EQ(empty.size(), 16U);
+    CHECK(deserialize(empty.data(), empty.size()).empty());
+}
+
+TEST_CASE("test deserialize rejects invalid tables") {
+    auto const one = to_packed("+00-00.+0");
+    auto const good = serialize(&one, 1U, CsdEncoding::Sparse);
+
+    CHECK_THROWS_AS(deserialize(good.data(), 10U), std::runtime_error);
+    CHECK_THROWS_AS(deserialize(good.data(), good.size() - 1U), std::runtime_error);
+    auto bad = good;
+    bad[0] = 'X';
+    CHECK_THROWS_AS(deserialize(bad.data(), bad.size()), std::runtime_error);
+    bad = good;
+    bad[4] = csd_format_version + 1U;
+    CHECK_THROWS_AS(deserialize(bad.data(), bad.size()), std::runtime_error);
+    bad = good;
+    bad[16] = 65U;  // too many digits
+    CHECK_THROWS_AS(deserialize(bad.data(), bad.size()), std::runtime_error);
+    bad = good;
+    bad[19] = 9U;  // a digit beyond the length
+    CHECK_THROWS_AS(deserialize(bad.data(), bad.size()), std::runtime_error);
+    bad = good;
+    bad[20] = bad[19];  // the same digit twice
+    CHECK_THROWS_AS(deserialize(bad.data(), bad.size()), std::runtime_error);
+    bad = good;
+    bad.push_back(0U);  // trailing bytes
+    CHECK_THROWS_AS(deserialize(bad.data(), bad.size()), std::runtime_error);
+}
+
+TEST_CASE("test write_csd_table and read_csd_table") {
+    const char *const path = "test_serialize.csdt.tmp";
+    auto const csds = sample_csds();
+    write_csd_table(path, csds, CsdEncoding::Sparse);
+    CHECK(read_csd_table(path) == csds);
+    write_csd_table(path, csds);
+    CHECK(read_csd_table(path) == csds);
+    std::remove(path);
+    CHECK_THROWS_AS(read_csd_table(path), std::runtime_error);
+}
@@ -0,0 +1,102 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <chrono>           // for microseconds, seconds
+#include <csd/csd.hpp>      // for to_csd, to_csdfixed, to_decimal
+#include <csd/service.hpp>  // for ConversionService, ServiceOptions
+#include <cstddef>          // for size_t
+#include <exception>        // for exception_ptr
+#include <future>           // for future
+#include <stdexcept>        // for invalid_argument, runtime_error
+#include <string>           // for basic_string
+#include <thread>           // for thread
+#include <vector>           // for vector
+
+using namespace csd;
+
+TEST_CASE("test ConversionService") {
+    ServiceOptions options;
+    options.max_batch = 64U;
+    options.max_delay = std::chrono::seconds(10);
+    options.threads = 1U;
+    ConversionService service(options);
+
+    // A full batch is dispatched at once, long before its deadline
+    std::vector<std::future<std::string>> csds;
+    for (auto i = 0; i != 64; ++i) {
+        csds.push_back(service.to_csd(0.25 * i - 7.0, 4));
+    }
+    for (auto i = 0; i != 64; ++i) {
+        CHECK_EQ(csds[size_t(i)].get(), to_csd(0.25 * i - 7.0, 4));
+    }
+    CHECK_EQ(service.batches(), 1U);
+
+    // Requests with different parameters are never mixed
+    auto fixed2 = service.to_csdfixed(28.5, 2U);
+    auto fixed3 = service.to_csdfixed(28.5, 3U);
+    auto decimal = service.to_decimal("+00-00.+0");
+    auto invalid = service.to_decimal("+0x");
+    service.flush();
+    CHECK_EQ(fixed2.get(), to_csdfixed(28.5, 2U));
+    CHECK_EQ(fixed3.get(), to_csdfixed(28.5, 3U));
+    CHECK_EQ(decimal.get(), doctest::Approx(28.5));
+    CHECK_THROWS_AS(invalid.get(), std::invalid_argument);
+    CHECK_EQ(service.batches(), 4U);
+}
+
+TEST_CASE("test ConversionService deadline") {
+    ServiceOptions options;
+    options.max_delay = std::chrono::microseconds(100);
+    ConversionService service(options);
+
+    // A lone request completes once its deadline passes
+    CHECK_EQ(service.to_csd(0.5, 2).get(), "0.+0");
+
+    // Callbacks from several threads; the destructor drains the queue
+    std::vector<double> results(400U, 0.0);
+    {
+        ConversionService batched(options);
+        std::vector<std::thread> clients;
+        for (size_t t = 0U; t != 4U; ++t) {
+            clients.emplace_back([&batched, &results, t] {
+                for (size_t i = t; i < results.size(); i += 4U) {
+                    batched.to_decimal(to_csd(double(i), 0),
+                                       [&results, i](double value, std::exception_ptr error) {
+                                           results[i] = error ? -1.0 : value;
+                                       });
+                }
+            });
+        }
+        for (auto &client : clients) {
+            client.join();
+        }
+    }
+    for (size_t i = 0U; i != results.size(); ++i) {
+        CHECK_EQ(results[i], double(i));
+    }
+}
+
+TEST_CASE("test ConversionService throwing completion") {
+    ServiceOptions options;
+    options.max_batch = 2U;
+    options.threads = 1U;
+    std::vector<int> calls(4U, 0);
+    {
+        ConversionService service(options);
+        // The exception of the first completion neither repeats it nor skips the second
+        for (size_t i = 0U; i != 2U; ++i) {
+            service.to_decimal("+0-", [&calls, i](double, std::exception_ptr) {
+                ++calls[i];
+                throw std::runtime_error("completion failed");
+            });
+        }
+        for (size_t i = 2U; i != 4U; ++i) {
+            service.to_csd(1.5, 1, [&calls, i](std::string, std::exception_ptr) {
+                ++calls[i];
+                throw std::runtime_error("completion failed");
+            });
+        }
+        // The worker is still running
+        CHECK_EQ(service.to_csd(28.5, 2).get(), to_csd(28.5, 2));
+    }
+    CHECK_EQ(calls, std::vector<int>(4U, 1));
+}
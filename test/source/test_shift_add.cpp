@@ -0,0 +1,106 @@
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>        // for to_csd, to_csd_i
+#include <csd/packed.hpp>     // for to_packed, to_csd_i_packed
+#include <csd/shift_add.hpp>  // for to_shift_add, apply_shift_add, to_c_expression
+#include <cstdint>            // for int32_t, int64_t, uint32_t
+#include <stdexcept>          // for overflow_error
+#include <string>             // for basic_string
+#include <vector>             // for vector
+
+using namespace csd;
+
+TEST_CASE("test to_shift_add") {
+    auto const program = to_shift_add("+00-00.+0");
+    REQUIRE_EQ(program.terms.size(), 3U);
+    CHECK_EQ(program.terms[0].shift, 6U);
+    CHECK_EQ(program.terms[0].sign, 1);
+    CHECK_EQ(program.terms[1].shift, 3U);
+    CHECK_EQ(program.terms[1].sign, -1);
+    CHECK_EQ(program.terms[2].shift, 0U);
+    CHECK_EQ(program.frac, 1U);
+    CHECK_EQ(adder_count(program), 2U);
+
+    auto const integer = to_shift_add("+00-00");
+    REQUIRE_EQ(integer.terms.size(), 2U);
+    CHECK_EQ(integer.terms[0].shift, 5U);
+    CHECK_EQ(integer.terms[1].shift, 2U);
+    CHECK_EQ(integer.frac, 0U);
+    CHECK_EQ(adder_count(to_shift_add("0.00")), 0U);
+    CHECK_THROWS(to_shift_add("+00XX-00.+"));
+    CHECK_THROWS(to_shift_add("+00-00.+XXX"));
+
+    for (auto const *str : {"+00-00.+0", "0.-0", "0.00", "+00-00", "-0+0.0-0+", "0"}) {
+        auto const a = to_shift_add(str);
+        auto const b = to_shift_add(to_packed(str));
+        CHECK_EQ(a.frac, b.frac);
+        REQUIRE_EQ(a.terms.size(), b.terms.size());
+        for (auto i = 0U; i != a.terms.size(); ++i) {
+            CHECK_EQ(a.terms[i].shift, b.terms[i].shift);
+            CHECK_EQ(a.terms[i].sign, b.terms[i].sign);
+        }
+    }
+}
+
+TEST_CASE("test apply_shift_add") {
+    for (auto value : {0, 1, -1, 3, -5, 28, 1000, -12345}) {
+        auto const program = to_shift_add(to_csd_i_packed(value));
+        for (auto x : {0, 1, -1, 7, -100, 4096}) {
+            CHECK_EQ(apply_shift_add(program, std::int64_t{x}), std::int64_t{value} * x);
+        }
+    }
+
+    // 28.5 * x rounded down
+    auto const program = to_shift_add(to_csd(28.5, 2).c_str());
+    CHECK_EQ(apply_shift_add(program, std::int32_t{3}), 85);
+    CHECK_EQ(apply_shift_add(program, std::int32_t{-3}), -86);
+
+    std::vector<std::int32_t> in(1000);
+    for (auto i = 0U; i != in.size(); ++i) {
+        in[i] = static_cast<std::int32_t>(i * 37U % 2001U) - 1000;
+    }
+    std::vector<std::int32_t> out(in.size());
+    apply_shift_add(program, in.data(), out.data(), in.size());
+    for (auto i = 0U; i != in.size(); ++i) {
+        CHECK_EQ(out[i], apply_shift_add(program, in[i]));
+    }
+    apply_shift_add(program, in.data(), in.data(), in.size());
+    CHECK(in == out);
+}
+
+TEST_CASE("test apply_shift_add rejects shifts beyond the width") {
+    // 2^31 needs the sign bit of a 32-bit signed integer
+    auto const wide = to_shift_add(("+" + std::string(31, '0')).c_str());
+    CHECK_EQ(apply_shift_add(wide, std::int64_t{3}), std::int64_t{3} << 31);
+    CHECK_EQ(apply_shift_add(wide, std::uint32_t{1}), std::uint32_t{1} << 31);
+    CHECK_THROWS_AS(apply_shift_add(wide, std::int32_t{1}), std::overflow_error);
+    std::int32_t values[2] = {1, 2};
+    CHECK_THROWS_AS(apply_shift_add(wide, values, values, 2U), std::overflow_error);
+    CHECK_EQ(apply_shift_add(to_shift_add(("+" + std::string(30, '0')).c_str()),
+                             std::int32_t{1}),
+             std::int32_t{1} << 30);
+
+    // A right shift by 32 is undefined on 32 bits
+    auto const tiny = to_shift_add(("0." + std::string(31, '0') + "+").c_str());
+    CHECK_EQ(tiny.frac, 32U);
+    CHECK_EQ(apply_shift_add(tiny, std::int64_t{1} << 33), std::int64_t{2});
+    CHECK_THROWS_AS(apply_shift_add(tiny, std::uint32_t{1}), std::overflow_error);
+}
+
+TEST_CASE("test shift-add code generation") {
+    CHECK_EQ(to_c_expression(to_shift_add("+00-00.+0")), "(((x << 6) - (x << 3) + x) >> 1)");
+    CHECK_EQ(to_c_expression(to_shift_add("-00+"), "in"), "(-(in << 3) + in)");
+    CHECK_EQ(to_c_expression(to_shift_add("+0")), "(x << 1)");
+    CHECK_EQ(to_c_expression(to_shift_add("0")), "0");
+
+    auto const verilog = to_verilog(to_shift_add("+00-00.+0"), "mul_28_5", 12U);
+    CHECK_EQ(verilog,
+             "module mul_28_5 #(\n"
+             "    parameter WIDTH = 12\n"
+             ") (\n"
+             "    input  wire signed [WIDTH-1:0] x,\n"
+             "    output wire signed [WIDTH+7-1:0] y\n"
+             ");\n"
+             "    assign y = ((x <<< 6) - (x <<< 3) + x) >>> 1;\n"
+             "endmodule\n");
+}
@@ -0,0 +1,77 @@
+#define DOCTEST_CONFIG_NO_EXCEPTIONS_BUT_WITH_ALL_ASSERTS
+
+#include <doctest/doctest.h>  // for ResultBuilder, CHECK_EQ, TEST_CASE
+
+#include <csd/csd.hpp>   // for to_csd_i, to_decimal_i
+#include <csd/wide.hpp>  // for BigInt, to_csd_wide, to_decimal_wide, int128_t, uint128_t
+#include <cstdint>       // for int64_t, uint64_t, INT64_MAX, INT64_MIN
+#include <string>        // for basic_string
+#include <vector>        // for vector
+
+using namespace csd;
+
+TEST_CASE("test to_csd_wide (32-bit and 64-bit)") {
+    for (auto i = -1000; i <= 1000; ++i) {
+        CHECK_EQ(to_csd_wide(std::int32_t{i}), to_csd_i(i));
+        CHECK_EQ(to_csd_wide(std::int64_t{i}), to_csd_i(i));
+        CHECK_EQ(to_decimal_wide<std::int64_t>(to_csd_i(i).c_str()), i);
+    }
+    CHECK_EQ(to_csd_wide(std::int64_t{1} << 40), "+" + std::string(40, '0'));
+    CHECK_EQ(to_csd_wide(INT64_MAX), "+" + std::string(62, '0') + "-");
+    CHECK_EQ(to_csd_wide(INT64_MIN), "-" + std::string(63, '0'));
+    CHECK_EQ(to_decimal_wide<std::int64_t>(to_csd_wide(INT64_MAX).c_str()), INT64_MAX);
+    CHECK_EQ(to_decimal_wide<std::int64_t>(to_csd_wide(INT64_MIN).c_str()), INT64_MIN);
+}
+
+TEST_CASE("test to_decimal_wide (64-bit)") {
+    CHECK_EQ(to_decimal_wide<std::int64_t>("+00-00.+"), 28);
+    CHECK_EQ(to_decimal_wide<std::int64_t>("000-0+"), -3);
+    CHECK_EQ(to_decimal_wide<std::int64_t>(""), 0);
+    // 48-bit accumulator constant
+    CHECK_EQ(to_decimal_wide<std::int64_t>(to_csd_wide(std::int64_t{0x7FFF12345678}).c_str()),
+             std::int64_t{0x7FFF12345678});
+    CHECK_THROWS_AS(to_decimal_wide<std::int64_t>("+0X"), std::invalid_argument);
+    CHECK_THROWS_AS(to_decimal_wide<std::int64_t>(("+" + std::string(63, '0')).c_str()),
+                    std::overflow_error);
+    CHECK_THROWS_AS(to_decimal_wide<std::int64_t>(("+" + std::string(64, '0') + "-").c_str()),
+                    std::overflow_error);
+}
+
+#if defined(__SIZEOF_INT128__)
+TEST_CASE("test to_csd_wide (128-bit)") {
+    auto const big = (int128_t{0x0123456789ABCDEF} << 32) | 0x9A;  // a 96-bit constant
+    CHECK_EQ(to_decimal_wide<int128_t>(to_csd_wide(big).c_str()), big);
+    CHECK_EQ(to_decimal_wide<int128_t>(to_csd_wide(-big).c_str()), -big);
+    auto const max = int128_t(~uint128_t{0} >> 1);
+    CHECK_EQ(to_decimal_wide<int128_t>(to_csd_wide(max).c_str()), max);
+    CHECK_EQ(to_decimal_wide<int128_t>(to_csd_wide(-max - 1).c_str()), -max - 1);
+    CHECK_EQ(to_csd_wide(int128_t{1} << 100), "+" + std::string(100, '0'));
+    for (auto i = -1000; i <= 1000; ++i) {
+        CHECK_EQ(to_csd_wide(int128_t{i}), to_csd_i(i));
+    }
+}
+#endif
+
+TEST_CASE("test BigInt") {
+    CHECK_EQ(to_string(BigInt{}), "0");
+    CHECK_EQ(to_string(BigInt{-42}), "-42");
+    auto const two_100 = BigInt(false, {0U, std::uint64_t{1} << 36});
+    CHECK_EQ(to_string(two_100), "1267650600228229401496703205376");
+    CHECK_EQ(to_csd_wide(two_100), "+" + std::string(100, '0'));
+    CHECK_EQ(to_decimal_wide<BigInt>(("+" + std::string(100, '0')).c_str()), two_100);
+    CHECK_EQ(to_decimal_wide<BigInt>(".+"), BigInt{});
+    CHECK_EQ(BigInt(true, {0U, 0U}), BigInt{});
+    CHECK_THROWS_AS(to_decimal_wide<BigInt>("+0X"), std::invalid_argument);
+
+    for (auto i = -1000; i <= 1000; ++i) {
+        CHECK_EQ(to_csd_wide(BigInt{i}), to_csd_i(i));
+        CHECK_EQ(to_decimal_wide<BigInt>(to_csd_i(i).c_str()), BigInt{i});
+    }
+    // Limbs of all ones carry through every limb and need an extra digit
+    auto const ones = BigInt(true, std::vector<std::uint64_t>(5U, ~std::uint64_t{0}));
+    auto const csd = to_csd_wide(ones);
+    CHECK_EQ(csd, "-" + std::string(319, '0') + "+");
+    CHECK_EQ(to_decimal_wide<BigInt>(csd.c_str()), ones);
+    auto const mixed = BigInt(false, {0x5555555555555555U, 0xAAAAAAAAAAAAAAAAU, 0x123U});
+    CHECK_EQ(to_decimal_wide<BigInt>(to_csd_wide(mixed).c_str()), mixed);
+}
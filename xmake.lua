@@ -4,6 +4,13 @@ add_requires("fmt", {alias = "fmt"})
 add_requires("benchmark", {alias = "benchmark"})
 add_requires("cxxopts", {alias = "cxxopts"})
 
+option("metrics")
+    set_default(false)
+    set_showmenu(true)
+    set_description("Count calls and time spent in the conversion functions")
+    add_defines("CSD_ENABLE_METRICS=1")
+option_end()
+
 if is_mode("coverage") then
     add_cxflags("-ftest-coverage", "-fprofile-arcs", {force = true})
 end
@@ -21,6 +28,10 @@ target("Csd")
     add_includedirs("include", {public = true})
     add_files("source/*.cpp")
     add_packages("fmt")
+    add_options("metrics")
+    if is_plat("linux") then
+        add_syslinks("pthread", {public = true})
+    end
 
 target("test_csd")
     set_languages("c++14")
@@ -29,6 +40,14 @@ target("test_csd")
     add_files("test/source/*.cpp")
     add_packages("doctest", "fmt")
 
+target("test_header_only")
+    set_languages("c++20")
+    set_kind("binary")
+    add_includedirs("include")
+    add_defines("CSD_HEADER_ONLY")
+    add_files("test/header_only/*.cpp")
+    add_packages("doctest")
+
 target("test_switch")
     set_languages("c++14")
     set_kind("binary")